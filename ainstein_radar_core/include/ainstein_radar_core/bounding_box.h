@@ -3,7 +3,7 @@
 
 #include <Eigen/Eigen>
 
-namespace ainstein_radar_drivers
+namespace ainstein_radar_core
 {
   // Simple ROS-independent bounding box class
   class BoundingBox
@@ -30,6 +30,6 @@ namespace ainstein_radar_drivers
     Eigen::Vector3d dimensions;
   };
 
-} // namespace ainstein_radar_drivers
+} // namespace ainstein_radar_core
 
 #endif // BOUNDING_BOX_H_
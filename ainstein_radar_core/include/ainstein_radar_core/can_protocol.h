@@ -0,0 +1,191 @@
+#ifndef CAN_PROTOCOL_H_
+#define CAN_PROTOCOL_H_
+
+#include <cstdint>
+
+#include "radar_target_gate.h"
+
+namespace ainstein_radar_core
+{
+  // Compile-time description of the radars' CAN protocols: where each value sits in
+  // the 8-byte payload, and which message type each CAN ID carries. Decoding functions
+  // and ID dispatch tables are generated from the descriptions, so supporting a new
+  // firmware variant only takes a new description.
+  namespace can_protocol
+  {
+    // Marks a message a radar type does not send:
+    constexpr uint32_t no_id = 0xDEAD;
+
+    // Big-endian integer field of num_bytes bytes (none for a field the radar does not
+    // send, which decodes as zero), converted to physical units by scale:
+    struct Field
+    {
+      uint8_t first_byte;
+      uint8_t num_bytes;
+      bool is_signed;
+      double scale;
+    };
+
+    constexpr int64_t rawField( const uint8_t* data, Field field )
+    {
+      if( field.num_bytes == 0 )
+	{
+	  return 0;
+	}
+
+      uint32_t raw = 0;
+      for( int i = 0; i < field.num_bytes; ++i )
+	{
+	  raw = ( raw << 8 ) | data[field.first_byte + i];
+	}
+
+      // Sign extend by moving the field's top bit up to bit 31 and back:
+      int shift = 32 - 8 * field.num_bytes;
+      return field.is_signed ? static_cast<int64_t>( static_cast<int32_t>( raw << shift ) >> shift ) : raw;
+    }
+
+    constexpr double decodeField( const uint8_t* data, Field field )
+    {
+      return static_cast<double>( rawField( data, field ) ) * field.scale;
+    }
+
+    // Decode one target from a CAN payload. Layout provides a constexpr Field function
+    // per target value, so each instantiation compiles to fixed loads and multiplies:
+    template <typename Layout, typename target_type>
+    inline void decodeTarget( const uint8_t* data, target_type& target )
+    {
+      target.target_id = decodeField( data, Layout::target_id() );
+      target.snr = decodeField( data, Layout::snr() );
+      target.range = decodeField( data, Layout::range() );
+      target.speed = decodeField( data, Layout::speed() );
+      target.azimuth = decodeField( data, Layout::azimuth() );
+      target.elevation = decodeField( data, Layout::elevation() );
+    }
+
+    // Gate checked on the raw fields of a CAN payload, so rejected targets are never decoded:
+    template <typename Layout>
+    class TargetGate
+    {
+    public:
+      explicit TargetGate( const RadarTargetGate& gate = RadarTargetGate() ) :
+	is_open_( gate.isOpen() ),
+	snr_( RadarTargetGate::toRaw( gate.snr, Layout::snr().scale, 0.0 ) ),
+	range_( RadarTargetGate::toRaw( gate.range, Layout::range().scale, 0.0 ) ),
+	speed_( RadarTargetGate::toRaw( gate.speed, Layout::speed().scale, 0.0 ) ),
+	azimuth_( RadarTargetGate::toRaw( gate.azimuth, Layout::azimuth().scale, 0.0 ) ),
+	elevation_( RadarTargetGate::toRaw( gate.elevation, Layout::elevation().scale, 0.0 ) )
+      {
+      }
+
+      bool accepts( const uint8_t* data ) const
+      {
+	return ( is_open_ ||
+		 ( snr_.contains( rawField( data, Layout::snr() ) ) &&
+		   range_.contains( rawField( data, Layout::range() ) ) &&
+		   speed_.contains( rawField( data, Layout::speed() ) ) &&
+		   azimuth_.contains( rawField( data, Layout::azimuth() ) ) &&
+		   elevation_.contains( rawField( data, Layout::elevation() ) ) ) );
+      }
+
+    private:
+      bool is_open_;
+      RadarTargetGate::RawWindow snr_;
+      RadarTargetGate::RawWindow range_;
+      RadarTargetGate::RawWindow speed_;
+      RadarTargetGate::RawWindow azimuth_;
+      RadarTargetGate::RawWindow elevation_;
+    };
+
+    // Perfect hash from the CAN IDs of one radar to their message types. Message type i
+    // has ID ids[i], type 0 meaning unknown. The multiplier is searched for at compile
+    // time so that no two IDs share a slot, making a lookup one multiply and one compare.
+    struct IdDispatch
+    {
+      static constexpr int bits = 4;
+      static constexpr int num_slots = 1 << bits;
+
+      uint32_t multiplier;
+      uint32_t ids[num_slots];
+      uint8_t types[num_slots];
+
+      constexpr int slot( uint32_t id ) const
+      {
+	return static_cast<uint32_t>( id * multiplier ) >> ( 32 - bits );
+      }
+
+      constexpr int lookup( uint32_t id ) const
+      {
+	return ( ids[slot( id )] == id ) ? types[slot( id )] : 0;
+      }
+    };
+
+    template <int num_types>
+    constexpr IdDispatch makeIdDispatch( const uint32_t ( &ids )[num_types] )
+    {
+      static_assert( num_types <= IdDispatch::num_slots, "too many message types for the dispatch table" );
+
+      // Try odd multiples of the golden ratio, leaving the multiplier zero if none works:
+      for( uint32_t k = 1; k < 20000; k += 2 )
+	{
+	  IdDispatch dispatch{};
+	  dispatch.multiplier = static_cast<uint32_t>( k * 0x9E3779B1u );
+	  for( auto& id : dispatch.ids )
+	    {
+	      id = no_id;
+	    }
+
+	  bool collision = false;
+	  for( int type = 1; type < num_types && !collision; ++type )
+	    {
+	      if( ids[type] == no_id )
+		{
+		  continue;
+		}
+
+	      int slot = dispatch.slot( ids[type] );
+	      collision = ( dispatch.ids[slot] != no_id );
+	      dispatch.ids[slot] = ids[type];
+	      dispatch.types[slot] = type;
+	    }
+
+	  if( !collision )
+	    {
+	      return dispatch;
+	    }
+	}
+
+      return IdDispatch{};
+    }
+
+    // Target layout of the T79, in both its standard and BSD firmware:
+    struct T79TargetLayout
+    {
+      static constexpr Field target_id( void ) { return { 0, 1, false, 1.0 }; }
+      static constexpr Field snr( void ) { return { 1, 1, false, 1.0 }; }
+      static constexpr Field range( void ) { return { 2, 2, true, 0.01 }; } // m
+      static constexpr Field speed( void ) { return { 4, 2, true, 0.01 }; } // m/s, +ve away from the radar
+      static constexpr Field azimuth( void ) { return { 6, 2, true, -0.01 }; }
+      static constexpr Field elevation( void ) { return { 0, 0, false, 0.0 }; } // not measured
+    };
+
+    // Target layouts of the O79 CAN, whose raw target range is unsigned:
+    struct O79RawTargetLayout
+    {
+      static constexpr Field target_id( void ) { return { 0, 1, false, 1.0 }; }
+      static constexpr Field snr( void ) { return { 1, 1, false, 1.0 }; }
+      static constexpr Field range( void ) { return { 2, 2, false, 0.1 }; } // m
+      static constexpr Field speed( void ) { return { 4, 2, true, 0.045 }; } // m/s, +ve away from the radar
+      static constexpr Field azimuth( void ) { return { 6, 1, true, 1.0 }; } // deg
+      static constexpr Field elevation( void ) { return { 7, 1, true, 1.0 }; } // deg
+    };
+
+    struct O79TrackedTargetLayout : public O79RawTargetLayout
+    {
+      static constexpr Field range( void ) { return { 2, 2, true, 0.1 }; } // m
+    };
+
+  } // namespace can_protocol
+
+} // namespace ainstein_radar_core
+
+#endif // CAN_PROTOCOL_H_
@@ -0,0 +1,45 @@
+#ifndef RADAR_CONVERSIONS_H_
+#define RADAR_CONVERSIONS_H_
+
+#include <cmath>
+
+#include <Eigen/Eigen>
+
+#include "radar_target.h"
+
+namespace ainstein_radar_core
+{
+  inline void sphericalToCartesian( double range, double azimuth, double elevation,
+				    Eigen::Vector3d& p )
+  {
+    // Convert spherical coordinates to Cartesian coordinates. Range and point xyz are in
+    // meters, angles are in radians.
+    p.x() = range * std::cos( azimuth ) * std::cos( elevation );
+    p.y() = range * std::sin( azimuth ) * std::cos( elevation );
+    p.z() = range * std::sin( elevation );
+  }
+
+  inline void cartesianToSpherical( const Eigen::Vector3d& p,
+				    double& range, double& azimuth, double& elevation )
+  {
+    // Convert Cartesian coordinates to spherical coordinates. Range and point xyz are in
+    // meters, angles are in radians.
+    range = p.norm();
+    azimuth = std::atan2( p.y(), p.x() );
+    elevation = std::asin( p.z() / range );
+  }
+
+  // Position of a target, whose angles are in degrees as reported by the radars:
+  inline Eigen::Vector3d radarTargetToPoint( const RadarTarget& target )
+  {
+    Eigen::Vector3d p;
+    sphericalToCartesian( target.range,
+			  ( M_PI / 180.0 ) * target.azimuth,
+			  ( M_PI / 180.0 ) * target.elevation,
+			  p );
+    return p;
+  }
+
+} // namespace ainstein_radar_core
+
+#endif // RADAR_CONVERSIONS_H_
@@ -0,0 +1,160 @@
+#ifndef DETECTION_GRID_H_
+#define DETECTION_GRID_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Eigen>
+
+namespace ainstein_radar_core
+{
+  // Spatial hash of a frame's detections over a grid of cells, so the detections near a
+  // track are found without checking all of them. Cells are hashed into a table sized
+  // for the number of detections, so the grid covers any extent in fixed memory. Cells
+  // sharing a bucket only add candidates, which the caller's exact gate rejects anyway.
+  template <int Dim>
+  class DetectionGrid
+  {
+  public:
+    typedef Eigen::Matrix<double, Dim, 1> Point;
+
+    explicit DetectionGrid( const Point& cell_size ) :
+      cell_size_( cell_size ),
+      mask_( 0 )
+    {
+    }
+
+    // Index the detections, one point per column. Points with a coordinate that is not
+    // finite, or too far out for an integer cell index, go in no cell and are never found:
+    template <typename Derived>
+    void build( const Eigen::MatrixBase<Derived>& points )
+    {
+      const int num_points = points.cols();
+      std::size_t num_buckets = 1;
+      while( num_buckets < 2 * static_cast<std::size_t>( num_points ) )
+	{
+	  num_buckets <<= 1;
+	}
+      mask_ = num_buckets - 1;
+
+      // Counting sort of the detections by bucket, skipped points marked with num_buckets:
+      bucket_start_.assign( num_buckets + 1, 0 );
+      point_bucket_.resize( num_points );
+      int num_indexed = 0;
+      Eigen::Matrix<int64_t, Dim, 1> cell;
+      for( int j = 0; j < num_points; ++j )
+	{
+	  if( !cellOf( points.col( j ), cell ) )
+	    {
+	      point_bucket_[j] = num_buckets;
+	      continue;
+	    }
+	  point_bucket_[j] = bucket( cell );
+	  ++bucket_start_[point_bucket_[j] + 1];
+	  ++num_indexed;
+	}
+      for( std::size_t b = 0; b < num_buckets; ++b )
+	{
+	  bucket_start_[b + 1] += bucket_start_[b];
+	}
+      sorted_.resize( num_indexed );
+      fill_.assign( bucket_start_.begin(), bucket_start_.end() - 1 );
+      for( int j = 0; j < num_points; ++j )
+	{
+	  if( point_bucket_[j] != num_buckets )
+	    {
+	      sorted_[fill_[point_bucket_[j]]++] = j;
+	    }
+	}
+    }
+
+    // Set indices to the detections, in increasing order, in the cells overlapping the box
+    // [min, max]. Returns false instead if the box is not finite or spans more cells than
+    // there are detections, in which case checking every detection is cheaper:
+    bool query( const Point& min, const Point& max, std::vector<int>& indices ) const
+    {
+      indices.clear();
+
+      // Count the cells before converting to integers, the box may be unbounded:
+      Point lo_cell = ( min.array() / cell_size_.array() ).floor().matrix();
+      Point hi_cell = ( max.array() / cell_size_.array() ).floor().matrix();
+      double num_cells = ( ( hi_cell - lo_cell ).array() + 1.0 ).prod();
+      if( !( inRange( lo_cell ) && inRange( hi_cell ) && ( hi_cell.array() >= lo_cell.array() ).all() &&
+	     num_cells <= static_cast<double>( sorted_.size() ) ) )
+	{
+	  return false;
+	}
+      const Eigen::Matrix<int64_t, Dim, 1> lo = lo_cell.template cast<int64_t>();
+      const Eigen::Matrix<int64_t, Dim, 1> hi = hi_cell.template cast<int64_t>();
+
+      // Visit every cell in the box, odometer style:
+      Eigen::Matrix<int64_t, Dim, 1> cell = lo;
+      while( true )
+	{
+	  std::size_t b = bucket( cell );
+	  indices.insert( indices.end(), sorted_.begin() + bucket_start_[b], sorted_.begin() + bucket_start_[b + 1] );
+
+	  int d = 0;
+	  while( d < Dim && cell( d ) == hi( d ) )
+	    {
+	      cell( d ) = lo( d );
+	      ++d;
+	    }
+	  if( d == Dim )
+	    {
+	      break;
+	    }
+	  ++cell( d );
+	}
+
+      // Cells sharing a bucket list the same detections more than once:
+      std::sort( indices.begin(), indices.end() );
+      indices.erase( std::unique( indices.begin(), indices.end() ), indices.end() );
+      return true;
+    }
+
+  private:
+    // Cell indices are kept within +-2^62, so every cell and its neighbour fit in int64_t:
+    static bool inRange( const Point& cell )
+    {
+      return ( cell.array().abs() < 4611686018427387904.0 ).all();
+    }
+
+    template <typename Derived>
+    bool cellOf( const Eigen::MatrixBase<Derived>& p, Eigen::Matrix<int64_t, Dim, 1>& cell ) const
+    {
+      const Point c = ( p.array() / cell_size_.array() ).floor().matrix();
+      if( !inRange( c ) )
+	{
+	  return false;
+	}
+      cell = c.template cast<int64_t>();
+      return true;
+    }
+
+    std::size_t bucket( const Eigen::Matrix<int64_t, Dim, 1>& cell ) const
+    {
+      static const uint64_t primes[3] = { 73856093u, 19349663u, 83492791u };
+      uint64_t h = 0;
+      for( int d = 0; d < Dim; ++d )
+	{
+	  h ^= static_cast<uint64_t>( cell( d ) ) * primes[d % 3];
+	}
+      return static_cast<std::size_t>( h & mask_ );
+    }
+
+    Point cell_size_;
+    uint64_t mask_;
+
+    // Detections sorted by bucket, bucket b holding sorted_[bucket_start_[b]..bucket_start_[b + 1]):
+    std::vector<int> bucket_start_;
+    std::vector<int> sorted_;
+    std::vector<std::size_t> point_bucket_;
+    std::vector<int> fill_;
+  };
+
+} // namespace ainstein_radar_core
+
+#endif // DETECTION_GRID_H_
@@ -0,0 +1,84 @@
+#ifndef KALMAN_FILTER_H_
+#define KALMAN_FILTER_H_
+
+#include <Eigen/Eigen>
+
+namespace ainstein_radar_core
+{
+// Kalman Filter (extended, for nonlinear measurement models) over a motion model and a
+// measurement model, whose dimensions fix the sizes of every matrix at compile time.
+//
+// A motion model provides state_dim, the transition matrix transition(dt) and the
+// process noise processNoise(dt). A measurement model provides state_dim, meas_dim,
+// the predicted measurement predict(x), its Jacobian jacobian(x) and the measurement
+// noise noise(). Models hold only their parameters, so one model serves all filters.
+template <typename MotionModel, typename MeasurementModel>
+class KalmanFilter
+{
+public:
+  static constexpr int state_dim = MotionModel::state_dim;
+  static constexpr int meas_dim = MeasurementModel::meas_dim;
+  static_assert(MeasurementModel::state_dim == state_dim,
+		"The measurement model must measure the motion model's state");
+
+  typedef Eigen::Matrix<double, state_dim, 1> StateVector;
+  typedef Eigen::Matrix<double, state_dim, state_dim> StateMatrix;
+  typedef Eigen::Matrix<double, meas_dim, 1> MeasVector;
+  typedef Eigen::Matrix<double, meas_dim, meas_dim> MeasMatrix;
+  typedef Eigen::Matrix<double, meas_dim, state_dim> MeasJacobian;
+
+  KalmanFilter(const StateVector& state, const StateMatrix& cov)
+  : state_(state)
+  , cov_(cov)
+  {
+  }
+
+  const StateVector& getState(void) const
+  {
+    return state_;
+  }
+  const StateMatrix& getCovariance(void) const
+  {
+    return cov_;
+  }
+
+  void process(const MotionModel& motion_model, double dt)
+  {
+    const StateMatrix F = motion_model.transition(dt);
+    state_ = F * state_;
+    cov_ = F * cov_ * F.transpose() + motion_model.processNoise(dt);
+  }
+
+  MeasVector computePredMeas(const MeasurementModel& meas_model) const
+  {
+    return meas_model.predict(state_);
+  }
+  MeasMatrix computeMeasCov(const MeasurementModel& meas_model) const
+  {
+    const MeasJacobian H = meas_model.jacobian(state_);
+    return H * cov_ * H.transpose() + meas_model.noise();
+  }
+
+  void update(const MeasurementModel& meas_model, const MeasVector& meas)
+  {
+    const MeasJacobian H = meas_model.jacobian(state_);
+    const MeasJacobian HP = H * cov_;
+
+    // With S = H * P * H^T + R symmetric, K = P * H^T * S^-1 means K^T = S^-1 * H * P,
+    // which takes one Cholesky solve instead of an inverse:
+    const Eigen::LLT<MeasMatrix> meas_cov_llt(HP * H.transpose() + meas_model.noise());
+    const MeasJacobian K_t = meas_cov_llt.solve(HP);
+
+    // P = (I - K * H) * P:
+    state_ += K_t.transpose() * (meas - meas_model.predict(state_));
+    cov_ -= K_t.transpose() * HP;
+  }
+
+private:
+  StateVector state_;
+  StateMatrix cov_;
+};
+
+} // namespace ainstein_radar_core
+
+#endif // KALMAN_FILTER_H_
@@ -0,0 +1,203 @@
+#ifndef KALMAN_FILTER_MODELS_H_
+#define KALMAN_FILTER_MODELS_H_
+
+#include <cmath>
+
+#include <Eigen/Eigen>
+
+namespace ainstein_radar_core
+{
+// Motion and measurement models for KalmanFilter. Process noise is white noise on the
+// highest derivative in the state, discretized as dt * L * Q * L^T.
+
+// Range at constant radial speed, with the speed, azimuth and elevation driven by noise.
+// The state is (range, speed, azimuth, elevation):
+class RangeRateMotionModel
+{
+public:
+  static constexpr int state_dim = 4;
+  typedef Eigen::Matrix<double, state_dim, state_dim> StateMatrix;
+
+  // Noise variances on the speed, azimuth and elevation:
+  explicit RangeRateMotionModel(const Eigen::Vector3d& noise_var)
+  : noise_var_(noise_var)
+  {
+  }
+
+  StateMatrix transition(double dt) const
+  {
+    StateMatrix F = StateMatrix::Identity();
+    F(0, 1) = dt;
+    return F;
+  }
+
+  StateMatrix processNoise(double dt) const
+  {
+    StateMatrix Q = StateMatrix::Zero();
+    Q.diagonal().tail<3>() = dt * noise_var_;
+    return Q;
+  }
+
+private:
+  Eigen::Vector3d noise_var_;
+};
+
+// Constant velocity in Dim dimensions (e.g. 2 for objects on the ground plane), with
+// the same noise variance on each axis. The state is (position, velocity):
+template <int Dim>
+class ConstantVelocityMotionModel
+{
+public:
+  static constexpr int state_dim = 2 * Dim;
+  typedef Eigen::Matrix<double, state_dim, state_dim> StateMatrix;
+
+  explicit ConstantVelocityMotionModel(double noise_var)
+  : noise_var_(noise_var)
+  {
+  }
+
+  StateMatrix transition(double dt) const
+  {
+    StateMatrix F = StateMatrix::Identity();
+    F.template block<Dim, Dim>(0, Dim).diagonal().setConstant(dt);
+    return F;
+  }
+
+  StateMatrix processNoise(double dt) const
+  {
+    StateMatrix Q = StateMatrix::Zero();
+    Q.diagonal().template tail<Dim>().setConstant(dt * noise_var_);
+    return Q;
+  }
+
+private:
+  double noise_var_;
+};
+
+// Constant acceleration in Dim dimensions. The state is (position, velocity, acceleration),
+// so it starts like the constant velocity state and takes the same measurement models:
+template <int Dim>
+class ConstantAccelerationMotionModel
+{
+public:
+  static constexpr int state_dim = 3 * Dim;
+  typedef Eigen::Matrix<double, state_dim, state_dim> StateMatrix;
+
+  explicit ConstantAccelerationMotionModel(double noise_var)
+  : noise_var_(noise_var)
+  {
+  }
+
+  StateMatrix transition(double dt) const
+  {
+    StateMatrix F = StateMatrix::Identity();
+    F.template block<Dim, Dim>(0, Dim).diagonal().setConstant(dt);
+    F.template block<Dim, Dim>(0, 2 * Dim).diagonal().setConstant(0.5 * dt * dt);
+    F.template block<Dim, Dim>(Dim, 2 * Dim).diagonal().setConstant(dt);
+    return F;
+  }
+
+  StateMatrix processNoise(double dt) const
+  {
+    StateMatrix Q = StateMatrix::Zero();
+    Q.diagonal().template tail<Dim>().setConstant(dt * noise_var_);
+    return Q;
+  }
+
+private:
+  double noise_var_;
+};
+
+// Measures the state itself, with independent noise on each element:
+template <int Dim>
+class DirectMeasurementModel
+{
+public:
+  static constexpr int state_dim = Dim;
+  static constexpr int meas_dim = Dim;
+  typedef Eigen::Matrix<double, state_dim, 1> StateVector;
+  typedef Eigen::Matrix<double, meas_dim, 1> MeasVector;
+  typedef Eigen::Matrix<double, meas_dim, meas_dim> MeasMatrix;
+  typedef Eigen::Matrix<double, meas_dim, state_dim> MeasJacobian;
+
+  explicit DirectMeasurementModel(const MeasVector& noise_var)
+  : noise_var_(noise_var)
+  {
+  }
+
+  MeasVector predict(const StateVector& state) const
+  {
+    return state;
+  }
+
+  MeasJacobian jacobian(const StateVector&) const
+  {
+    return MeasJacobian::Identity();
+  }
+
+  MeasMatrix noise(void) const
+  {
+    return noise_var_.asDiagonal();
+  }
+
+private:
+  MeasVector noise_var_;
+};
+
+// Measures the speed along the line of sight, then the position, of a state starting
+// with Dim position and Dim velocity elements. The speed makes the model nonlinear:
+template <int Dim, int StateDim = 2 * Dim>
+class RadialSpeedPositionMeasurementModel
+{
+public:
+  static constexpr int state_dim = StateDim;
+  static constexpr int meas_dim = Dim + 1;
+  typedef Eigen::Matrix<double, state_dim, 1> StateVector;
+  typedef Eigen::Matrix<double, meas_dim, 1> MeasVector;
+  typedef Eigen::Matrix<double, meas_dim, meas_dim> MeasMatrix;
+  typedef Eigen::Matrix<double, meas_dim, state_dim> MeasJacobian;
+
+  RadialSpeedPositionMeasurementModel(double speed_noise_var, double pos_noise_var)
+  {
+    noise_var_(0) = speed_noise_var;
+    noise_var_.template tail<Dim>().setConstant(pos_noise_var);
+  }
+
+  MeasVector predict(const StateVector& state) const
+  {
+    const auto pos = state.template head<Dim>();
+    const auto vel = state.template segment<Dim>(Dim);
+
+    MeasVector meas;
+    meas(0) = pos.dot(vel) / pos.norm();
+    meas.template tail<Dim>() = pos;
+    return meas;
+  }
+
+  MeasJacobian jacobian(const StateVector& state) const
+  {
+    typedef Eigen::Matrix<double, Dim, Dim> Matrix;
+    const Eigen::Matrix<double, Dim, 1> pos = state.template head<Dim>();
+    const Eigen::Matrix<double, Dim, 1> vel = state.template segment<Dim>(Dim);
+    const double p_norm = pos.norm();
+
+    MeasJacobian H = MeasJacobian::Zero();
+    H.template block<1, Dim>(0, 0) =
+      (((Matrix::Identity() / p_norm) - ((pos * pos.transpose()) / std::pow(p_norm, 3.0))) * vel).transpose();
+    H.template block<1, Dim>(0, Dim) = pos.transpose() / p_norm;
+    H.template block<Dim, Dim>(1, 0).setIdentity();
+    return H;
+  }
+
+  MeasMatrix noise(void) const
+  {
+    return noise_var_.asDiagonal();
+  }
+
+private:
+  MeasVector noise_var_;
+};
+
+} // namespace ainstein_radar_core
+
+#endif // KALMAN_FILTER_MODELS_H_
@@ -0,0 +1,48 @@
+#ifndef MEASUREMENT_GATE_H_
+#define MEASUREMENT_GATE_H_
+
+#include <Eigen/Eigen>
+
+namespace ainstein_radar_core
+{
+  // Validation gate around a filter's predicted measurement. The innovation covariance is
+  // factored once (Cholesky), after which the squared Mahalanobis distances of a whole
+  // block of measurements take one triangular solve, instead of an inverse per target.
+  class MeasurementGate
+  {
+  public:
+    typedef Eigen::Matrix<double, 4, Eigen::Dynamic> MeasurementBlock;
+
+    void set( const Eigen::Vector4d& pred_meas, const Eigen::Matrix4d& meas_cov )
+    {
+      pred_meas_ = pred_meas;
+      meas_cov_llt_.compute( meas_cov );
+    }
+
+    // Squared Mahalanobis distance of each measurement column from the prediction:
+    template <typename MeasDerived, typename DistDerived>
+    void computeDistances( const Eigen::MatrixBase<MeasDerived>& meas,
+			   const Eigen::MatrixBase<DistDerived>& dist ) const
+    {
+      // With S = L * L^T, (y - z)^T * S^-1 * (y - z) is the squared norm of L^-1 * (y - z):
+      if( innov_.cols() < meas.cols() )
+	{
+	  innov_.resize( Eigen::NoChange, meas.cols() );
+	}
+      auto innov = innov_.leftCols( meas.cols() );
+      innov = meas.colwise() - pred_meas_;
+      meas_cov_llt_.matrixL().solveInPlace( innov );
+      const_cast<Eigen::MatrixBase<DistDerived>&>( dist ) = innov.colwise().squaredNorm();
+    }
+
+  private:
+    Eigen::Vector4d pred_meas_;
+    Eigen::LLT<Eigen::Matrix4d> meas_cov_llt_;
+
+    // Whitened innovations, grown to the largest block seen and reused:
+    mutable MeasurementBlock innov_;
+  };
+
+} // namespace ainstein_radar_core
+
+#endif // MEASUREMENT_GATE_H_
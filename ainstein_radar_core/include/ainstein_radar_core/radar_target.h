@@ -1,7 +1,7 @@
 #ifndef RADAR_TARGET_H_
 #define RADAR_TARGET_H_
 
-namespace ainstein_radar_drivers
+namespace ainstein_radar_core
 {
   // Simple ROS-independent radar target class
   class RadarTarget
@@ -43,6 +43,6 @@ namespace ainstein_radar_drivers
     double snr;
   };
 
-} // namespace ainstein_radar_drivers
+} // namespace ainstein_radar_core
 
 #endif // RADAR_TARGET_H_
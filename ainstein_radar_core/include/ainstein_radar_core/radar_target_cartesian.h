@@ -3,7 +3,7 @@
 
 #include <Eigen/Eigen>
 
-namespace ainstein_radar_drivers
+namespace ainstein_radar_core
 {
   // Simple ROS-independent Cartesian radar target class
   class RadarTargetCartesian
@@ -29,6 +29,6 @@ namespace ainstein_radar_drivers
     Eigen::Vector3d vel;
   };
 
-} // namespace ainstein_radar_drivers
+} // namespace ainstein_radar_core
 
 #endif // RADAR_TARGET_CARTESIAN_H_
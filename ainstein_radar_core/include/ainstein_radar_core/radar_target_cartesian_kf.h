@@ -0,0 +1,213 @@
+#ifndef RADAR_TARGET_CART_KF_H_
+#define RADAR_TARGET_CART_KF_H_
+
+#include <iostream>
+
+#include <Eigen/Eigen>
+
+#include <ainstein_radar_core/conversions.h>
+#include <ainstein_radar_core/kalman_filter.h>
+#include <ainstein_radar_core/kalman_filter_models.h>
+#include <ainstein_radar_core/radar_target.h>
+
+#define Q_VEL_STDEV 5.0
+
+#define R_SPEED_STDEV 1.0
+#define R_POS_STDEV 0.1
+
+#define INIT_POS_STDEV 1.0
+#define INIT_VEL_STDEV 2.0
+
+namespace ainstein_radar_core
+{
+  // Kalman Filter tracking one target's Cartesian position and velocity from its range,
+  // speed and angles. Times are in seconds on whatever clock the caller uses (e.g. ROS
+  // time, so that simulated time and log playback work).
+  class RadarTargetCartesianKF
+  {
+
+    class FilterState
+    {
+    public:
+      FilterState( const RadarTarget& target,
+		   const Eigen::Matrix<double, 6, 6>& initial_covariance )
+      {
+	sphericalToCartesian( target.range,
+			      ( M_PI / 180.0 ) * target.azimuth,
+			      ( M_PI / 180.0 ) * target.elevation,
+			      pos );
+
+	sphericalToCartesian( target.speed,
+			      ( M_PI / 180.0 ) * target.azimuth,
+			      ( M_PI / 180.0 ) * target.elevation,
+			      vel );
+		    
+	cov = initial_covariance;
+      }
+      FilterState( const Eigen::Matrix<double, 6, 1>& state_vec,
+		   const Eigen::Matrix<double, 6, 6>& covariance )
+      {
+	fromVec( state_vec );
+	cov = covariance;
+      }
+      FilterState( const FilterState& state )
+      {
+	pos = state.pos;
+	vel = state.vel;
+
+	cov = state.cov;
+      }
+      ~FilterState() {}
+
+      friend std::ostream& operator<< ( std::ostream& out, const FilterState& state )
+      {
+	out << "Position: " << state.pos.transpose() << std::endl
+	    << "Velocity: " << state.vel.transpose() << std::endl
+	    << "Covariance: " << std::endl << state.cov << std::endl;
+	return out;
+      }
+
+      Eigen::Vector3d pos;
+      Eigen::Vector3d vel;
+	
+      Eigen::Matrix<double, 6, 6> cov;
+
+      Eigen::Matrix<double, 6, 1> asVec( void ) const
+      {
+	Eigen::Matrix<double, 6, 1> state_vec;
+	state_vec.segment( 0, 3 ) = this->pos;
+	state_vec.segment( 3, 3 ) = this->vel;
+	    
+	return state_vec;
+      }
+      void fromVec( const Eigen::Matrix<double, 6, 1>& state_vec )
+      {
+	this->pos = state_vec.segment( 0, 3 );
+	this->vel = state_vec.segment( 3, 3 );
+      }
+
+      RadarTarget asTarget( void ) const
+      {
+	RadarTarget t;
+	double range, azimuth, elevation;
+	cartesianToSpherical( pos, range, azimuth, elevation );
+
+	t.range = range;
+	t.speed = ( pos / pos.norm() ).transpose() * vel;
+	t.azimuth = ( 180.0 / M_PI ) * azimuth;
+	t.elevation = ( 180.0 / M_PI ) * elevation;
+
+	return t;
+      }
+
+      Eigen::Affine3d asPose( void ) const
+      {
+	Eigen::Affine3d pose_eigen;
+	pose_eigen.translation() = pos;
+
+	// Compute the pose assuming the +x direction is the current
+	// estimated Cartesian velocity direction
+	Eigen::Matrix3d rot_mat;
+	rot_mat.col( 0 ) = vel / vel.norm();
+	rot_mat.col( 1 ) = Eigen::Vector3d::UnitZ().cross( rot_mat.col( 0 ) );
+	rot_mat.col( 2 ) = rot_mat.col( 0 ).cross( rot_mat.col( 1 ) );
+	pose_eigen.linear() = rot_mat;
+	
+	return pose_eigen;
+      }
+    };
+
+  public:
+    typedef KalmanFilter<ConstantVelocityMotionModel<3>, RadialSpeedPositionMeasurementModel<3>> Filter;
+
+    class FilterParameters
+    {
+    public:
+      FilterParameters( void ) :
+	init_pos_stdev( INIT_POS_STDEV ),
+	init_vel_stdev( INIT_VEL_STDEV ),
+	q_vel_stdev( Q_VEL_STDEV ),
+	r_speed_stdev( R_SPEED_STDEV ),
+	r_pos_stdev( R_POS_STDEV )
+      {
+      }
+      ~FilterParameters( void )	{}
+      
+      double init_pos_stdev;
+      double init_vel_stdev;
+
+      double q_vel_stdev;
+
+      double r_speed_stdev;
+      double r_pos_stdev;
+    };
+
+    // Models and initial covariance made from one set of parameters, owned by the tracker
+    // and passed to each of its filters:
+    class Models
+    {
+    public:
+      explicit Models( const FilterParameters& params = FilterParameters() );
+
+      ConstantVelocityMotionModel<3> motion_model;
+      RadialSpeedPositionMeasurementModel<3> meas_model;
+      Eigen::Matrix<double, 6, 6> P_init;
+    };
+
+    RadarTargetCartesianKF( const RadarTarget& target, double time, const Models& models );
+    ~RadarTargetCartesianKF() {}
+
+    friend std::ostream& operator<< ( std::ostream& out, const RadarTargetCartesianKF& kf )
+    {
+      out << "State: " << kf.getState();
+      out << "First Update: " << kf.time_first_update_ << std::endl
+	  << "Last Update: " << kf.time_last_update_ << std::endl;
+      return out;
+    }
+	
+    void process( const Models& models, double dt );
+    void update( const Models& models, const RadarTarget& target, double time );
+
+    FilterState getState( void ) const
+    {
+      return FilterState( kf_.getState(), kf_.getCovariance() );
+    }
+    Eigen::Vector4d computePredMeas( const Models& models ) const
+    {
+      return kf_.computePredMeas( models.meas_model );
+    }
+    static Eigen::Vector4d computeMeas( const RadarTarget& target )
+    {
+      Eigen::Vector3d pos = radarTargetToPoint( target );
+
+      return Eigen::Vector4d( target.speed,
+			      pos.x(),
+			      pos.y(),
+			      pos.z() );
+    }
+    // The measurement Jacobian is taken at the filter's current state:
+    Eigen::Matrix4d computeMeasCov( const Models& models ) const
+    {
+      return kf_.computeMeasCov( models.meas_model );
+    }
+
+    double getTimeSinceStart( double time ) const
+    {
+      return time - time_first_update_;
+    }
+
+    double getTimeSinceUpdate( double time ) const 
+    {
+      return time - time_last_update_;
+    }
+
+  private:
+    Filter kf_;
+
+    double time_first_update_;
+    double time_last_update_;
+  };
+
+} // namespace ainstein_radar_core
+
+#endif // RADAR_TARGET_CART_KF_H_
@@ -0,0 +1,165 @@
+#ifndef RADAR_TARGET_DECODER_H_
+#define RADAR_TARGET_DECODER_H_
+
+#include "radar_target_frame.h"
+#include "radar_target_gate.h"
+
+namespace ainstein_radar_core
+{
+  // Decodes the 8-byte target records shared by the K79, K79-3D and O79 UDP
+  // protocols into a struct-of-arrays frame. Each record is laid out as:
+  //   bytes 0-1: azimuth (little endian, signed or unsigned per sensor)
+  //   byte  2  : range
+  //   byte  3  : speed (0-64 moving away, 65-127 moving towards)
+  //   bytes 4-5: elevation (little endian, signed or unsigned per sensor)
+  //   bytes 6-7: SNR (little endian, unsigned)
+  class RadarTargetDecoder
+  {
+  public:
+
+    // Per-sensor field scalings, value = raw * scale + offset:
+    struct Format
+    {
+      double range_res;
+      double speed_res;
+      bool azimuth_signed;
+      double azimuth_scale;
+      double azimuth_offset;
+      bool elevation_signed;
+      double elevation_scale;
+      double elevation_offset;
+    };
+
+    explicit RadarTargetDecoder( const Format& format );
+    ~RadarTargetDecoder( void )
+    {
+    }
+
+    // Only decode targets within the gate, checked on the raw record fields:
+    void setGate( const RadarTargetGate& gate );
+
+    // Decode num_records consecutive records, appending the targets within the gate
+    // to the frame. IDs are the record indices counting up from first_id:
+    void decode( const char* data, int num_records, int first_id,
+		 RadarTargetFrame& frame ) const;
+
+    // Decode num_records consecutive records one target at a time, calling
+    // sink.set( k, id, range, speed, azimuth, elevation, snr ) for k = 0, 1, ... for
+    // each target within the gate. Returns the number of targets passed to the sink:
+    template <typename RowSink>
+    int decodeRows( const char* data, int num_records, int first_id,
+		    RowSink& sink ) const
+    {
+      float range, speed, azimuth, elevation, snr;
+      int num_targets = 0;
+      for( int k = 0; k < num_records; ++k )
+	{
+	  const char* record = data + k * RadarTargetDecoder::record_len;
+	  if( is_gated_ && !isInGate( record ) )
+	    {
+	      continue;
+	    }
+	  decodeRecord( record, range, speed, azimuth, elevation, snr );
+	  sink.set( num_targets++, static_cast<uint16_t>( first_id + k ), range, speed, azimuth, elevation, snr );
+	}
+      return num_targets;
+    }
+
+    static const unsigned int record_len;
+
+    static const Format format_o79;
+    static const Format format_k79;
+    static const Format format_k79_3d;
+
+  private:
+    int32_t rawAzimuth( const uint8_t* r ) const
+    {
+      uint16_t az = static_cast<uint16_t>( r[0] | ( r[1] << 8 ) );
+      return format_.azimuth_signed ? static_cast<int16_t>( az ) : az;
+    }
+
+    int32_t rawElevation( const uint8_t* r ) const
+    {
+      uint16_t el = static_cast<uint16_t>( r[4] | ( r[5] << 8 ) );
+      return format_.elevation_signed ? static_cast<int16_t>( el ) : el;
+    }
+
+    bool isInGate( const char* record ) const
+    {
+      const uint8_t* r = reinterpret_cast<const uint8_t*>( record );
+      return ( range_in_gate_[r[2]] && speed_in_gate_[r[3]] &&
+	       azimuth_gate_.contains( rawAzimuth( r ) ) &&
+	       elevation_gate_.contains( rawElevation( r ) ) &&
+	       snr_gate_.contains( static_cast<uint16_t>( r[6] | ( r[7] << 8 ) ) ) );
+    }
+
+    void decodeRecord( const char* record, float& range, float& speed,
+		       float& azimuth, float& elevation, float& snr ) const
+    {
+      const uint8_t* r = reinterpret_cast<const uint8_t*>( record );
+
+      range = range_lut_[r[2]];
+      speed = speed_lut_[r[3]];
+      azimuth = static_cast<float>( rawAzimuth( r ) ) *
+	static_cast<float>( format_.azimuth_scale ) + static_cast<float>( format_.azimuth_offset );
+      elevation = static_cast<float>( rawElevation( r ) ) *
+	static_cast<float>( format_.elevation_scale ) + static_cast<float>( format_.elevation_offset );
+      snr = static_cast<float>( static_cast<uint16_t>( r[6] | ( r[7] << 8 ) ) );
+    }
+
+    Format format_;
+
+    // Range and speed are single bytes, so they are looked up rather than computed:
+    float range_lut_[256];
+    float speed_lut_[256];
+
+    // Gate on the raw fields, range and speed bytes being looked up as well:
+    bool is_gated_;
+    bool range_in_gate_[256];
+    bool speed_in_gate_[256];
+    RadarTargetGate::RawWindow azimuth_gate_;
+    RadarTargetGate::RawWindow elevation_gate_;
+    RadarTargetGate::RawWindow snr_gate_;
+  };
+
+  // Destination for decoded targets, so drivers can decode straight into whatever
+  // the caller publishes without an intermediate copy:
+  class RadarTargetSink
+  {
+  public:
+    virtual ~RadarTargetSink( void )
+    {
+    }
+
+    virtual void clear( void ) = 0;
+    virtual void append( const RadarTargetDecoder& decoder, const char* data,
+			 int num_records, int first_id ) = 0;
+  };
+
+  // Sink appending to a struct-of-arrays frame:
+  class RadarTargetFrameSink : public RadarTargetSink
+  {
+  public:
+    explicit RadarTargetFrameSink( RadarTargetFrame& frame ) :
+      frame_( frame )
+    {
+    }
+
+    void clear( void ) override
+    {
+      frame_.clear();
+    }
+
+    void append( const RadarTargetDecoder& decoder, const char* data,
+		 int num_records, int first_id ) override
+    {
+      decoder.decode( data, num_records, first_id, frame_ );
+    }
+
+  private:
+    RadarTargetFrame& frame_;
+  };
+
+} // namespace ainstein_radar_core
+
+#endif // RADAR_TARGET_DECODER_H_
@@ -0,0 +1,76 @@
+#ifndef RADAR_TARGET_FRAME_H_
+#define RADAR_TARGET_FRAME_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "radar_target.h"
+
+namespace ainstein_radar_core
+{
+  // Struct-of-arrays frame of radar targets, one column per target field
+  class RadarTargetFrame
+  {
+  public:
+
+    RadarTargetFrame( void )
+    {
+    }
+    ~RadarTargetFrame( void )
+    {
+    }
+
+    std::size_t size( void ) const
+    {
+      return id.size();
+    }
+
+    bool empty( void ) const
+    {
+      return id.empty();
+    }
+
+    // Clearing keeps the column capacity so a reused frame does not reallocate:
+    void clear( void )
+    {
+      resize( 0 );
+    }
+
+    void reserve( std::size_t n )
+    {
+      id.reserve( n );
+      range.reserve( n );
+      speed.reserve( n );
+      azimuth.reserve( n );
+      elevation.reserve( n );
+      snr.reserve( n );
+    }
+
+    void resize( std::size_t n )
+    {
+      id.resize( n );
+      range.resize( n );
+      speed.resize( n );
+      azimuth.resize( n );
+      elevation.resize( n );
+      snr.resize( n );
+    }
+
+    // Gather the i-th target back into a RadarTarget:
+    RadarTarget at( std::size_t i ) const
+    {
+      return RadarTarget( id[i], range[i], speed[i], azimuth[i], elevation[i], snr[i] );
+    }
+
+    std::vector<uint16_t> id;
+    std::vector<float> range;
+    std::vector<float> speed;
+    std::vector<float> azimuth;
+    std::vector<float> elevation;
+    std::vector<float> snr;
+  };
+
+} // namespace ainstein_radar_core
+
+#endif // RADAR_TARGET_FRAME_H_
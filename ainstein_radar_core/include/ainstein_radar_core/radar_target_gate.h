@@ -0,0 +1,99 @@
+#ifndef RADAR_TARGET_GATE_H_
+#define RADAR_TARGET_GATE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace ainstein_radar_core
+{
+  // Windows on the target values, in the units the radars report (m, m/s, deg and raw SNR).
+  // Every window is unbounded by default, so a default gate accepts all targets. Decoders
+  // turn the windows into limits on the raw fields, so rejected targets are never decoded.
+  class RadarTargetGate
+  {
+  public:
+    struct Window
+    {
+      double min;
+      double max;
+
+      bool contains( double value ) const
+      {
+	return ( value >= min && value <= max );
+      }
+
+      bool isOpen( void ) const
+      {
+	return ( min == -std::numeric_limits<double>::infinity() &&
+		 max == std::numeric_limits<double>::infinity() );
+      }
+    };
+
+    // Window on the raw integer a value is decoded from:
+    struct RawWindow
+    {
+      int64_t min;
+      int64_t max;
+
+      bool contains( int64_t raw ) const
+      {
+	return ( raw >= min && raw <= max );
+      }
+    };
+
+    RadarTargetGate( void )
+    {
+      const Window open = { -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() };
+      range = open;
+      speed = open;
+      azimuth = open;
+      elevation = open;
+      snr = open;
+    }
+
+    bool isOpen( void ) const
+    {
+      return ( range.isOpen() && speed.isOpen() && azimuth.isOpen() &&
+	       elevation.isOpen() && snr.isOpen() );
+    }
+
+    bool accepts( double range_value, double speed_value, double azimuth_value,
+		  double elevation_value, double snr_value ) const
+    {
+      return ( range.contains( range_value ) && speed.contains( speed_value ) &&
+	       azimuth.contains( azimuth_value ) && elevation.contains( elevation_value ) &&
+	       snr.contains( snr_value ) );
+    }
+
+    // Raw values whose decoded value = raw * scale + offset falls in the window:
+    static RawWindow toRaw( const Window& window, double scale, double offset )
+    {
+      // A field the radar does not send always decodes to the offset:
+      if( scale == 0.0 )
+	{
+	  return window.contains( offset ) ? RawWindow{ -raw_limit, raw_limit } : RawWindow{ 1, 0 };
+	}
+
+      double lo = ( ( scale > 0.0 ? window.min : window.max ) - offset ) / scale;
+      double hi = ( ( scale > 0.0 ? window.max : window.min ) - offset ) / scale;
+      lo = std::max<double>( std::ceil( lo ), static_cast<double>( -raw_limit ) );
+      hi = std::min<double>( std::floor( hi ), static_cast<double>( raw_limit ) );
+      return RawWindow{ static_cast<int64_t>( lo ), static_cast<int64_t>( hi ) };
+    }
+
+    Window range;
+    Window speed;
+    Window azimuth;
+    Window elevation;
+    Window snr;
+
+  private:
+    // Beyond any field the radars send, and exactly representable as a double:
+    static constexpr int64_t raw_limit = int64_t( 1 ) << 40;
+  };
+
+} // namespace ainstein_radar_core
+
+#endif // RADAR_TARGET_GATE_H_
@@ -4,6 +4,9 @@
 #include <Eigen/Eigen>
 #include <chrono>
 
+#include <ainstein_radar_core/kalman_filter.h>
+#include <ainstein_radar_core/kalman_filter_models.h>
+
 #define Q_SPEED_STDEV 5.0
 #define Q_AZIM_STDEV 10.0
 #define Q_ELEV_STDEV 10.0
@@ -18,15 +21,12 @@
 #define INIT_AZIM_STDEV 10.0
 #define INIT_ELEV_STDEV 10.0
 
-namespace ainstein_radar_filters
+namespace ainstein_radar_core
 {
 class RadarTargetKF
 {
 public:
-  RadarTargetKF(double target_range, double target_speed, double target_azimuth, double target_elevation);
-  ~RadarTargetKF()
-  {
-  }
+  typedef KalmanFilter<RangeRateMotionModel, DirectMeasurementModel<4>> Filter;
 
   class FilterState
   {
@@ -41,6 +41,11 @@ public:
 
 	  cov = initial_covariance;
 	}
+	FilterState(const Eigen::Vector4d& state_vec, const Eigen::Matrix4d& covariance)
+	{
+	  fromVec(state_vec);
+	  cov = covariance;
+	}
 	FilterState(const FilterState& state)
 	{
 	  range = state.range;
@@ -62,6 +67,7 @@ public:
 		  << "Elevation: " << state.elevation << std::endl
 		  << "Covariance: " << std::endl
 		  << state.cov << std::endl;
+	  return out;
 	}
 
 	double range;
@@ -88,6 +94,17 @@ public:
   {
   public:
 	FilterParameters(void)
+	  : init_range_stdev(INIT_RANGE_STDEV)
+	  , init_speed_stdev(INIT_SPEED_STDEV)
+	  , init_azim_stdev(INIT_AZIM_STDEV)
+	  , init_elev_stdev(INIT_ELEV_STDEV)
+	  , q_speed_stdev(Q_SPEED_STDEV)
+	  , q_azim_stdev(Q_AZIM_STDEV)
+	  , q_elev_stdev(Q_ELEV_STDEV)
+	  , r_range_stdev(R_RANGE_STDEV)
+	  , r_speed_stdev(R_SPEED_STDEV)
+	  , r_azim_stdev(R_AZIM_STDEV)
+	  , r_elev_stdev(R_ELEV_STDEV)
 	{
 	}
 	~FilterParameters(void)
@@ -109,27 +126,47 @@ public:
 	double r_elev_stdev;
   };
 
+  // Models and initial covariance made from one set of parameters. Whoever owns the filters
+  // (e.g. a tracker) owns these too and passes them to each filter:
+  class Models
+  {
+  public:
+	explicit Models(const FilterParameters& params = FilterParameters());
+
+	RangeRateMotionModel motion_model;
+	DirectMeasurementModel<4> meas_model;
+	Eigen::Matrix4d P_init;
+  };
+
+  RadarTargetKF(double target_range, double target_speed, double target_azimuth, double target_elevation,
+				const Models& models);
+  ~RadarTargetKF()
+  {
+  }
+
   friend std::ostream& operator<<(std::ostream& out, const RadarTargetKF& kf)
   {
-	out << "State: " << kf.state_post_;
+	out << "State: " << kf.getState();
 	out << "Time Since Start: " << kf.getTimeSinceStart() << std::endl
 		<< "Time Since Update: " << kf.getTimeSinceUpdate() << std::endl;
+	return out;
   }
 
-  void process(double dt);
-  void update(double target_range, double target_speed, double target_azimuth, double target_elevation);
+  void process(const Models& models, double dt);
+  void update(const Models& models, double target_range, double target_speed, double target_azimuth,
+			  double target_elevation);
 
   FilterState getState(void) const
   {
-	return state_post_;
+	return FilterState(kf_.getState(), kf_.getCovariance());
   }
-  Eigen::Vector4d computePredMeas(const FilterState& state)
+  Eigen::Vector4d computePredMeas(const Models& models) const
   {
-	return H_ * state.asVec();
+	return kf_.computePredMeas(models.meas_model);
   }
-  Eigen::Matrix4d computeMeasCov(const FilterState& state)
+  Eigen::Matrix4d computeMeasCov(const Models& models) const
   {
-	return H_ * state.cov * H_.transpose() + R_;
+	return kf_.computeMeasCov(models.meas_model);
   }
 
   double getTimeSinceStart(void) const
@@ -146,28 +183,13 @@ public:
 			   .count();
   }
 
-  static void setFilterParameters(const FilterParameters& params);
-
 private:
-  FilterState state_pre_;
-  FilterState state_post_;
+  Filter kf_;
 
   std::chrono::system_clock::time_point time_first_update_;
   std::chrono::system_clock::time_point time_last_update_;
-
-  Eigen::Matrix4d K_;
-
-  // Shared among all filters:
-  static Eigen::Matrix4d F_;
-  static Eigen::Matrix<double, 4, 3> L_;
-  static Eigen::Matrix4d H_;
-
-  static Eigen::Matrix3d Q_;
-  static Eigen::Matrix4d R_;
-
-  static Eigen::Matrix4d P_init_;
 };
 
-}  // namespace ainstein_radar_filters
+}  // namespace ainstein_radar_core
 
 #endif  // RADAR_TARGET_KF_H_
@@ -0,0 +1,131 @@
+#ifndef RADAR_TARGET_KF_BANK_H_
+#define RADAR_TARGET_KF_BANK_H_
+
+#include <Eigen/Eigen>
+#include <vector>
+
+#include <ainstein_radar_core/radar_target_kf.h>
+
+namespace ainstein_radar_core
+{
+// Every tracked target's RadarTargetKF, stored as one row per state or covariance element
+// with one column per filter. The process model then runs over all filters at once as
+// contiguous (vectorized) array operations, skipping the zeros of the motion model's F.
+// Updates go through RadarTargetKF::Filter one filter at a time. Only the upper triangle
+// of each covariance is stored. Times are in seconds on the caller's clock.
+class RadarTargetKFBank
+{
+public:
+  RadarTargetKFBank(void);
+  ~RadarTargetKFBank()
+  {
+  }
+
+  void setFilterParameters(const RadarTargetKF::FilterParameters& params);
+
+  void reserve(int capacity);
+
+  int size(void) const
+  {
+	return size_;
+  }
+
+  // Start a new filter at a target:
+  void add(double target_range, double target_speed, double target_azimuth, double target_elevation, double time);
+
+  // Run the process model over dt for every filter:
+  void process(double dt);
+
+  void update(int i, double target_range, double target_speed, double target_azimuth, double target_elevation,
+	      double time);
+
+  // Drop the filters for which remove(i) is true, keeping the others in order:
+  template <typename Predicate>
+  void removeIf(Predicate remove)
+  {
+	int kept = 0;
+	for (int i = 0; i < size_; ++i)
+	{
+	  if (!remove(i))
+	  {
+		if (kept != i)
+		{
+		  data_.col(kept) = data_.col(i);
+		  time_first_update_[kept] = time_first_update_[i];
+		  time_last_update_[kept] = time_last_update_[i];
+		}
+		++kept;
+	  }
+	}
+	size_ = kept;
+	time_first_update_.resize(size_);
+	time_last_update_.resize(size_);
+  }
+
+  Eigen::Vector4d getState(int i) const
+  {
+	return data_.col(i).head<4>();
+  }
+  Eigen::Matrix4d getCovariance(int i) const;
+
+  Eigen::Vector4d computePredMeas(int i) const
+  {
+	return models_.meas_model.predict(getState(i));
+  }
+  Eigen::Matrix4d computeMeasCov(int i) const
+  {
+	return RadarTargetKF::Filter(getState(i), getCovariance(i)).computeMeasCov(models_.meas_model);
+  }
+
+  double getTimeSinceStart(int i, double time) const
+  {
+	return time - time_first_update_[i];
+  }
+
+  double getTimeSinceUpdate(int i, double time) const
+  {
+	return time - time_last_update_[i];
+  }
+
+  void print(std::ostream& out, int i) const;
+
+private:
+  enum Row
+  {
+	RANGE,
+	SPEED,
+	AZIMUTH,
+	ELEVATION,
+	P00,
+	P01,
+	P02,
+	P03,
+	P11,
+	P12,
+	P13,
+	P22,
+	P23,
+	P33,
+	NUM_ROWS
+  };
+
+  // Row of element (r, c) of the covariance, from its upper triangle:
+  static int covRow(int r, int c);
+
+  void setFilter(int i, const Eigen::Vector4d& state, const Eigen::Matrix4d& cov);
+
+  Eigen::Array<double, NUM_ROWS, Eigen::Dynamic, Eigen::RowMajor> data_;
+  int size_;
+
+  std::vector<double> time_first_update_;
+  std::vector<double> time_last_update_;
+
+  // F * P while processing, all 16 elements a row each:
+  Eigen::Array<double, 16, Eigen::Dynamic, Eigen::RowMajor> fp_;
+
+  RadarTargetKF::Models models_;
+};
+
+}  // namespace ainstein_radar_core
+
+#endif  // RADAR_TARGET_KF_BANK_H_
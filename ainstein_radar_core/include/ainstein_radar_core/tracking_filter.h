@@ -0,0 +1,130 @@
+#ifndef TRACKING_FILTER_H_
+#define TRACKING_FILTER_H_
+
+#include <Eigen/Eigen>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <iostream>
+
+#include <ainstein_radar_core/detection_grid.h>
+#include <ainstein_radar_core/measurement_gate.h>
+#include <ainstein_radar_core/radar_target.h>
+#include <ainstein_radar_core/radar_target_kf_bank.h>
+
+namespace ainstein_radar_core
+{
+class TrackingFilter
+{
+public:
+  TrackingFilter(void)
+	: grid_(Eigen::Vector2d(TrackingFilter::grid_range_cell_size, TrackingFilter::grid_azimuth_cell_size))
+  {
+    print_debug_ = false;
+    is_running_ = true;
+    has_time_ = false;
+  }
+  ~TrackingFilter()
+  {
+  }
+
+  class FilterParameters
+  {
+  public:
+    FilterParameters(void)
+    {
+    }
+    ~FilterParameters(void)
+    {
+    }
+
+    double filter_process_rate;
+    double filter_min_time;
+    double filter_timeout;
+    double filter_val_gate_thresh;
+
+    // Underlying Kalman Filter parameters (shared among this tracker's KFs):
+    RadarTargetKF::FilterParameters kf_params;
+  };
+
+  // Safe to call while the filters run, e.g. from a reconfigure callback:
+  void setFilterParameters(const FilterParameters& params)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    filter_process_rate_ = params.filter_process_rate;
+    filter_min_time_ = params.filter_min_time;
+    filter_timeout_ = params.filter_timeout;
+    filter_val_gate_thresh_ = params.filter_val_gate_thresh;
+
+    filters_.setFilterParameters(params.kf_params);
+  }
+
+  // Run the process model periodically in a thread, and update the filters from targets
+  // as they arrive:
+  void initialize(void);
+  void processFiltersLoop(double frequency);
+  void updateFilters(const std::vector<RadarTarget>& targets);
+
+  // Event-driven alternative to the process thread: propagate the filters to the time the
+  // targets were measured, in seconds on the caller's clock, then update them:
+  void updateFilters(const std::vector<RadarTarget>& targets, double time);
+  void stopRunning(void)
+  {
+    is_running_ = false;
+  }
+  void getTrackedObjects(std::vector<RadarTarget>& tracked_objects);
+  void getTrackedObjectTargets(std::vector<std::vector<RadarTarget>>& tracked_objects);
+
+  static const int max_tracked_targets;
+  static const double grid_range_cell_size;    // m
+  static const double grid_azimuth_cell_size;  // deg
+
+private:
+  static double toSec(const std::chrono::system_clock::time_point& time)
+  {
+    return std::chrono::duration<double>(time.time_since_epoch()).count();
+  }
+
+  // Drop filters not updated within the timeout, then run the process model over dt:
+  void processFilters(double dt, double time);
+  void associateTargets(const std::vector<RadarTarget>& targets, double time);
+  void updateTracked(double time);
+  void findCandidates(const Eigen::Vector4d& pred_meas, const Eigen::Matrix4d& meas_cov, int first);
+
+  // Parameters:
+  double filter_process_rate_;
+  double filter_min_time_;
+  double filter_timeout_;
+  double filter_val_gate_thresh_;
+
+  bool print_debug_;
+
+  bool is_running_;
+
+  // Time the filters were last propagated to, when event-driven:
+  bool has_time_;
+  double time_;
+
+  std::unique_ptr<std::thread> filter_process_thread_;
+  std::mutex mutex_;
+
+  RadarTargetKFBank filters_;
+  std::vector<std::vector<ainstein_radar_core::RadarTarget>> filter_targets_;
+  std::vector<int> meas_count_vec_;
+  std::vector<bool> is_tracked_;
+
+  // Measurements of the frame being associated, one column per target, indexed by range and
+  // azimuth. Candidates are the targets near the filter being updated, whose distances from
+  // its gate are then computed:
+  MeasurementGate::MeasurementBlock meas_;
+  Eigen::Matrix<double, 2, Eigen::Dynamic> grid_points_;
+  DetectionGrid<2> grid_;
+  std::vector<int> candidates_;
+  MeasurementGate::MeasurementBlock candidate_meas_;
+  Eigen::RowVectorXd meas_dist_;
+  MeasurementGate gate_;
+};
+
+}  // namespace ainstein_radar_core
+
+#endif  // RADAR_TRACKING_FILTER_H_
@@ -0,0 +1,96 @@
+#ifndef TRACKING_FILTER_CART_H_
+#define TRACKING_FILTER_CART_H_
+
+#include <vector>
+
+#include <Eigen/Eigen>
+
+#include <ainstein_radar_core/bounding_box.h>
+#include <ainstein_radar_core/detection_grid.h>
+#include <ainstein_radar_core/measurement_gate.h>
+#include <ainstein_radar_core/radar_target.h>
+#include <ainstein_radar_core/radar_target_cartesian_kf.h>
+
+namespace ainstein_radar_core
+{
+  // Multi-target tracker running one Cartesian Kalman Filter per tracked object. Each
+  // frame of raw targets updates the filters whose validation gate a target falls in,
+  // and targets no filter accepts start new filters. The caller runs the process model
+  // periodically and reads out the objects tracked for long enough; times are in
+  // seconds on the caller's clock. The tracker is not thread-safe.
+  class TrackingFilterCartesian
+  {
+  public:
+    class FilterParameters
+    {
+    public:
+      FilterParameters( void ) {}
+      ~FilterParameters( void ) {}
+
+      double filter_min_time;
+      double filter_timeout;
+      double filter_val_gate_thresh;
+
+      // Underlying Kalman Filter parameters (shared among this tracker's KFs):
+      RadarTargetCartesianKF::FilterParameters kf_params;
+    };
+
+    // Estimate of one tracked object, and the box around the targets it was last updated from:
+    class TrackedObject
+    {
+    public:
+      RadarTarget target;
+      Eigen::Affine3d pose;
+      BoundingBox box;
+    };
+
+    TrackingFilterCartesian( void );
+    ~TrackingFilterCartesian( void ) {}
+
+    void setFilterParameters( const FilterParameters& params );
+
+    // Drop filters not updated within the timeout, then run the process model over dt:
+    void processFilters( double dt, double time );
+
+    // Update the filters from one frame of raw targets:
+    void updateFilters( const std::vector<RadarTarget>& targets, double time );
+
+    // Objects whose filters have been running for at least the minimum time:
+    void getTrackedObjects( double time, std::vector<TrackedObject>& objects ) const;
+
+    int getNumFilters( void ) const
+    {
+      return filters_.size();
+    }
+
+    static BoundingBox getBoundingBox( const RadarTarget& tracked_target, const std::vector<RadarTarget>& targets );
+
+    static const int max_tracked_targets;
+    static const double grid_cell_size; // m
+
+  private:
+    void findCandidates( const Eigen::Vector4d& pred_meas, const Eigen::Matrix4d& meas_cov, int first );
+
+    double filter_min_time_;
+    double filter_timeout_;
+    double filter_val_gate_thresh_;
+
+    RadarTargetCartesianKF::Models kf_models_;
+    std::vector<RadarTargetCartesianKF> filters_;
+    std::vector<std::vector<RadarTarget>> filter_targets_;
+    std::vector<int> meas_count_vec_;
+
+    // Measurements of the frame being associated, one column per target, indexed by
+    // position. Candidates are the targets near the filter being updated, whose
+    // distances from its gate are then computed:
+    MeasurementGate::MeasurementBlock meas_;
+    DetectionGrid<3> grid_;
+    std::vector<int> candidates_;
+    MeasurementGate::MeasurementBlock candidate_meas_;
+    Eigen::RowVectorXd meas_dist_;
+    MeasurementGate gate_;
+  };
+
+} // namespace ainstein_radar_core
+
+#endif // TRACKING_FILTER_CART_H_
@@ -0,0 +1,64 @@
+/*
+  Copyright <2018-2019> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "ainstein_radar_core/radar_target_cartesian_kf.h"
+
+namespace ainstein_radar_core
+{
+  RadarTargetCartesianKF::Models::Models( const FilterParameters& params ) :
+    motion_model( std::pow( params.q_vel_stdev, 2.0 ) ),
+    meas_model( std::pow( params.r_speed_stdev, 2.0 ), std::pow( params.r_pos_stdev, 2.0 ) )
+  {
+    P_init = ( Eigen::Matrix<double, 6, 1>() <<
+	       std::pow( params.init_pos_stdev, 2.0 ),
+	       std::pow( params.init_pos_stdev, 2.0 ),
+	       std::pow( params.init_pos_stdev, 2.0 ),
+	       std::pow( params.init_vel_stdev, 2.0 ),
+	       std::pow( params.init_vel_stdev, 2.0 ),
+	       std::pow( params.init_vel_stdev, 2.0 ) ).finished().asDiagonal();
+  }
+      
+  RadarTargetCartesianKF::RadarTargetCartesianKF( const RadarTarget& target, double time, const Models& models ) :
+    kf_( FilterState( target, models.P_init ).asVec(), models.P_init ),
+    time_first_update_( time ),
+    time_last_update_( time )
+  {
+  }
+
+  void RadarTargetCartesianKF::process( const Models& models, double dt )
+  {
+    kf_.process( models.motion_model, dt );
+  }
+
+  void RadarTargetCartesianKF::update( const Models& models, const RadarTarget& target, double time )
+  {
+    kf_.update( models.meas_model, computeMeas( target ) );
+
+    // Set the time of the update for book keeping filters:
+    time_last_update_ = time;
+  }
+  
+} // namespace ainstein_radar_core
@@ -0,0 +1,172 @@
+/*
+  Copyright <2018-2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "ainstein_radar_core/radar_target_decoder.h"
+
+namespace ainstein_radar_core
+{
+  const unsigned int RadarTargetDecoder::record_len = 8;
+
+  // O79: signed azimuth and elevation in degrees:
+  const RadarTargetDecoder::Format RadarTargetDecoder::format_o79 = { 0.116, 0.045, true, 1.0, 0.0, true, 1.0, 0.0 };
+
+  // K79: unsigned azimuth with a 90 deg offset, no elevation output:
+  const RadarTargetDecoder::Format RadarTargetDecoder::format_k79 = { 0.116, 0.045, false, -1.0, 90.0, false, 0.0, 0.0 };
+
+  // K79-3D: as K79 but 0.1 m range counts and elevation in 0.1 deg with a 90 deg offset:
+  const RadarTargetDecoder::Format RadarTargetDecoder::format_k79_3d = { 0.1, 0.045, false, -1.0, 90.0, false, 0.1, -90.0 };
+
+  RadarTargetDecoder::RadarTargetDecoder( const Format& format ) :
+    format_( format )
+  {
+    for( int b = 0; b < 256; ++b )
+      {
+	range_lut_[b] = static_cast<float>( b * format_.range_res );
+
+	// Speed is 0-127, with 0-64 negative (moving away) and 65-127 positive (moving towards).
+	// Note that 65 is the highest speed moving towards, hence the manipulation below.
+	if( b <= 64 ) // MOVING AWAY FROM RADAR
+	  {
+	    speed_lut_[b] = static_cast<float>( b * format_.speed_res );
+	  }
+	else // MOVING TOWARDS RADAR
+	  {
+	    speed_lut_[b] = static_cast<float>( ( b - 127 ) * format_.speed_res );
+	  }
+      }
+
+    setGate( RadarTargetGate() );
+  }
+
+  void RadarTargetDecoder::setGate( const RadarTargetGate& gate )
+  {
+    is_gated_ = !gate.isOpen();
+    for( int b = 0; b < 256; ++b )
+      {
+	range_in_gate_[b] = gate.range.contains( range_lut_[b] );
+	speed_in_gate_[b] = gate.speed.contains( speed_lut_[b] );
+      }
+    azimuth_gate_ = RadarTargetGate::toRaw( gate.azimuth, format_.azimuth_scale, format_.azimuth_offset );
+    elevation_gate_ = RadarTargetGate::toRaw( gate.elevation, format_.elevation_scale, format_.elevation_offset );
+    snr_gate_ = RadarTargetGate::toRaw( gate.snr, 1.0, 0.0 );
+  }
+
+  void RadarTargetDecoder::decode( const char* data, int num_records, int first_id,
+				   RadarTargetFrame& frame ) const
+  {
+    if( num_records <= 0 )
+      {
+	return;
+      }
+
+    // Grow every column once and write each field in place:
+    const std::size_t base = frame.size();
+    frame.resize( base + num_records );
+
+    uint16_t* id = frame.id.data() + base;
+    float* range = frame.range.data() + base;
+    float* speed = frame.speed.data() + base;
+    float* azimuth = frame.azimuth.data() + base;
+    float* elevation = frame.elevation.data() + base;
+    float* snr = frame.snr.data() + base;
+
+    // Gated records are checked and decoded one at a time, only keeping those in the gate:
+    if( is_gated_ )
+      {
+	int num_targets = 0;
+	for( int k = 0; k < num_records; ++k )
+	  {
+	    const char* record = data + k * RadarTargetDecoder::record_len;
+	    if( isInGate( record ) )
+	      {
+		int j = num_targets++;
+		id[j] = static_cast<uint16_t>( first_id + k );
+		decodeRecord( record, range[j], speed[j], azimuth[j], elevation[j], snr[j] );
+	      }
+	  }
+	frame.resize( base + num_targets );
+	return;
+      }
+
+    int i = 0;
+
+#ifdef __SSE2__
+    // Four records are two 16-byte loads of 16-bit words; transpose them so each
+    // 16-bit field lands in its own register and convert four targets at a time:
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 az_scale_ps = _mm_set1_ps( static_cast<float>( format_.azimuth_scale ) );
+    const __m128 az_offset_ps = _mm_set1_ps( static_cast<float>( format_.azimuth_offset ) );
+    const __m128 el_scale_ps = _mm_set1_ps( static_cast<float>( format_.elevation_scale ) );
+    const __m128 el_offset_ps = _mm_set1_ps( static_cast<float>( format_.elevation_offset ) );
+    for( ; i + 4 <= num_records; i += 4 )
+      {
+	const char* rec = data + i * RadarTargetDecoder::record_len;
+	__m128i a = _mm_loadu_si128( reinterpret_cast<const __m128i*>( rec ) );
+	__m128i b = _mm_loadu_si128( reinterpret_cast<const __m128i*>( rec + 16 ) );
+
+	__m128i lo = _mm_unpacklo_epi16( a, b );
+	__m128i hi = _mm_unpackhi_epi16( a, b );
+	__m128i words01 = _mm_unpacklo_epi16( lo, hi ); // azimuth x4, range/speed x4
+	__m128i words23 = _mm_unpackhi_epi16( lo, hi ); // elevation x4, SNR x4
+
+	__m128i az_i = format_.azimuth_signed ?
+	  _mm_srai_epi32( _mm_unpacklo_epi16( words01, words01 ), 16 ) :
+	  _mm_unpacklo_epi16( words01, zero );
+	__m128i el_i = format_.elevation_signed ?
+	  _mm_srai_epi32( _mm_unpacklo_epi16( words23, words23 ), 16 ) :
+	  _mm_unpacklo_epi16( words23, zero );
+	__m128i snr_i = _mm_unpackhi_epi16( words23, zero );
+
+	_mm_storeu_ps( azimuth + i, _mm_add_ps( _mm_mul_ps( _mm_cvtepi32_ps( az_i ), az_scale_ps ), az_offset_ps ) );
+	_mm_storeu_ps( elevation + i, _mm_add_ps( _mm_mul_ps( _mm_cvtepi32_ps( el_i ), el_scale_ps ), el_offset_ps ) );
+	_mm_storeu_ps( snr + i, _mm_cvtepi32_ps( snr_i ) );
+
+	for( int k = i; k < i + 4; ++k )
+	  {
+	    const uint8_t* r = reinterpret_cast<const uint8_t*>( data + k * RadarTargetDecoder::record_len );
+	    id[k] = static_cast<uint16_t>( first_id + k );
+	    range[k] = range_lut_[r[2]];
+	    speed[k] = speed_lut_[r[3]];
+	  }
+      }
+#endif
+
+    // Remaining records (or all of them without SSE2):
+    for( ; i < num_records; ++i )
+      {
+	id[i] = static_cast<uint16_t>( first_id + i );
+	decodeRecord( data + i * RadarTargetDecoder::record_len, range[i], speed[i], azimuth[i], elevation[i], snr[i] );
+      }
+  }
+
+} // namespace ainstein_radar_core
@@ -0,0 +1,189 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <algorithm>
+
+#include "ainstein_radar_core/radar_target_kf_bank.h"
+
+namespace ainstein_radar_core
+{
+RadarTargetKFBank::RadarTargetKFBank(void) : size_(0)
+{
+}
+
+void RadarTargetKFBank::setFilterParameters(const RadarTargetKF::FilterParameters& params)
+{
+  models_ = RadarTargetKF::Models(params);
+}
+
+void RadarTargetKFBank::reserve(int capacity)
+{
+  if (capacity > data_.cols())
+  {
+	data_.conservativeResize(Eigen::NoChange, capacity);
+	fp_.resize(Eigen::NoChange, capacity);
+	time_first_update_.reserve(capacity);
+	time_last_update_.reserve(capacity);
+  }
+}
+
+void RadarTargetKFBank::add(double target_range, double target_speed, double target_azimuth, double target_elevation,
+			    double time)
+{
+  if (size_ == data_.cols())
+  {
+	reserve(std::max<int>(2 * size_, 16));
+  }
+
+  setFilter(size_, Eigen::Vector4d(target_range, target_speed, target_azimuth, target_elevation), models_.P_init);
+  ++size_;
+
+  time_first_update_.push_back(time);
+  time_last_update_.push_back(time);
+}
+
+void RadarTargetKFBank::process(double dt)
+{
+  // x = F * x and P = F * P * F^T + Q, each row contiguous over all filters. Most of F is
+  // zero, and the products with its zeros are skipped:
+  const Eigen::Matrix4d F = models_.motion_model.transition(dt);
+  const Eigen::Matrix4d Q = models_.motion_model.processNoise(dt);
+  const int n = size_;
+  auto row = [&](int r) { return data_.row(r).head(n); };
+  auto fp = [&](int r, int c) { return fp_.row(4 * r + c).head(n); };
+
+  // The new state goes through the first rows of FP, which the covariance then reuses:
+  for (int r = 0; r < 4; ++r)
+  {
+	fp(0, r).setZero();
+	for (int k = 0; k < 4; ++k)
+	{
+	  if (F(r, k) != 0.0)
+	  {
+		fp(0, r) += F(r, k) * row(k);
+	  }
+	}
+  }
+  for (int r = 0; r < 4; ++r)
+  {
+	row(r) = fp(0, r);
+  }
+
+  for (int r = 0; r < 4; ++r)
+  {
+	for (int c = 0; c < 4; ++c)
+	{
+	  fp(r, c).setZero();
+	  for (int k = 0; k < 4; ++k)
+	  {
+		if (F(r, k) != 0.0)
+		{
+		  fp(r, c) += F(r, k) * row(covRow(k, c));
+		}
+	  }
+	}
+  }
+
+  // Only the upper triangle of FP * F^T is needed:
+  for (int r = 0; r < 4; ++r)
+  {
+	for (int c = r; c < 4; ++c)
+	{
+	  auto p = row(covRow(r, c));
+	  p.setConstant(Q(r, c));
+	  for (int k = 0; k < 4; ++k)
+	  {
+		if (F(c, k) != 0.0)
+		{
+		  p += F(c, k) * fp(r, k);
+		}
+	  }
+	}
+  }
+}
+
+void RadarTargetKFBank::update(int i, double target_range, double target_speed, double target_azimuth,
+							   double target_elevation, double time)
+{
+  RadarTargetKF::Filter kf(getState(i), getCovariance(i));
+  kf.update(models_.meas_model, Eigen::Vector4d(target_range, target_speed, target_azimuth, target_elevation));
+  setFilter(i, kf.getState(), kf.getCovariance());
+
+  // Set the time of the update for book keeping filters:
+  time_last_update_[i] = time;
+}
+
+Eigen::Matrix4d RadarTargetKFBank::getCovariance(int i) const
+{
+  auto x = data_.col(i);
+  Eigen::Matrix4d cov;
+  for (int r = 0; r < 4; ++r)
+  {
+	for (int c = r; c < 4; ++c)
+	{
+	  cov(r, c) = x(covRow(r, c));
+	  cov(c, r) = cov(r, c);
+	}
+  }
+  return cov;
+}
+
+void RadarTargetKFBank::setFilter(int i, const Eigen::Vector4d& state, const Eigen::Matrix4d& cov)
+{
+  auto x = data_.col(i);
+  x.head<4>() = state.array();
+  for (int r = 0; r < 4; ++r)
+  {
+	for (int c = r; c < 4; ++c)
+	{
+	  x(covRow(r, c)) = cov(r, c);
+	}
+  }
+}
+
+void RadarTargetKFBank::print(std::ostream& out, int i) const
+{
+  Eigen::Vector4d state = getState(i);
+  out << "State: " << std::endl
+	  << "Range: " << state(0) << std::endl
+	  << "Speed: " << state(1) << std::endl
+	  << "Azimuth: " << state(2) << std::endl
+	  << "Elevation: " << state(3) << std::endl
+	  << "Covariance: " << std::endl
+	  << getCovariance(i) << std::endl
+	  << "First Update: " << time_first_update_[i] << std::endl
+	  << "Last Update: " << time_last_update_[i] << std::endl;
+}
+
+int RadarTargetKFBank::covRow(int r, int c)
+{
+  // The upper triangle is stored row by row, each row starting at its diagonal:
+  static const int diagonal_rows[4] = { P00, P11, P22, P33 };
+  return (r <= c ? diagonal_rows[r] + (c - r) : diagonal_rows[c] + (r - c));
+}
+
+}  // namespace ainstein_radar_core
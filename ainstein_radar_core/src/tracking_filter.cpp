@@ -24,11 +24,16 @@
   OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-#include "ainstein_radar_filters/tracking_filter.h"
+#include <algorithm>
+#include <numeric>
 
-namespace ainstein_radar_filters
+#include "ainstein_radar_core/tracking_filter.h"
+
+namespace ainstein_radar_core
 {
 const int TrackingFilter::max_tracked_targets = 100;
+const double TrackingFilter::grid_range_cell_size = 2.0;
+const double TrackingFilter::grid_azimuth_cell_size = 5.0;
 
 void TrackingFilter::initialize(void)
 {
@@ -57,7 +62,7 @@ void TrackingFilter::processFiltersLoop(double frequency)
 	}
 
 	time_now = std::chrono::system_clock::now();
-	dt = 0.001 * std::chrono::duration_cast<std::chrono::milliseconds>(time_now - time_prev).count();
+	dt = std::chrono::duration<double>(time_now - time_prev).count();
 
 	if (print_debug_)
 	{
@@ -67,43 +72,8 @@ void TrackingFilter::processFiltersLoop(double frequency)
 	// Block callback from modifying the filters
 	mutex_.lock();
 
-	// Remove filters which have not been updated in specified time:
-	if (print_debug_)
-	{
-	  std::cout << "Number of filters before pruning: " << filters_.size() << std::endl;
-	}
-	if (filters_.size() > 0)
-	{
-	  filters_.erase(
-		  std::remove_if(filters_.begin(), filters_.end(),
-						 [&](const RadarTargetKF& kf) { return (kf.getTimeSinceUpdate() > filter_timeout_); }),
-		  filters_.end());
-	}
-	if (print_debug_)
-	{
-	  std::cout << "Number of filters after pruning: " << filters_.size() << std::endl;
-	}
-
-	// Run process model for each filter:
-	for (auto& kf : filters_)
-	{
-	  kf.process(dt);
-	}
-
-	// Update which filters are currently tracking (based on time alive):
-	is_tracked_.resize(filters_.size());
-	std::fill(is_tracked_.begin(), is_tracked_.end(), false);
-	for (int i = 0; i < filters_.size(); ++i)
-	{
-	  if (filters_.at(i).getTimeSinceStart() >= filter_min_time_)
-	  {
-		is_tracked_.at(i) = true;
-	  }
-	  else
-	  {
-		is_tracked_.at(i) = false;
-	  }
-	}
+	processFilters(dt, toSec(time_now));
+	updateTracked(toSec(time_now));
 
 	// Release lock on filter state
 	mutex_.unlock();
@@ -133,64 +103,141 @@ void TrackingFilter::processFiltersLoop(double frequency)
 }
 
 void TrackingFilter::updateFilters(const std::vector<RadarTarget>& targets)
+{
+  // Block update loop from modifying the filters
+  mutex_.lock();
+
+  const double time = toSec(std::chrono::system_clock::now());
+  associateTargets(targets, time);
+  updateTracked(time);
+
+  // Release lock on filter state
+  mutex_.unlock();
+}
+
+void TrackingFilter::updateFilters(const std::vector<RadarTarget>& targets, double time)
+{
+  mutex_.lock();
+
+  // Propagate the filters to the measurement time. Measurements older than the filters
+  // update them without propagating backwards:
+  if (!has_time_)
+  {
+	time_ = time;
+	has_time_ = true;
+  }
+  processFilters(std::max(time - time_, 0.0), time);
+  time_ = std::max(time, time_);
+
+  associateTargets(targets, time);
+  updateTracked(time);
+
+  mutex_.unlock();
+}
+
+void TrackingFilter::processFilters(double dt, double time)
+{
+  // Remove filters which have not been updated in specified time:
+  if (print_debug_)
+  {
+	std::cout << "Number of filters before pruning: " << filters_.size() << std::endl;
+  }
+  filters_.removeIf([&](int i) { return (filters_.getTimeSinceUpdate(i, time) > filter_timeout_); });
+  if (print_debug_)
+  {
+	std::cout << "Number of filters after pruning: " << filters_.size() << std::endl;
+  }
+
+  // Run process model for all filters at once:
+  filters_.process(dt);
+}
+
+void TrackingFilter::associateTargets(const std::vector<RadarTarget>& targets, double time)
 {
   // Reset the measurement count vector for keeping track of which measurements get used:
   meas_count_vec_.resize(targets.size());
   std::fill(meas_count_vec_.begin(), meas_count_vec_.end(), 0);
 
-  // Block update loop from modifying the filters
-  mutex_.lock();
-
   // Resize the targets associated with each filter:
   filter_targets_.clear();
   filter_targets_.resize(filters_.size());
 
+  // Stack the targets as measurement columns once for all filters:
+  const int num_targets = targets.size();
+  meas_.resize(Eigen::NoChange, num_targets);
+  meas_dist_.resize(num_targets);
+  grid_points_.resize(Eigen::NoChange, num_targets);
+  for (int j = 0; j < num_targets; ++j)
+  {
+	meas_.col(j) << targets[j].range, targets[j].speed, targets[j].azimuth, targets[j].elevation;
+	grid_points_.col(j) << targets[j].range, targets[j].azimuth;
+  }
+
+  // Index the targets by range and azimuth, so each filter only checks the targets near it:
+  grid_.build(grid_points_);
+
   // Pass the raw detections to the filters for updating:
   for (int i = 0; i < filters_.size(); ++i)
   {
 	if (print_debug_)
 	{
-	  std::cout << filters_.at(i) << std::endl;
+	  filters_.print(std::cout, i);
 	}
-	for (int j = 0; j < targets.size(); ++j)
+
+	// Gate the targets against the filter's predicted measurement, which only changes when
+	// the filter takes a target, so each update rechecks the targets after it:
+	int j = 0;
+	while (j < num_targets)
 	{
-	  // Only use this target if it hasn't already been used by a filter:
-	  if (meas_count_vec_.at(j) == 0)
-	  {
-		// Check whether the target should be used as measurement by this filter:
-		RadarTarget t = targets.at(j);
-		Eigen::Vector4d z = filters_.at(i).computePredMeas(filters_.at(i).getState());
-		Eigen::Vector4d y = Eigen::Vector4d(t.range, t.speed, t.azimuth, t.elevation);
+	  Eigen::Vector4d pred_meas = filters_.computePredMeas(i);
+	  Eigen::Matrix4d meas_cov = filters_.computeMeasCov(i);
+	  findCandidates(pred_meas, meas_cov, j);
 
-		// Compute the normalized measurement error (squared):
-		double meas_err =
-			(y - z).transpose() * filters_.at(i).computeMeasCov(filters_.at(i).getState()).inverse() * (y - z);
+	  const int num_candidates = candidates_.size();
+	  candidate_meas_.resize(Eigen::NoChange, num_candidates);
+	  for (int k = 0; k < num_candidates; ++k)
+	  {
+		candidate_meas_.col(k) = meas_.col(candidates_[k]);
+	  }
+	  gate_.set(pred_meas, meas_cov);
+	  gate_.computeDistances(candidate_meas_, meas_dist_.head(num_candidates));
 
+	  // Take the first candidate within the gate:
+	  int k = 0;
+	  while (k < num_candidates && !(meas_dist_[k] < filter_val_gate_thresh_))
+	  {
 		if (print_debug_)
 		{
-		  std::cout << "Meas Cov Inv: " << filters_.at(i).computeMeasCov(filters_.at(i).getState()).inverse()
-					<< std::endl;
-		  std::cout << "Target " << j << " meas_err: " << meas_err << std::endl;
-		  std::cout << "Target " << j << ": " << std::endl
-					<< t.range << " " << t.speed << " " << t.azimuth << " " << t.elevation << std::endl;
+		  std::cout << "Target " << candidates_[k] << " meas_err: " << meas_dist_[k] << std::endl;
 		}
+		++k;
+	  }
+	  if (k == num_candidates)
+	  {
+		break;
+	  }
 
-		// Allow the measurement through the validation gate based on threshold:
-		if (meas_err < filter_val_gate_thresh_)
-		{
-		  filters_.at(i).update(t.range, t.speed, t.azimuth, t.elevation);
-		  ++meas_count_vec_.at(j);
-
-		  // Store the target associated with the filter:
-		  filter_targets_.at(i).push_back(t);
-		}
+	  j = candidates_[k];
+	  const RadarTarget& t = targets[j];
+	  if (print_debug_)
+	  {
+		std::cout << "Target " << j << " meas_err: " << meas_dist_[k] << std::endl;
+		std::cout << "Target " << j << ": " << std::endl
+				  << t.range << " " << t.speed << " " << t.azimuth << " " << t.elevation << std::endl;
 	  }
+
+	  filters_.update(i, t.range, t.speed, t.azimuth, t.elevation, time);
+	  ++meas_count_vec_[j];
+
+	  // Store the target associated with the filter:
+	  filter_targets_.at(i).push_back(t);
+	  ++j;
 	}
   }
 
   // Iterate through targets and push back new KFs for unused measurements:
   std::vector<RadarTarget> arr;
-  for (int i = 0; i < meas_count_vec_.size(); ++i)
+  for (std::size_t i = 0; i < meas_count_vec_.size(); ++i)
   {
 	if (meas_count_vec_.at(i) == 0)
 	{
@@ -199,19 +246,22 @@ void TrackingFilter::updateFilters(const std::vector<RadarTarget>& targets)
 		std::cout << "Pushing back new filter: " << targets.at(i).range << " " << targets.at(i).speed << " "
 				  << targets.at(i).azimuth << " " << targets.at(i).elevation << std::endl;
 	  }
-	  filters_.emplace_back(targets.at(i).range, targets.at(i).speed, targets.at(i).azimuth, targets.at(i).elevation);
+	  filters_.add(targets.at(i).range, targets.at(i).speed, targets.at(i).azimuth, targets.at(i).elevation, time);
 
 	  // Make sure to push back an empty array of targets associated with the new filter
 	  filter_targets_.push_back(arr);
 	}
   }
+}
 
+void TrackingFilter::updateTracked(double time)
+{
   // Update which filters are currently tracking (based on time alive):
   is_tracked_.resize(filters_.size());
   std::fill(is_tracked_.begin(), is_tracked_.end(), false);
   for (int i = 0; i < filters_.size(); ++i)
   {
-	if (filters_.at(i).getTimeSinceStart() >= filter_min_time_)
+	if (filters_.getTimeSinceStart(i, time) >= filter_min_time_)
 	{
 	  is_tracked_.at(i) = true;
 	}
@@ -220,9 +270,25 @@ void TrackingFilter::updateFilters(const std::vector<RadarTarget>& targets)
 	  is_tracked_.at(i) = false;
 	}
   }
+}
 
-  // Release lock on filter state
-  mutex_.unlock();
+void TrackingFilter::findCandidates(const Eigen::Vector4d& pred_meas, const Eigen::Matrix4d& meas_cov, int first)
+{
+  // The gate ellipse lies within sqrt(thresh * variance) of the predicted range and azimuth,
+  // so only targets in the grid cells overlapping that box can pass it:
+  Eigen::Vector2d center(pred_meas(0), pred_meas(2));
+  Eigen::Vector2d half_size =
+	  (filter_val_gate_thresh_ * Eigen::Vector2d(meas_cov(0, 0), meas_cov(2, 2))).cwiseSqrt();
+  if (!grid_.query(center - half_size, center + half_size, candidates_))
+  {
+	candidates_.resize(meas_count_vec_.size());
+	std::iota(candidates_.begin(), candidates_.end(), 0);
+  }
+
+  // Only targets from first on which no filter has used yet:
+  candidates_.erase(std::remove_if(candidates_.begin(), candidates_.end(),
+								   [&](int j) { return (j < first || meas_count_vec_[j] != 0); }),
+					candidates_.end());
 }
 
 void TrackingFilter::getTrackedObjects(std::vector<RadarTarget>& tracked_objects)
@@ -234,8 +300,8 @@ void TrackingFilter::getTrackedObjects(std::vector<RadarTarget>& tracked_objects
   {
 	if (is_tracked_.at(i))
 	{
-	  RadarTargetKF::FilterState state = filters_.at(i).getState();
-	  RadarTarget object(state.range, state.speed, state.azimuth, state.elevation);
+	  Eigen::Vector4d state = filters_.getState(i);
+	  RadarTarget object(tracked_objects.size(), state(0), state(1), state(2), state(3), 0.0);
 	  tracked_objects.push_back(object);
 	}
   }
@@ -259,4 +325,4 @@ void TrackingFilter::getTrackedObjectTargets(std::vector<std::vector<RadarTarget
   mutex_.unlock();
 }
 
-}  // namespace ainstein_radar_filters
\ No newline at end of file
+}  // namespace ainstein_radar_core
\ No newline at end of file
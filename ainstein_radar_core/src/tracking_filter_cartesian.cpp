@@ -0,0 +1,244 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "ainstein_radar_core/tracking_filter_cartesian.h"
+
+namespace ainstein_radar_core
+{
+  const int TrackingFilterCartesian::max_tracked_targets = 100;
+  const double TrackingFilterCartesian::grid_cell_size = 2.0;
+
+  TrackingFilterCartesian::TrackingFilterCartesian( void ) :
+    filter_min_time_( 1.0 ),
+    filter_timeout_( 0.5 ),
+    filter_val_gate_thresh_( 1.923 ),
+    grid_( Eigen::Vector3d::Constant( TrackingFilterCartesian::grid_cell_size ) )
+  {
+    // Reserve space for the maximum number of target Kalman Filters:
+    filters_.reserve( TrackingFilterCartesian::max_tracked_targets );
+    filter_targets_.reserve( TrackingFilterCartesian::max_tracked_targets );
+  }
+
+  void TrackingFilterCartesian::setFilterParameters( const FilterParameters& params )
+  {
+    filter_min_time_ = params.filter_min_time;
+    filter_timeout_ = params.filter_timeout;
+    filter_val_gate_thresh_ = params.filter_val_gate_thresh;
+
+    kf_models_ = RadarTargetCartesianKF::Models( params.kf_params );
+  }
+
+  void TrackingFilterCartesian::processFilters( double dt, double time )
+  {
+    // Remove filters which have not been updated in specified time, along with their targets:
+    std::size_t num_kept = 0;
+    for( std::size_t i = 0; i < filters_.size(); ++i )
+      {
+	if( filters_.at( i ).getTimeSinceUpdate( time ) <= filter_timeout_ )
+	  {
+	    if( num_kept != i )
+	      {
+		filters_.at( num_kept ) = filters_.at( i );
+		filter_targets_.at( num_kept ).swap( filter_targets_.at( i ) );
+	      }
+	    ++num_kept;
+	  }
+      }
+    filters_.erase( filters_.begin() + num_kept, filters_.end() );
+    filter_targets_.resize( num_kept );
+
+    // Run process model for each filter:
+    for( auto& kf : filters_ )
+      {
+	kf.process( kf_models_, dt );
+      }
+  }
+
+  void TrackingFilterCartesian::updateFilters( const std::vector<RadarTarget>& targets, double time )
+  {
+    // Reset the measurement count vector for keeping track of which measurements get used:
+    meas_count_vec_.assign( targets.size(), 0 );
+
+    // Clear the targets associated with each filter:
+    filter_targets_.resize( filters_.size() );
+    for( auto& filter_targets : filter_targets_ )
+      {
+	filter_targets.clear();
+      }
+
+    // Convert the targets to measurements once for all filters:
+    const int num_targets = targets.size();
+    meas_.resize( Eigen::NoChange, num_targets );
+    meas_dist_.resize( num_targets );
+    for( int j = 0; j < num_targets; ++j )
+      {
+	meas_.col( j ) = RadarTargetCartesianKF::computeMeas( targets[j] );
+      }
+
+    // Index the target positions, so each filter only checks the targets near it:
+    grid_.build( meas_.bottomRows<3>() );
+
+    // Pass the raw detections to the filters for updating:
+    for( std::size_t i = 0; i < filters_.size(); ++i )
+      {
+	RadarTargetCartesianKF& kf = filters_.at( i );
+
+	// Gate the targets against the filter's predicted measurement, which only changes
+	// when the filter takes a target, so each update rechecks the targets after it:
+	int j = 0;
+	while( j < num_targets )
+	  {
+	    Eigen::Vector4d pred_meas = kf.computePredMeas( kf_models_ );
+	    Eigen::Matrix4d meas_cov = kf.computeMeasCov( kf_models_ );
+	    findCandidates( pred_meas, meas_cov, j );
+
+	    const int num_candidates = candidates_.size();
+	    candidate_meas_.resize( Eigen::NoChange, num_candidates );
+	    for( int k = 0; k < num_candidates; ++k )
+	      {
+		candidate_meas_.col( k ) = meas_.col( candidates_[k] );
+	      }
+	    gate_.set( pred_meas, meas_cov );
+	    gate_.computeDistances( candidate_meas_, meas_dist_.head( num_candidates ) );
+
+	    // Take the first candidate within the gate:
+	    int k = 0;
+	    while( k < num_candidates && !( meas_dist_[k] < filter_val_gate_thresh_ ) )
+	      {
+		++k;
+	      }
+	    if( k == num_candidates )
+	      {
+		break;
+	      }
+
+	    j = candidates_[k];
+	    const RadarTarget& t = targets[j];
+	    kf.update( kf_models_, t, time );
+	    ++meas_count_vec_[j];
+
+	    // Store the target associated with the filter:
+	    filter_targets_.at( i ).push_back( t );
+	    ++j;
+	  }
+      }
+
+    // Iterate through targets and push back new KFs for unused measurements:
+    for( std::size_t j = 0; j < meas_count_vec_.size(); ++j )
+      {
+	if( meas_count_vec_.at( j ) == 0 )
+	  {
+	    filters_.emplace_back( targets.at( j ), time, kf_models_ );
+
+	    // Make sure to push back an empty array of targets associated with the new filter
+	    filter_targets_.emplace_back();
+	  }
+      }
+  }
+
+  void TrackingFilterCartesian::findCandidates( const Eigen::Vector4d& pred_meas, const Eigen::Matrix4d& meas_cov, int first )
+  {
+    // The gate ellipse lies within sqrt( thresh * variance ) of the predicted position along
+    // each axis, so only targets in the grid cells overlapping that box can pass it:
+    Eigen::Vector3d half_size = ( filter_val_gate_thresh_ * meas_cov.diagonal().tail<3>() ).cwiseSqrt();
+    if( !grid_.query( pred_meas.tail<3>() - half_size, pred_meas.tail<3>() + half_size, candidates_ ) )
+      {
+	candidates_.resize( meas_count_vec_.size() );
+	std::iota( candidates_.begin(), candidates_.end(), 0 );
+      }
+
+    // Only targets from first on which no filter has used yet:
+    candidates_.erase( std::remove_if( candidates_.begin(), candidates_.end(),
+				       [&]( int j ) { return ( j < first || meas_count_vec_[j] != 0 ); } ),
+		       candidates_.end() );
+  }
+
+  void TrackingFilterCartesian::getTrackedObjects( double time, std::vector<TrackedObject>& objects ) const
+  {
+    // Add tracked targets for filters which have been running for specified time:
+    objects.clear();
+    TrackedObject object;
+    for( std::size_t i = 0; i < filters_.size(); ++i )
+      {
+	if( filters_.at( i ).getTimeSinceStart( time ) >= filter_min_time_ )
+	  {
+	    object.target = filters_.at( i ).getState().asTarget();
+	    object.target.id = objects.size();
+	    object.pose = filters_.at( i ).getState().asPose();
+	    object.box = getBoundingBox( object.target, filter_targets_.at( i ) );
+	    objects.push_back( object );
+	  }
+      }
+  }
+
+  BoundingBox TrackingFilterCartesian::getBoundingBox( const RadarTarget& tracked_target, const std::vector<RadarTarget>& targets )
+  {
+    // Find the bounding box dimensions:
+    Eigen::Vector3d min_point = Eigen::Vector3d( std::numeric_limits<double>::infinity(),
+						 std::numeric_limits<double>::infinity(),
+						 std::numeric_limits<double>::infinity() );
+    Eigen::Vector3d max_point = Eigen::Vector3d( -std::numeric_limits<double>::infinity(),
+						 -std::numeric_limits<double>::infinity(),
+						 -std::numeric_limits<double>::infinity() );    
+    if( targets.size() == 0 )
+      {
+	min_point = max_point = radarTargetToPoint( tracked_target );
+      }
+    else
+      {
+	for( const auto& t : targets )
+	  {
+	    min_point = min_point.cwiseMin( radarTargetToPoint( t ) );
+	    max_point = max_point.cwiseMax( radarTargetToPoint( t ) );
+	  }
+      }
+    
+    // Check for the case in which the box is degenerative:
+    if( ( max_point - min_point ).norm() < 1e-6 )
+      {
+	min_point -= 0.1 * Eigen::Vector3d::Ones();
+	max_point += 0.1 * Eigen::Vector3d::Ones();
+      }
+    
+    // Compute box pose (identity orientation, geometric center is position):
+    Eigen::Affine3d box_pose;
+    box_pose.linear() = Eigen::Matrix3d::Identity();
+    box_pose.translation() = min_point + ( 0.5 * ( max_point - min_point ) );
+
+    // Boxes are flat, with the height of a single detection:
+    Eigen::Vector3d dimensions( max_point.x() - min_point.x(),
+				max_point.y() - min_point.y(),
+				0.1 );
+
+    return BoundingBox( box_pose, dimensions );
+  }
+    
+} // namespace ainstein_radar_core
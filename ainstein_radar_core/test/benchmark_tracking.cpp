@@ -0,0 +1,160 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Times the tracking hot paths against the per-filter and per-target code they replace:
+// processing the filter bank against one RadarTargetKF per target, and gating a block of
+// measurements against an inverse per target.
+//
+// usage: benchmark_tracking [num_filters] [num_targets] [num_frames]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "ainstein_radar_core/measurement_gate.h"
+#include "ainstein_radar_core/radar_target_kf_bank.h"
+#include "ainstein_radar_core/tracking_filter.h"
+
+using namespace ainstein_radar_core;
+
+namespace
+{
+  typedef std::chrono::steady_clock Clock;
+
+  double elapsedUs( const Clock::time_point& start )
+  {
+    return std::chrono::duration<double, std::micro>( Clock::now() - start ).count();
+  }
+}
+
+int main( int argc, char** argv )
+{
+  const int num_filters = ( argc > 1 ? std::atoi( argv[1] ) : 1000 );
+  const int num_targets = ( argc > 2 ? std::atoi( argv[2] ) : 300 );
+  const int num_frames = ( argc > 3 ? std::atoi( argv[3] ) : 100 );
+
+  std::mt19937 rng( 1 );
+  std::uniform_real_distribution<double> u( -10.0, 10.0 );
+
+  // Process model over all filters:
+  const RadarTargetKF::Models models;
+  std::vector<RadarTargetKF> kfs;
+  RadarTargetKFBank bank;
+  for( int i = 0; i < num_filters; ++i )
+    {
+      double r = u( rng ), s = u( rng ), a = u( rng ), e = u( rng );
+      kfs.emplace_back( r, s, a, e, models );
+      bank.add( r, s, a, e, 0.0 );
+    }
+
+  double kf_us = 0.0, bank_us = 0.0;
+  for( int f = 0; f < num_frames; ++f )
+    {
+      Clock::time_point start = Clock::now();
+      for( RadarTargetKF& kf : kfs )
+	{
+	  kf.process( models, 0.1 );
+	}
+      kf_us += elapsedUs( start );
+
+      start = Clock::now();
+      bank.process( 0.1 );
+      bank_us += elapsedUs( start );
+    }
+
+  // Gating every target against every filter:
+  MeasurementGate::MeasurementBlock meas( 4, num_targets );
+  for( int k = 0; k < meas.size(); ++k )
+    {
+      meas( k ) = u( rng );
+    }
+  Eigen::RowVectorXd dist( num_targets );
+  MeasurementGate gate;
+  const int num_gated = std::min( num_filters, 100 );
+
+  double inverse_us = 0.0, gate_us = 0.0, checksum = 0.0;
+  for( int f = 0; f < num_frames; ++f )
+    {
+      Clock::time_point start = Clock::now();
+      for( int i = 0; i < num_gated; ++i )
+	{
+	  const Eigen::Vector4d pred_meas = bank.computePredMeas( i );
+	  const Eigen::Matrix4d meas_cov = bank.computeMeasCov( i );
+	  for( int j = 0; j < num_targets; ++j )
+	    {
+	      const Eigen::Vector4d innov = meas.col( j ) - pred_meas;
+	      checksum += innov.transpose() * meas_cov.inverse() * innov;
+	    }
+	}
+      inverse_us += elapsedUs( start );
+
+      start = Clock::now();
+      for( int i = 0; i < num_gated; ++i )
+	{
+	  gate.set( bank.computePredMeas( i ), bank.computeMeasCov( i ) );
+	  gate.computeDistances( meas, dist );
+	  checksum -= dist.sum();
+	}
+      gate_us += elapsedUs( start );
+    }
+
+  // Whole event-driven tracker frames:
+  TrackingFilter tracker;
+  TrackingFilter::FilterParameters params;
+  params.filter_process_rate = 10.0;
+  params.filter_min_time = 0.5;
+  params.filter_timeout = 0.5;
+  params.filter_val_gate_thresh = 5.0;
+  tracker.setFilterParameters( params );
+
+  std::uniform_real_distribution<double> range( 1.0, 100.0 );
+  std::uniform_real_distribution<double> azimuth( -60.0, 60.0 );
+  std::vector<RadarTarget> targets( num_targets );
+  for( int j = 0; j < num_targets; ++j )
+    {
+      targets[j] = RadarTarget( j, range( rng ), u( rng ), azimuth( rng ), 0.0, 10.0 );
+    }
+  Clock::time_point start = Clock::now();
+  for( int f = 0; f < num_frames; ++f )
+    {
+      for( RadarTarget& t : targets )
+	{
+	  t.range += 0.1 * t.speed;
+	}
+      tracker.updateFilters( targets, 0.1 * f );
+    }
+  const double tracker_us = elapsedUs( start );
+
+  std::printf( "process %d filters: RadarTargetKF %.1f us, bank %.1f us per frame\n",
+	       num_filters, kf_us / num_frames, bank_us / num_frames );
+  std::printf( "gate %d targets x %d filters: inverse %.1f us, MeasurementGate %.1f us per frame (diff %.3g)\n",
+	       num_targets, num_gated, inverse_us / num_frames, gate_us / num_frames, checksum );
+  std::printf( "event-driven tracker, %d targets: %.1f us per frame\n",
+	       num_targets, tracker_us / num_frames );
+  return 0;
+}
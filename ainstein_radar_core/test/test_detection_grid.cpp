@@ -0,0 +1,162 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ainstein_radar_core/detection_grid.h"
+
+using namespace ainstein_radar_core;
+
+namespace
+{
+  // Query random boxes, checking each result against every point:
+  template <int Dim>
+  void checkAgainstBruteForce( int num_points, double extent, const Eigen::Matrix<double, Dim, 1>& cell_size,
+			       unsigned int seed )
+  {
+    typedef Eigen::Matrix<double, Dim, 1> Point;
+    std::mt19937 rng( seed );
+    std::uniform_real_distribution<double> coord( -extent, extent );
+    std::uniform_real_distribution<double> half_size( 0.0, 4.0 * cell_size.maxCoeff() );
+
+    Eigen::Matrix<double, Dim, Eigen::Dynamic> points( Dim, num_points );
+    for( int j = 0; j < num_points; ++j )
+      {
+	for( int d = 0; d < Dim; ++d )
+	  {
+	    points( d, j ) = coord( rng );
+	  }
+      }
+
+    DetectionGrid<Dim> grid( cell_size );
+    grid.build( points );
+
+    int num_checked = 0;
+    std::vector<int> indices;
+    for( int q = 0; q < 500; ++q )
+      {
+	Point center, half;
+	for( int d = 0; d < Dim; ++d )
+	  {
+	    center( d ) = coord( rng );
+	    half( d ) = half_size( rng );
+	  }
+	const Point min = center - half;
+	const Point max = center + half;
+	if( !grid.query( min, max, indices ) )
+	  {
+	    continue;
+	  }
+	++num_checked;
+
+	EXPECT_TRUE( std::is_sorted( indices.begin(), indices.end() ) );
+	EXPECT_TRUE( std::adjacent_find( indices.begin(), indices.end() ) == indices.end() );
+	for( int j : indices )
+	  {
+	    ASSERT_GE( j, 0 );
+	    ASSERT_LT( j, num_points );
+	  }
+
+	// Candidates may include extra points, but never miss one in the box:
+	for( int j = 0; j < num_points; ++j )
+	  {
+	    const bool in_box = ( ( points.col( j ).array() >= min.array() ).all() &&
+				  ( points.col( j ).array() <= max.array() ).all() );
+	    if( in_box )
+	      {
+		EXPECT_TRUE( std::binary_search( indices.begin(), indices.end(), j ) ) << "missed point " << j;
+	      }
+	  }
+      }
+    EXPECT_GT( num_checked, 0 );
+  }
+}
+
+TEST( DetectionGrid, MatchesBruteForce2D )
+{
+  checkAgainstBruteForce<2>( 300, 100.0, Eigen::Vector2d( 2.0, 5.0 ), 1 );
+}
+
+TEST( DetectionGrid, MatchesBruteForce3D )
+{
+  checkAgainstBruteForce<3>( 1000, 50.0, Eigen::Vector3d::Constant( 2.0 ), 2 );
+}
+
+TEST( DetectionGrid, MatchesBruteForceWithCollisions )
+{
+  // Few points over a wide area, so most cells share buckets:
+  checkAgainstBruteForce<2>( 5, 1000.0, Eigen::Vector2d( 1.0, 1.0 ), 3 );
+}
+
+TEST( DetectionGrid, RefusesLargeBoxes )
+{
+  Eigen::Matrix<double, 2, Eigen::Dynamic> points( 2, 4 );
+  points << 0.0, 1.0, 2.0, 3.0,
+    0.0, 1.0, 2.0, 3.0;
+  DetectionGrid<2> grid( Eigen::Vector2d( 1.0, 1.0 ) );
+  grid.build( points );
+
+  std::vector<int> indices;
+  EXPECT_TRUE( grid.query( Eigen::Vector2d( 0.5, 0.5 ), Eigen::Vector2d( 1.5, 1.5 ), indices ) );
+  EXPECT_FALSE( grid.query( Eigen::Vector2d( 0.0, 0.0 ), Eigen::Vector2d( 10.0, 10.0 ), indices ) );
+
+  const double inf = std::numeric_limits<double>::infinity();
+  EXPECT_FALSE( grid.query( Eigen::Vector2d( -inf, 0.0 ), Eigen::Vector2d( inf, 1.0 ), indices ) );
+  EXPECT_FALSE( grid.query( Eigen::Vector2d( 1.0, 1.0 ), Eigen::Vector2d( 0.0, 0.0 ), indices ) );
+}
+
+TEST( DetectionGrid, SkipsNonFinitePoints )
+{
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const double inf = std::numeric_limits<double>::infinity();
+  Eigen::Matrix<double, 2, Eigen::Dynamic> points( 2, 5 );
+  points << 0.5, nan, 1.5, inf, 1e300,
+    0.5, 0.5, 0.5, 0.5, 0.5;
+  DetectionGrid<2> grid( Eigen::Vector2d( 1.0, 1.0 ) );
+  grid.build( points );
+
+  // Only the finite points are found, the others are in no cell:
+  std::vector<int> indices;
+  ASSERT_TRUE( grid.query( Eigen::Vector2d( 0.0, 0.0 ), Eigen::Vector2d( 1.9, 0.9 ), indices ) );
+  EXPECT_EQ( std::vector<int>( { 0, 2 } ), indices );
+
+  EXPECT_FALSE( grid.query( Eigen::Vector2d( nan, 0.0 ), Eigen::Vector2d( 1.0, 1.0 ), indices ) );
+  EXPECT_FALSE( grid.query( Eigen::Vector2d( 1e300, 0.0 ), Eigen::Vector2d( 1e300, 1.0 ), indices ) );
+}
+
+TEST( DetectionGrid, EmptyGrid )
+{
+  DetectionGrid<2> grid( Eigen::Vector2d( 1.0, 1.0 ) );
+  grid.build( Eigen::Matrix<double, 2, Eigen::Dynamic>( 2, 0 ) );
+
+  std::vector<int> indices;
+  EXPECT_FALSE( grid.query( Eigen::Vector2d( 0.0, 0.0 ), Eigen::Vector2d( 0.5, 0.5 ), indices ) );
+}
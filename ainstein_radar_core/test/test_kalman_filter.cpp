@@ -0,0 +1,129 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "ainstein_radar_core/kalman_filter.h"
+#include "ainstein_radar_core/kalman_filter_models.h"
+#include "ainstein_radar_core/radar_target_cartesian_kf.h"
+
+using namespace ainstein_radar_core;
+
+TEST( KalmanFilter, MatchesTextbookEquations )
+{
+  typedef KalmanFilter<RangeRateMotionModel, DirectMeasurementModel<4>> Filter;
+  const RangeRateMotionModel motion_model( Eigen::Vector3d( 1.0, 4.0, 4.0 ) );
+  const DirectMeasurementModel<4> meas_model( Eigen::Vector4d( 0.25, 0.25, 4.0, 4.0 ) );
+
+  Eigen::Vector4d x( 10.0, 1.0, 5.0, 0.0 );
+  Eigen::Matrix4d P = Eigen::Vector4d( 1.0, 4.0, 25.0, 25.0 ).asDiagonal();
+  Filter kf( x, P );
+
+  std::mt19937 rng( 1 );
+  std::normal_distribution<double> noise( 0.0, 0.5 );
+  const double dt = 0.1;
+  for( int f = 0; f < 50; ++f )
+    {
+      // x = F * x, P = F * P * F^T + Q:
+      const Eigen::Matrix4d F = motion_model.transition( dt );
+      x = F * x;
+      P = F * P * F.transpose() + motion_model.processNoise( dt );
+      kf.process( motion_model, dt );
+
+      // K = P * H^T * S^-1 with H = I:
+      const Eigen::Vector4d z = x + Eigen::Vector4d( noise( rng ), noise( rng ), noise( rng ), noise( rng ) );
+      const Eigen::Matrix4d S = P + meas_model.noise();
+      const Eigen::Matrix4d K = P * S.inverse();
+      x += K * ( z - x );
+      P = ( Eigen::Matrix4d::Identity() - K ) * P;
+      kf.update( meas_model, z );
+
+      ASSERT_LT( ( kf.getState() - x ).cwiseAbs().maxCoeff(), 1e-9 );
+      ASSERT_LT( ( kf.getCovariance() - P ).cwiseAbs().maxCoeff(), 1e-9 );
+    }
+}
+
+TEST( KalmanFilter, MotionModelsPropagateState )
+{
+  // Constant velocity on the ground plane:
+  Eigen::Vector4d cv_state( 1.0, 2.0, 3.0, -1.0 );
+  cv_state = ConstantVelocityMotionModel<2>( 1.0 ).transition( 0.5 ) * cv_state;
+  EXPECT_TRUE( cv_state.isApprox( Eigen::Vector4d( 2.5, 1.5, 3.0, -1.0 ) ) );
+
+  // Constant acceleration in 3D, with noise only on the acceleration:
+  Eigen::Matrix<double, 9, 1> ca_state;
+  ca_state << 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 2.0, 0.0, -2.0;
+  const ConstantAccelerationMotionModel<3> ca( 3.0 );
+  ca_state = ca.transition( 2.0 ) * ca_state;
+  Eigen::Matrix<double, 9, 1> expected;
+  expected << 6.0, 0.0, -4.0, 5.0, 0.0, -4.0, 2.0, 0.0, -2.0;
+  EXPECT_TRUE( ca_state.isApprox( expected ) );
+
+  const Eigen::Matrix<double, 9, 9> Q = ca.processNoise( 2.0 );
+  EXPECT_DOUBLE_EQ( Q.trace(), 3.0 * 6.0 );
+  EXPECT_DOUBLE_EQ( Q.bottomRightCorner( 3, 3 ).trace(), 3.0 * 6.0 );
+}
+
+TEST( KalmanFilter, RadialSpeedJacobianMatchesFiniteDifferences )
+{
+  typedef RadialSpeedPositionMeasurementModel<3> Model;
+  const Model model( 1.0, 0.01 );
+
+  Model::StateVector state;
+  state << 10.0, -4.0, 2.0, 1.5, 3.0, -0.5;
+  const Model::MeasJacobian H = model.jacobian( state );
+
+  const double h = 1e-6;
+  for( int k = 0; k < Model::state_dim; ++k )
+    {
+      Model::StateVector plus = state, minus = state;
+      plus( k ) += h;
+      minus( k ) -= h;
+      const Model::MeasVector column = ( model.predict( plus ) - model.predict( minus ) ) / ( 2.0 * h );
+      EXPECT_LT( ( H.col( k ) - column ).cwiseAbs().maxCoeff(), 1e-6 ) << "state element " << k;
+    }
+}
+
+TEST( RadarTargetCartesianKF, ModelsComeFromParameters )
+{
+  RadarTargetCartesianKF::FilterParameters params;
+  params.init_pos_stdev = 2.0;
+  params.init_vel_stdev = 3.0;
+  const RadarTargetCartesianKF::Models models( params );
+  const RadarTargetCartesianKF::Models defaults;
+
+  const RadarTarget target( 0, 10.0, 1.0, 0.0, 0.0, 10.0 );
+  const RadarTargetCartesianKF kf( target, 0.0, models );
+  const RadarTargetCartesianKF kf_defaults( target, 0.0, defaults );
+
+  const Eigen::Matrix<double, 6, 1> var = kf.getState().cov.diagonal();
+  EXPECT_DOUBLE_EQ( var( 0 ), 4.0 );
+  EXPECT_DOUBLE_EQ( var( 3 ), 9.0 );
+  EXPECT_DOUBLE_EQ( kf_defaults.getState().cov( 0, 0 ), INIT_POS_STDEV * INIT_POS_STDEV );
+  EXPECT_TRUE( kf.getState().pos.isApprox( Eigen::Vector3d( 10.0, 0.0, 0.0 ) ) );
+}
@@ -0,0 +1,72 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "ainstein_radar_core/measurement_gate.h"
+
+using namespace ainstein_radar_core;
+
+TEST( MeasurementGate, MatchesMahalanobisDistance )
+{
+  std::mt19937 rng( 1 );
+  std::normal_distribution<double> normal( 0.0, 5.0 );
+
+  MeasurementGate gate;
+  for( int trial = 0; trial < 20; ++trial )
+    {
+      // Random positive definite innovation covariance:
+      Eigen::Matrix4d A;
+      for( int k = 0; k < 16; ++k )
+	{
+	  A( k ) = normal( rng );
+	}
+      const Eigen::Matrix4d meas_cov = A * A.transpose() + Eigen::Matrix4d::Identity();
+      const Eigen::Vector4d pred_meas( normal( rng ), normal( rng ), normal( rng ), normal( rng ) );
+
+      // Blocks of different sizes reuse the gate's workspace:
+      const int num_meas = 1 + trial * 7;
+      MeasurementGate::MeasurementBlock meas( 4, num_meas );
+      for( int k = 0; k < meas.size(); ++k )
+	{
+	  meas( k ) = normal( rng );
+	}
+
+      Eigen::RowVectorXd dist( num_meas );
+      gate.set( pred_meas, meas_cov );
+      gate.computeDistances( meas, dist );
+
+      const Eigen::Matrix4d meas_cov_inv = meas_cov.inverse();
+      for( int j = 0; j < num_meas; ++j )
+	{
+	  const Eigen::Vector4d innov = meas.col( j ) - pred_meas;
+	  const double expected = innov.transpose() * meas_cov_inv * innov;
+	  EXPECT_NEAR( dist( j ), expected, 1e-9 * ( 1.0 + expected ) );
+	}
+    }
+}
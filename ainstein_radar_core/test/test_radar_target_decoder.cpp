@@ -0,0 +1,240 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ainstein_radar_core/radar_target_decoder.h"
+
+using namespace ainstein_radar_core;
+
+namespace
+{
+  // Pack one 8-byte target record as the radars send it:
+  void appendRecord( std::vector<char>& data, uint16_t azimuth, uint8_t range, uint8_t speed,
+		     uint16_t elevation, uint16_t snr )
+  {
+    const uint8_t record[8] = { static_cast<uint8_t>( azimuth & 0xFF ), static_cast<uint8_t>( azimuth >> 8 ),
+				range, speed,
+				static_cast<uint8_t>( elevation & 0xFF ), static_cast<uint8_t>( elevation >> 8 ),
+				static_cast<uint8_t>( snr & 0xFF ), static_cast<uint8_t>( snr >> 8 ) };
+    data.insert( data.end(), record, record + 8 );
+  }
+
+  std::vector<char> randomRecords( int num_records, unsigned int seed )
+  {
+    std::mt19937 rng( seed );
+    std::uniform_int_distribution<int> byte( 0, 255 );
+    std::vector<char> data( 8 * num_records );
+    for( char& c : data )
+      {
+	c = static_cast<char>( byte( rng ) );
+      }
+    return data;
+  }
+
+  // Collects what decodeRows passes to its sink:
+  class FrameRowSink
+  {
+  public:
+    void set( int k, uint16_t id, float range, float speed, float azimuth, float elevation, float snr )
+    {
+      frame.resize( k + 1 );
+      frame.id[k] = id;
+      frame.range[k] = range;
+      frame.speed[k] = speed;
+      frame.azimuth[k] = azimuth;
+      frame.elevation[k] = elevation;
+      frame.snr[k] = snr;
+    }
+
+    RadarTargetFrame frame;
+  };
+
+  void expectSameFrame( const RadarTargetFrame& a, const RadarTargetFrame& b )
+  {
+    ASSERT_EQ( a.size(), b.size() );
+    for( std::size_t i = 0; i < a.size(); ++i )
+      {
+	EXPECT_EQ( a.id[i], b.id[i] );
+	EXPECT_FLOAT_EQ( a.range[i], b.range[i] );
+	EXPECT_FLOAT_EQ( a.speed[i], b.speed[i] );
+	EXPECT_FLOAT_EQ( a.azimuth[i], b.azimuth[i] );
+	EXPECT_FLOAT_EQ( a.elevation[i], b.elevation[i] );
+	EXPECT_FLOAT_EQ( a.snr[i], b.snr[i] );
+      }
+  }
+}
+
+TEST( RadarTargetDecoder, DecodesO79Records )
+{
+  std::vector<char> data;
+  appendRecord( data, static_cast<uint16_t>( -5 ), 10, 10, 3, 1234 );
+  appendRecord( data, 7, 200, 100, static_cast<uint16_t>( -2 ), 65535 );
+
+  RadarTargetFrame frame;
+  RadarTargetDecoder( RadarTargetDecoder::format_o79 ).decode( data.data(), 2, 3, frame );
+
+  ASSERT_EQ( frame.size(), 2u );
+  EXPECT_EQ( frame.id[0], 3 );
+  EXPECT_FLOAT_EQ( frame.range[0], 1.16f );
+  EXPECT_FLOAT_EQ( frame.speed[0], 0.45f );
+  EXPECT_FLOAT_EQ( frame.azimuth[0], -5.0f );
+  EXPECT_FLOAT_EQ( frame.elevation[0], 3.0f );
+  EXPECT_FLOAT_EQ( frame.snr[0], 1234.0f );
+
+  // Speeds above 64 are moving towards the radar:
+  EXPECT_EQ( frame.id[1], 4 );
+  EXPECT_FLOAT_EQ( frame.range[1], 23.2f );
+  EXPECT_FLOAT_EQ( frame.speed[1], -1.215f );
+  EXPECT_FLOAT_EQ( frame.azimuth[1], 7.0f );
+  EXPECT_FLOAT_EQ( frame.elevation[1], -2.0f );
+  EXPECT_FLOAT_EQ( frame.snr[1], 65535.0f );
+}
+
+TEST( RadarTargetDecoder, DecodesK79Records )
+{
+  std::vector<char> data;
+  appendRecord( data, 30, 10, 64, 1000, 50 );
+
+  RadarTargetFrame frame;
+  RadarTargetDecoder( RadarTargetDecoder::format_k79 ).decode( data.data(), 1, 0, frame );
+
+  // Unsigned azimuth with a 90 deg offset, and no elevation:
+  ASSERT_EQ( frame.size(), 1u );
+  EXPECT_FLOAT_EQ( frame.range[0], 1.16f );
+  EXPECT_FLOAT_EQ( frame.speed[0], 2.88f );
+  EXPECT_FLOAT_EQ( frame.azimuth[0], 60.0f );
+  EXPECT_FLOAT_EQ( frame.elevation[0], 0.0f );
+  EXPECT_FLOAT_EQ( frame.snr[0], 50.0f );
+}
+
+TEST( RadarTargetDecoder, DecodesK793DRecords )
+{
+  std::vector<char> data;
+  appendRecord( data, 100, 10, 0, 905, 50 );
+
+  RadarTargetFrame frame;
+  RadarTargetDecoder( RadarTargetDecoder::format_k79_3d ).decode( data.data(), 1, 0, frame );
+
+  // 0.1 m range counts and 0.1 deg elevation with a 90 deg offset:
+  ASSERT_EQ( frame.size(), 1u );
+  EXPECT_FLOAT_EQ( frame.range[0], 1.0f );
+  EXPECT_FLOAT_EQ( frame.azimuth[0], -10.0f );
+  EXPECT_FLOAT_EQ( frame.elevation[0], 0.5f );
+}
+
+TEST( RadarTargetDecoder, BlockDecodeMatchesRowDecode )
+{
+  // Odd record counts exercise both the four-at-a-time loop and the remainder:
+  const RadarTargetDecoder::Format formats[3] = { RadarTargetDecoder::format_o79,
+						  RadarTargetDecoder::format_k79,
+						  RadarTargetDecoder::format_k79_3d };
+  for( const RadarTargetDecoder::Format& format : formats )
+    {
+      RadarTargetDecoder decoder( format );
+      for( int num_records : { 0, 1, 3, 4, 5, 17, 1000 } )
+	{
+	  std::vector<char> data = randomRecords( num_records, num_records );
+
+	  RadarTargetFrame frame;
+	  decoder.decode( data.data(), num_records, 100, frame );
+	  FrameRowSink rows;
+	  EXPECT_EQ( decoder.decodeRows( data.data(), num_records, 100, rows ), num_records );
+	  expectSameFrame( frame, rows.frame );
+	}
+    }
+}
+
+TEST( RadarTargetDecoder, DecodeAppendsToFrame )
+{
+  std::vector<char> data = randomRecords( 6, 2 );
+  RadarTargetDecoder decoder( RadarTargetDecoder::format_o79 );
+
+  RadarTargetFrame first, both;
+  decoder.decode( data.data(), 6, 0, first );
+  decoder.decode( data.data(), 6, 0, both );
+  decoder.decode( data.data(), 6, 0, both );
+
+  ASSERT_EQ( both.size(), 12u );
+  for( std::size_t i = 0; i < 6; ++i )
+    {
+      EXPECT_EQ( both.id[6 + i], first.id[i] );
+      EXPECT_FLOAT_EQ( both.range[6 + i], first.range[i] );
+      EXPECT_FLOAT_EQ( both.azimuth[6 + i], first.azimuth[i] );
+      EXPECT_FLOAT_EQ( both.snr[6 + i], first.snr[i] );
+    }
+}
+
+TEST( RadarTargetDecoder, GateMatchesDecodedValues )
+{
+  RadarTargetGate gate;
+  gate.range = { 1.0, 20.0 };
+  gate.speed = { -2.0, 1.5 };
+  gate.azimuth = { -20.5, 15.5 };
+  gate.elevation = { -30.5, 40.5 };
+  gate.snr = { 100.0, 60000.0 };
+
+  const RadarTargetDecoder::Format formats[3] = { RadarTargetDecoder::format_o79,
+						  RadarTargetDecoder::format_k79,
+						  RadarTargetDecoder::format_k79_3d };
+  const int num_records = 20000;
+  std::vector<char> data = randomRecords( num_records, 1 );
+  for( const RadarTargetDecoder::Format& format : formats )
+    {
+      // Decode everything, then keep what the gate accepts:
+      RadarTargetDecoder decoder( format );
+      RadarTargetFrame all;
+      decoder.decode( data.data(), num_records, 0, all );
+      RadarTargetFrame expected;
+      for( std::size_t i = 0; i < all.size(); ++i )
+	{
+	  if( gate.accepts( all.range[i], all.speed[i], all.azimuth[i], all.elevation[i], all.snr[i] ) )
+	    {
+	      expected.resize( expected.size() + 1 );
+	      const std::size_t j = expected.size() - 1;
+	      expected.id[j] = all.id[i];
+	      expected.range[j] = all.range[i];
+	      expected.speed[j] = all.speed[i];
+	      expected.azimuth[j] = all.azimuth[i];
+	      expected.elevation[j] = all.elevation[i];
+	      expected.snr[j] = all.snr[i];
+	    }
+	}
+
+      decoder.setGate( gate );
+      RadarTargetFrame gated;
+      decoder.decode( data.data(), num_records, 0, gated );
+      expectSameFrame( gated, expected );
+
+      FrameRowSink rows;
+      EXPECT_EQ( decoder.decodeRows( data.data(), num_records, 0, rows ), static_cast<int>( expected.size() ) );
+      expectSameFrame( rows.frame, expected );
+    }
+}
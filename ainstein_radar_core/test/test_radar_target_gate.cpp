@@ -0,0 +1,122 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cstdint>
+#include <limits>
+
+#include <gtest/gtest.h>
+
+#include "ainstein_radar_core/radar_target_gate.h"
+
+using namespace ainstein_radar_core;
+
+namespace
+{
+  const double inf = std::numeric_limits<double>::infinity();
+
+  // Every raw value in [lo, hi] is in the window, and the neighbours just outside are not:
+  void expectRaw( const RadarTargetGate::RawWindow& raw, int64_t lo, int64_t hi )
+  {
+    EXPECT_EQ( raw.min, lo );
+    EXPECT_EQ( raw.max, hi );
+    EXPECT_FALSE( raw.contains( lo - 1 ) );
+    EXPECT_FALSE( raw.contains( hi + 1 ) );
+  }
+}
+
+TEST( RadarTargetGate, DefaultGateIsOpen )
+{
+  RadarTargetGate gate;
+  EXPECT_TRUE( gate.isOpen() );
+  EXPECT_TRUE( gate.accepts( 1e9, -1e9, 180.0, -90.0, 0.0 ) );
+
+  gate.snr.min = 10.0;
+  EXPECT_FALSE( gate.isOpen() );
+  EXPECT_FALSE( gate.accepts( 1.0, 0.0, 0.0, 0.0, 9.0 ) );
+}
+
+TEST( RadarTargetGate, ToRawRoundsInwards )
+{
+  const RadarTargetGate::Window window = { -2.5, 3.5 };
+  expectRaw( RadarTargetGate::toRaw( window, 1.0, 0.0 ), -2, 3 );
+}
+
+TEST( RadarTargetGate, ToRawKeepsExactBounds )
+{
+  // Decoded values 2.0 and 4.0 are raw 2 and 6, which are inside the closed window:
+  const RadarTargetGate::Window window = { 2.0, 4.0 };
+  expectRaw( RadarTargetGate::toRaw( window, 0.5, 1.0 ), 2, 6 );
+}
+
+TEST( RadarTargetGate, ToRawSwapsBoundsForNegativeScale )
+{
+  // K79 azimuth: value = 90 - raw:
+  const RadarTargetGate::Window window = { -10.0, 20.0 };
+  expectRaw( RadarTargetGate::toRaw( window, -1.0, 90.0 ), 70, 100 );
+}
+
+TEST( RadarTargetGate, ToRawClampsUnboundedWindows )
+{
+  const RadarTargetGate::Window open = { -inf, inf };
+  RadarTargetGate::RawWindow raw = RadarTargetGate::toRaw( open, 0.01, 0.0 );
+  EXPECT_TRUE( raw.contains( std::numeric_limits<int32_t>::min() ) );
+  EXPECT_TRUE( raw.contains( std::numeric_limits<uint32_t>::max() ) );
+
+  const RadarTargetGate::Window above = { 5.0, inf };
+  raw = RadarTargetGate::toRaw( above, -1.0, 0.0 );
+  EXPECT_EQ( raw.max, -5 );
+  EXPECT_TRUE( raw.contains( std::numeric_limits<int32_t>::min() ) );
+  EXPECT_FALSE( raw.contains( -4 ) );
+}
+
+TEST( RadarTargetGate, ToRawOfUnsentField )
+{
+  // A zero scale always decodes to the offset, so the window takes everything or nothing:
+  const RadarTargetGate::Window window = { -1.0, 1.0 };
+  RadarTargetGate::RawWindow raw = RadarTargetGate::toRaw( window, 0.0, 0.0 );
+  EXPECT_TRUE( raw.contains( 0 ) );
+  EXPECT_TRUE( raw.contains( 65535 ) );
+
+  raw = RadarTargetGate::toRaw( window, 0.0, 90.0 );
+  EXPECT_FALSE( raw.contains( 0 ) );
+  EXPECT_FALSE( raw.contains( 90 ) );
+}
+
+TEST( RadarTargetGate, ToRawOfEmptyWindow )
+{
+  // No raw value between the bounds:
+  const RadarTargetGate::Window narrow = { 0.2, 0.8 };
+  RadarTargetGate::RawWindow raw = RadarTargetGate::toRaw( narrow, 1.0, 0.0 );
+  EXPECT_FALSE( raw.contains( 0 ) );
+  EXPECT_FALSE( raw.contains( 1 ) );
+
+  const RadarTargetGate::Window inverted = { 5.0, -5.0 };
+  raw = RadarTargetGate::toRaw( inverted, 1.0, 0.0 );
+  for( int64_t r = -6; r <= 6; ++r )
+    {
+      EXPECT_FALSE( raw.contains( r ) );
+    }
+}
@@ -0,0 +1,155 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ainstein_radar_core/radar_target_kf_bank.h"
+
+using namespace ainstein_radar_core;
+
+namespace
+{
+  RadarTargetKF::FilterParameters testParameters( void )
+  {
+    RadarTargetKF::FilterParameters params;
+    params.init_range_stdev = 1.0;
+    params.init_speed_stdev = 2.0;
+    params.init_azim_stdev = 5.0;
+    params.init_elev_stdev = 5.0;
+    params.q_speed_stdev = 1.0;
+    params.q_azim_stdev = 2.0;
+    params.q_elev_stdev = 2.0;
+    params.r_range_stdev = 0.5;
+    params.r_speed_stdev = 0.5;
+    params.r_azim_stdev = 2.0;
+    params.r_elev_stdev = 2.0;
+    return params;
+  }
+}
+
+TEST( RadarTargetKFBank, MatchesRadarTargetKF )
+{
+  const RadarTargetKF::FilterParameters params = testParameters();
+  const RadarTargetKF::Models models( params );
+  RadarTargetKFBank bank;
+  bank.setFilterParameters( params );
+
+  std::mt19937 rng( 3 );
+  std::uniform_real_distribution<double> u( -10.0, 10.0 );
+  std::vector<RadarTargetKF> kfs;
+  const int num_filters = 50;
+  for( int i = 0; i < num_filters; ++i )
+    {
+      double r = u( rng ), s = u( rng ), a = u( rng ), e = u( rng );
+      kfs.emplace_back( r, s, a, e, models );
+      bank.add( r, s, a, e, 0.0 );
+    }
+  ASSERT_EQ( bank.size(), num_filters );
+
+  // Process every filter each frame and update a third of them, with varying dt:
+  for( int f = 0; f < 100; ++f )
+    {
+      const double dt = 0.05 + 0.001 * f;
+      for( RadarTargetKF& kf : kfs )
+	{
+	  kf.process( models, dt );
+	}
+      bank.process( dt );
+
+      for( int i = f % 3; i < num_filters; i += 3 )
+	{
+	  double r = u( rng ), s = u( rng ), a = u( rng ), e = u( rng );
+	  kfs[i].update( models, r, s, a, e );
+	  bank.update( i, r, s, a, e, 0.1 * f );
+	}
+    }
+
+  for( int i = 0; i < num_filters; ++i )
+    {
+      const RadarTargetKF::FilterState state = kfs[i].getState();
+      EXPECT_LT( ( state.asVec() - bank.getState( i ) ).cwiseAbs().maxCoeff(), 1e-9 );
+      EXPECT_LT( ( state.cov - bank.getCovariance( i ) ).cwiseAbs().maxCoeff(), 1e-9 );
+      EXPECT_LT( ( kfs[i].computePredMeas( models ) - bank.computePredMeas( i ) ).cwiseAbs().maxCoeff(), 1e-9 );
+      EXPECT_LT( ( kfs[i].computeMeasCov( models ) - bank.computeMeasCov( i ) ).cwiseAbs().maxCoeff(), 1e-9 );
+    }
+}
+
+TEST( RadarTargetKFBank, StartsFromInitialCovariance )
+{
+  const RadarTargetKF::FilterParameters params = testParameters();
+  RadarTargetKFBank bank;
+  bank.setFilterParameters( params );
+  bank.add( 10.0, 1.0, 5.0, 0.0, 2.0 );
+
+  const Eigen::Matrix4d cov = bank.getCovariance( 0 );
+  EXPECT_EQ( cov, RadarTargetKF::Models( params ).P_init );
+  EXPECT_DOUBLE_EQ( bank.getTimeSinceStart( 0, 3.5 ), 1.5 );
+  EXPECT_DOUBLE_EQ( bank.getTimeSinceUpdate( 0, 3.5 ), 1.5 );
+
+  bank.update( 0, 10.1, 1.0, 5.0, 0.0, 3.0 );
+  EXPECT_DOUBLE_EQ( bank.getTimeSinceStart( 0, 3.5 ), 1.5 );
+  EXPECT_DOUBLE_EQ( bank.getTimeSinceUpdate( 0, 3.5 ), 0.5 );
+}
+
+TEST( RadarTargetKFBank, RemoveIfKeepsOrder )
+{
+  RadarTargetKFBank bank;
+  for( int i = 0; i < 40; ++i )
+    {
+      bank.add( i, 0.0, 0.0, 0.0, i );
+    }
+  bank.process( 0.1 );
+
+  bank.removeIf( []( int i ) { return ( i % 3 != 0 ); } );
+  ASSERT_EQ( bank.size(), 14 );
+  for( int i = 0; i < bank.size(); ++i )
+    {
+      EXPECT_DOUBLE_EQ( bank.getState( i )( 0 ), 3.0 * i );
+      EXPECT_DOUBLE_EQ( bank.getTimeSinceStart( i, 100.0 ), 100.0 - 3.0 * i );
+    }
+
+  // Filters added after removing go after the kept ones:
+  bank.add( -1.0, 0.0, 0.0, 0.0, 0.0 );
+  EXPECT_EQ( bank.size(), 15 );
+  EXPECT_DOUBLE_EQ( bank.getState( 14 )( 0 ), -1.0 );
+}
+
+TEST( RadarTargetKFBank, ParametersArePerBank )
+{
+  RadarTargetKF::FilterParameters params = testParameters();
+  RadarTargetKFBank a, b;
+  a.setFilterParameters( params );
+  params.init_range_stdev = 3.0;
+  b.setFilterParameters( params );
+
+  a.add( 1.0, 0.0, 0.0, 0.0, 0.0 );
+  b.add( 1.0, 0.0, 0.0, 0.0, 0.0 );
+  EXPECT_DOUBLE_EQ( a.getCovariance( 0 )( 0, 0 ), 1.0 );
+  EXPECT_DOUBLE_EQ( b.getCovariance( 0 )( 0, 0 ), 9.0 );
+}
@@ -0,0 +1,147 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ainstein_radar_core/tracking_filter.h"
+
+using namespace ainstein_radar_core;
+
+namespace
+{
+  TrackingFilter::FilterParameters testParameters( void )
+  {
+    TrackingFilter::FilterParameters params;
+    params.filter_process_rate = 10.0;
+    params.filter_min_time = 0.5;
+    params.filter_timeout = 0.5;
+    params.filter_val_gate_thresh = 5.0;
+    params.kf_params.init_range_stdev = 1.0;
+    params.kf_params.init_speed_stdev = 2.0;
+    params.kf_params.init_azim_stdev = 5.0;
+    params.kf_params.init_elev_stdev = 5.0;
+    params.kf_params.q_speed_stdev = 1.0;
+    params.kf_params.q_azim_stdev = 2.0;
+    params.kf_params.q_elev_stdev = 2.0;
+    params.kf_params.r_range_stdev = 0.5;
+    params.kf_params.r_speed_stdev = 0.5;
+    params.kf_params.r_azim_stdev = 2.0;
+    params.kf_params.r_elev_stdev = 2.0;
+    return params;
+  }
+
+  // Two targets at constant radial speed, one approaching and one moving away:
+  std::vector<RadarTarget> targetsAt( double t )
+  {
+    std::vector<RadarTarget> targets;
+    targets.emplace_back( 0, 10.0 + 2.0 * t, 2.0, 5.0, 0.0, 10.0 );
+    targets.emplace_back( 1, 30.0 - 1.0 * t, -1.0, -10.0, 0.0, 10.0 );
+    return targets;
+  }
+
+  bool byRange( const RadarTarget& a, const RadarTarget& b )
+  {
+    return ( a.range < b.range );
+  }
+}
+
+TEST( TrackingFilter, EventDrivenTracksTargets )
+{
+  TrackingFilter tracker;
+  tracker.setFilterParameters( testParameters() );
+
+  // Frames at 10 Hz on the caller's clock, no process thread:
+  const double t0 = 1000.0;
+  std::vector<RadarTarget> tracked;
+  for( int f = 0; f < 30; ++f )
+    {
+      const double t = 0.1 * f;
+      tracker.updateFilters( targetsAt( t ), t0 + t );
+
+      tracker.getTrackedObjects( tracked );
+      if( t < testParameters().filter_min_time )
+	{
+	  EXPECT_TRUE( tracked.empty() ) << "tracked before the minimum time at frame " << f;
+	}
+    }
+
+  tracker.getTrackedObjects( tracked );
+  ASSERT_EQ( tracked.size(), 2u );
+  std::sort( tracked.begin(), tracked.end(), byRange );
+  const std::vector<RadarTarget> truth = targetsAt( 2.9 );
+  EXPECT_NEAR( tracked[0].range, truth[0].range, 0.1 );
+  EXPECT_NEAR( tracked[0].speed, truth[0].speed, 0.1 );
+  EXPECT_NEAR( tracked[0].azimuth, truth[0].azimuth, 0.1 );
+  EXPECT_NEAR( tracked[1].range, truth[1].range, 0.1 );
+  EXPECT_NEAR( tracked[1].speed, truth[1].speed, 0.1 );
+  EXPECT_NEAR( tracked[1].azimuth, truth[1].azimuth, 0.1 );
+}
+
+TEST( TrackingFilter, EventDrivenDropsStaleFilters )
+{
+  TrackingFilter tracker;
+  tracker.setFilterParameters( testParameters() );
+
+  std::vector<RadarTarget> tracked;
+  for( int f = 0; f < 10; ++f )
+    {
+      tracker.updateFilters( targetsAt( 0.1 * f ), 0.1 * f );
+    }
+  tracker.getTrackedObjects( tracked );
+  EXPECT_EQ( tracked.size(), 2u );
+
+  // An empty frame after the timeout drops every filter:
+  tracker.updateFilters( std::vector<RadarTarget>(), 0.9 + 2.0 * testParameters().filter_timeout );
+  tracker.getTrackedObjects( tracked );
+  EXPECT_TRUE( tracked.empty() );
+}
+
+TEST( TrackingFilter, EventDrivenTakesLateFrames )
+{
+  TrackingFilter tracker;
+  tracker.setFilterParameters( testParameters() );
+
+  std::vector<RadarTarget> tracked;
+  for( int f = 0; f < 10; ++f )
+    {
+      tracker.updateFilters( targetsAt( 0.1 * f ), 0.1 * f );
+    }
+
+  // A frame stamped before the last one updates the filters without propagating them
+  // backwards, and the next frame propagates from the latest time:
+  tracker.updateFilters( targetsAt( 0.85 ), 0.85 );
+  tracker.updateFilters( targetsAt( 1.0 ), 1.0 );
+
+  tracker.getTrackedObjects( tracked );
+  ASSERT_EQ( tracked.size(), 2u );
+  std::sort( tracked.begin(), tracked.end(), byRange );
+  const std::vector<RadarTarget> truth = targetsAt( 1.0 );
+  EXPECT_NEAR( tracked[0].range, truth[0].range, 0.2 );
+  EXPECT_NEAR( tracked[1].range, truth[1].range, 0.2 );
+}
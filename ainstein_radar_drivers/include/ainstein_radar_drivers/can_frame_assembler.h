@@ -0,0 +1,234 @@
+#ifndef CAN_FRAME_ASSEMBLER_H_
+#define CAN_FRAME_ASSEMBLER_H_
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <ros/ros.h>
+#include <ainstein_radar_msgs/RadarTargetArray.h>
+#include <ainstein_radar_msgs/RadarAlarmArray.h>
+
+namespace ainstein_radar_drivers
+{
+  // The per-frame item list of each message assembled from CAN frames:
+  inline decltype( ainstein_radar_msgs::RadarTargetArray::targets )& frameItems( ainstein_radar_msgs::RadarTargetArray& msg )
+  {
+    return msg.targets;
+  }
+  inline decltype( ainstein_radar_msgs::RadarAlarmArray::alarms )& frameItems( ainstein_radar_msgs::RadarAlarmArray& msg )
+  {
+    return msg.alarms;
+  }
+
+  // Assembles a message from the start frame, item frames and stop frame a CAN radar
+  // sends per measurement cycle. Messages come from a small pool, each reserved to the
+  // radar's maximum number of items, and a finished message is handed out as const and
+  // never touched again. Once every subscriber has released it, it is reused, so the
+  // steady state neither allocates nor copies.
+  //
+  // A start frame arriving while a frame is open means the previous stop frame was lost
+  // or two frames interleaved; the partial frame is dropped. Items and stop frames
+  // outside a frame (typically when starting mid-frame) and items beyond the maximum are
+  // dropped and counted as well. A frame nobody is going to read can be tracked without
+  // being stored, which keeps the frame boundary checks but skips decoding its items.
+  template <typename msg_type>
+  class CanFrameAssembler
+  {
+  public:
+    typedef typename std::remove_reference<decltype( frameItems( std::declval<msg_type&>() ) )>::type::value_type item_type;
+
+    static const unsigned int pool_size = 4;
+
+    CanFrameAssembler( void ) :
+      capacity_( 0 ),
+      current_( 0 ),
+      next_( 0 ),
+      open_( false ),
+      keep_( false ),
+      num_frames_( 0 ),
+      num_incomplete_( 0 ),
+      num_orphaned_( 0 ),
+      num_overflowed_( 0 ),
+      frame_overflowed_( 0 )
+    {
+    }
+
+    // Set the frame ID and maximum number of items, (re)allocating the pool:
+    void configure( const std::string& frame_id, std::size_t capacity )
+    {
+      frame_id_ = frame_id;
+      capacity_ = capacity;
+      pool_.clear();
+      for( unsigned int i = 0; i < pool_size; ++i )
+	{
+	  pool_.push_back( newMessage() );
+	}
+      open_ = false;
+    }
+
+    // Start a new frame, stored only if keep is true, returning false if the previous
+    // one was never finished:
+    bool start( const ros::Time& stamp, bool keep = true )
+    {
+      bool complete = !open_;
+      if( open_ )
+	{
+	  ++num_incomplete_;
+	}
+
+      // An unfinished stored frame was never handed out, so its message can be reused:
+      if( keep && !( open_ && keep_ ) )
+	{
+	  current_ = acquire();
+	}
+
+      open_ = true;
+      keep_ = keep;
+      frame_overflowed_ = num_overflowed_;
+      if( keep_ )
+	{
+	  msg_type& msg = *pool_[current_];
+	  msg.header.stamp = stamp;
+	  frameItems( msg ).clear();
+	}
+
+      return complete;
+    }
+
+    // Append an item to the open frame, returning nullptr if it must be dropped or the
+    // frame is not stored:
+    item_type* add( void )
+    {
+      if( !open_ )
+	{
+	  ++num_orphaned_;
+	  return nullptr;
+	}
+      if( !keep_ )
+	{
+	  return nullptr;
+	}
+
+      auto& items = frameItems( *pool_[current_] );
+      if( items.size() >= capacity_ )
+	{
+	  ++num_overflowed_;
+	  return nullptr;
+	}
+
+      items.emplace_back();
+      return &items.back();
+    }
+
+    bool isOpen( void ) const
+    {
+      return open_;
+    }
+
+    std::size_t size( void ) const
+    {
+      return ( open_ && keep_ ) ? frameItems( *pool_[current_] ).size() : 0;
+    }
+
+    // Close the open frame and hand it out, or return nullptr if no frame was open or it
+    // was not stored:
+    boost::shared_ptr<const msg_type> finish( void )
+    {
+      if( !open_ )
+	{
+	  ++num_orphaned_;
+	  return boost::shared_ptr<const msg_type>();
+	}
+
+      open_ = false;
+      ++num_frames_;
+      if( !keep_ )
+	{
+	  return boost::shared_ptr<const msg_type>();
+	}
+      return pool_[current_];
+    }
+
+    // Frames completed, dropped as incomplete, and frames and items received outside a
+    // frame or beyond the maximum number of items:
+    uint64_t numFrames( void ) const
+    {
+      return num_frames_;
+    }
+    uint64_t numIncomplete( void ) const
+    {
+      return num_incomplete_;
+    }
+    uint64_t numOrphaned( void ) const
+    {
+      return num_orphaned_;
+    }
+    uint64_t numOverflowed( void ) const
+    {
+      return num_overflowed_;
+    }
+
+    // Items dropped beyond the maximum since the last frame started:
+    uint64_t numOverflowedInFrame( void ) const
+    {
+      return num_overflowed_ - frame_overflowed_;
+    }
+
+  private:
+    boost::shared_ptr<msg_type> newMessage( void )
+    {
+      boost::shared_ptr<msg_type> msg( new msg_type );
+      msg->header.frame_id = frame_id_;
+      frameItems( *msg ).reserve( capacity_ );
+      return msg;
+    }
+
+    // Find a pooled message no subscriber holds any more. Only the pool can hand out new
+    // references, so one found unshared stays unshared:
+    std::size_t acquire( void )
+    {
+      if( pool_.empty() )
+	{
+	  pool_.push_back( newMessage() );
+	}
+
+      for( std::size_t i = 0; i < pool_.size(); ++i )
+	{
+	  std::size_t ind = ( next_ + i ) % pool_.size();
+	  if( pool_[ind].use_count() == 1 )
+	    {
+	      next_ = ind + 1;
+	      return ind;
+	    }
+	}
+
+      // Every message is still held, so leave the oldest one to its subscribers:
+      std::size_t ind = next_ % pool_.size();
+      pool_[ind] = newMessage();
+      next_ = ind + 1;
+      return ind;
+    }
+
+    std::string frame_id_;
+    std::size_t capacity_;
+
+    std::vector<boost::shared_ptr<msg_type> > pool_;
+    std::size_t current_;
+    std::size_t next_;
+    bool open_;
+    bool keep_;
+
+    uint64_t num_frames_;
+    uint64_t num_incomplete_;
+    uint64_t num_orphaned_;
+    uint64_t num_overflowed_;
+    uint64_t frame_overflowed_;
+  };
+
+} // namespace ainstein_radar_drivers
+
+#endif // CAN_FRAME_ASSEMBLER_H_
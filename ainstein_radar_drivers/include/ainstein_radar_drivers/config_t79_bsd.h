@@ -1,8 +1,15 @@
 #ifndef CONFIG_T79_BSD_H_
 #define CONFIG_T79_BSD_H_
 
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include <ainstein_radar_core/can_protocol.h>
+
 namespace ainstein_radar_drivers
 {
+  namespace can_protocol = ainstein_radar_core::can_protocol;
   
 namespace ConfigT79BSD
 {
@@ -47,160 +54,47 @@ const int RADAR_SPEED_EFFECTIVE_POS = 0x01;
 const int RADAR_SET_DISABLE_BSD = 0x00;
 const int RADAR_SET_ENABLE_BSD = 0x01;
 
+// Most items sent per frame, which size the frame assemblers. Items beyond these are
+// dropped and reported when the frame is published:
+const int MAX_NUM_TARGETS = 64;
+const int MAX_NUM_ALARMS = 8;
+
+// Messages sent by the BSD firmware radars, indexing the message_ids table:
+enum MessageType
+{
+    UNKNOWN = 0,
+    HEARTBEAT_1,
+    HEARTBEAT_2,
+    START_STOP_RET,
+    START_FRAME,
+    STOP_FRAME,
+    RAW_TARGET,
+    TRACKED_TARGET,
+    BSD_ALARM,
+    N_MESSAGE_TYPES
+};
+
 // Message IDs specific to each type of BSD firmware radar:
- const std::map<RadarType, int> heartbeat_1 = {
-                                            {
-                                              KANZA,
-                                              0xDEAD },
-                                            {
-                                              TIPI_79_FL,
-                                              0x502 },
-                                            {
-                                              TIPI_79_FR,
-                                              0x503 },
-                                            {
-                                              TIPI_79_RL,
-                                              0x504 },
-                                            {
-                                              TIPI_79_RR,
-                                              0x505 } };
-
- const std::map<RadarType, int> heartbeat_2 = {
-                                            {
-                                              KANZA,
-                                              0xDEAD },
-                                            {
-                                              TIPI_79_FL,
-                                              0x503 },
-                                            {
-                                              TIPI_79_FR,
-                                              0x504 },
-                                            {
-                                              TIPI_79_RL,
-                                              0x505 },
-                                            {
-                                              TIPI_79_RR,
-                                              0x506 } };
-
- const std::map<RadarType, int> start_frame = {
-                                               {
-                                                 KANZA,
-                                                 0x420 },
-                                               {
-                                                 TIPI_79_FL,
-                                                 0x421 },
-                                               {
-                                                 TIPI_79_FR,
-                                                 0x422 },
-                                               {
-                                                 TIPI_79_RL,
-                                                 0x423 },
-                                               {
-                                                 TIPI_79_RR,
-                                                 0x424 } };
-
-const std::map<RadarType, int> stop_frame = {
-                                              {
-                                                KANZA,
-                                                0x480 },
-                                              {
-                                                TIPI_79_FL,
-                                                0x481 },
-                                              {
-                                                TIPI_79_FR,
-                                                0x482 },
-                                              {
-                                                TIPI_79_RL,
-                                                0x483 },
-                                              {
-                                                TIPI_79_RR,
-                                                0x484 } };
-
-
- const std::map<RadarType, int> start_stop_ret = {
-                                            {
-                                              KANZA,
-                                              0x101 },
-                                            {
-                                              TIPI_79_FL,
-                                              0x111 },
-                                            {
-                                              TIPI_79_FR,
-                                              0x121 },
-                                            {
-                                              TIPI_79_RL,
-                                              0x131 },
-                                            {
-                                              TIPI_79_RR,
-                                              0x141 } };
-
-const std::map<RadarType, int> radar_id = {
-                                            {
-                                              KANZA,
-                                              0x101 },
-                                            {
-                                              TIPI_79_FL,
-                                              0x111 },
-                                            {
-                                              TIPI_79_FR,
-                                              0x121 },
-                                            {
-                                              TIPI_79_RL,
-                                              0x131 },
-                                            {
-                                              TIPI_79_RR,
-                                              0x141 } };
-
-const std::map<RadarType, int> tracked_id = {
-                                              {
-                                                KANZA,
-                                                0x490 },
-                                              {
-                                                TIPI_79_FL,
-                                                0x491 },
-                                              {
-                                                TIPI_79_FR,
-                                                0x492 },
-                                              {
-                                                TIPI_79_RL,
-                                                0x493 },
-                                              {
-                                                TIPI_79_RR,
-                                                0x494 } };
-
-const std::map<RadarType, int> raw_id = {
-                                          {
-                                            KANZA,
-                                            0x4A0 },
-                                          {
-                                            TIPI_79_FL,
-                                            0x4A1 },
-                                          {
-                                            TIPI_79_FR,
-                                            0x4A2 },
-                                          {
-                                            TIPI_79_RL,
-                                            0x4A3 },
-                                          {
-                                            TIPI_79_RR,
-                                            0x4A4 } };
-
-const std::map<RadarType, int> bsd_id = {
-                                          {
-                                            KANZA,
-                                            0xDEAD },
-                                          {
-                                            TIPI_79_FL,
-                                            0xDEAD },
-                                          {
-                                            TIPI_79_FR,
-                                            0xDEAD },
-                                          {
-                                            TIPI_79_RL,
-                                            0x453 },
-                                          {
-                                            TIPI_79_RR,
-                                            0x454 } };
+using can_protocol::no_id;
+constexpr uint32_t message_ids[N_RADARS][N_MESSAGE_TYPES] = {
+  // unknown, heartbeat 1, heartbeat 2, start/stop ret, start frame, stop frame, raw, tracked, BSD
+  { no_id, no_id, no_id, 0x101, 0x420, 0x480, 0x4A0, 0x490, no_id }, // KANZA
+  { no_id, 0x502, 0x503, 0x111, 0x421, 0x481, 0x4A1, 0x491, no_id }, // TIPI_79_FL
+  { no_id, 0x503, 0x504, 0x121, 0x422, 0x482, 0x4A2, 0x492, no_id }, // TIPI_79_FR
+  { no_id, 0x504, 0x505, 0x131, 0x423, 0x483, 0x4A3, 0x493, 0x453 }, // TIPI_79_RL
+  { no_id, 0x505, 0x506, 0x141, 0x424, 0x484, 0x4A4, 0x494, 0x454 } }; // TIPI_79_RR
+
+// ID to message type lookup for each type of radar, generated at compile time:
+constexpr can_protocol::IdDispatch dispatch[N_RADARS] = {
+  can_protocol::makeIdDispatch( message_ids[KANZA] ),
+  can_protocol::makeIdDispatch( message_ids[TIPI_79_FL] ),
+  can_protocol::makeIdDispatch( message_ids[TIPI_79_FR] ),
+  can_protocol::makeIdDispatch( message_ids[TIPI_79_RL] ),
+  can_protocol::makeIdDispatch( message_ids[TIPI_79_RR] ) };
+
+static_assert( dispatch[KANZA].multiplier != 0 && dispatch[TIPI_79_FL].multiplier != 0 &&
+	       dispatch[TIPI_79_FR].multiplier != 0 && dispatch[TIPI_79_RL].multiplier != 0 &&
+	       dispatch[TIPI_79_RR].multiplier != 0, "no perfect hash found for the BSD message IDs" );
 
 } // namespace ConfigT79BSD
 
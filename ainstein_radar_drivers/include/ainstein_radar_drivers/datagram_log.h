@@ -0,0 +1,95 @@
+#ifndef DATAGRAM_LOG_H_
+#define DATAGRAM_LOG_H_
+
+#include <netinet/in.h>
+#include <time.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <chrono>
+
+namespace ainstein_radar_drivers
+{
+  // Compact on-disk log of received UDP datagrams. The file starts with an
+  // 8-byte magic string, followed by one record per datagram:
+  //   int64 receive time seconds, int32 nanoseconds,
+  //   uint32 source IPv4 address and uint16 source port (network byte order),
+  //   uint16 payload length, then the payload bytes.
+  // Empty datagrams are not logged, so a zero length marks the end of the records; a
+  // capture killed before it is closed keeps the zero-filled tail it had preallocated.
+  class DatagramLog
+  {
+  public:
+    static const char magic[8];
+    static const unsigned int record_header_len;
+  };
+
+  // Appends datagrams to a log through a memory mapping which grows as needed:
+  class DatagramCapture
+  {
+  public:
+    DatagramCapture( void );
+    ~DatagramCapture( void );
+
+    bool open( const std::string& filename );
+    void close( void );
+    bool isOpen( void ) const
+    {
+      return ( fd_ >= 0 );
+    }
+
+    bool append( const char* data, int len, const struct timespec& receive_time,
+		 const struct sockaddr_in& src_addr );
+
+  private:
+    bool reserve( std::size_t len );
+
+    int fd_;
+    char* map_;
+    std::size_t map_len_;
+    std::size_t len_;
+  };
+
+  // Reads datagrams back from a log, paced at the recorded rate scaled by
+  // rate (2.0 is twice as fast), or as fast as possible if rate <= 0:
+  class DatagramReplay
+  {
+  public:
+    DatagramReplay( void );
+    ~DatagramReplay( void );
+
+    bool open( const std::string& filename, double rate = 1.0 );
+    void close( void );
+
+    // Get the next datagram, blocking until it is due. The data pointer stays
+    // valid until the replay is closed. Returns false at the end of the log:
+    bool next( const char*& data, int& len, struct timespec& receive_time );
+
+    bool done( void ) const
+    {
+      return ( map_ == nullptr || pos_ >= len_ );
+    }
+
+    std::size_t numReplayed( void ) const
+    {
+      return num_replayed_;
+    }
+
+    // Wall clock time since the first datagram was replayed:
+    double elapsed( void ) const;
+
+  private:
+    int fd_;
+    const char* map_;
+    std::size_t len_;
+    std::size_t pos_;
+
+    double rate_;
+    std::size_t num_replayed_;
+    struct timespec first_stamp_;
+    std::chrono::steady_clock::time_point first_wall_;
+  };
+
+} // namespace ainstein_radar_drivers
+
+#endif // DATAGRAM_LOG_H_
@@ -0,0 +1,223 @@
+#ifndef FRAME_RING_H_
+#define FRAME_RING_H_
+
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ainstein_radar_drivers
+{
+  // Bounded ring of frame indices. Pushing is single-producer, popping is lock-free
+  // for up to two poppers (the consumer, and the producer dropping the oldest entry).
+  class IndexRing
+  {
+  public:
+    explicit IndexRing( unsigned int capacity ) :
+      buffer_( new std::atomic<uint32_t>[capacity] ),
+      capacity_( capacity ),
+      head_( 0 ),
+      tail_( 0 )
+    {
+    }
+
+    bool push( uint32_t index )
+    {
+      uint64_t tail = tail_.load( std::memory_order_relaxed );
+      if( tail - head_.load( std::memory_order_acquire ) >= capacity_ )
+	{
+	  return false;
+	}
+
+      buffer_[tail % capacity_].store( index, std::memory_order_relaxed );
+      tail_.store( tail + 1, std::memory_order_release );
+      return true;
+    }
+
+    bool pop( uint32_t& index )
+    {
+      uint64_t head = head_.load( std::memory_order_acquire );
+      while( head != tail_.load( std::memory_order_acquire ) )
+	{
+	  // The entry can only be overwritten once head has moved on, in which case the CAS fails:
+	  index = buffer_[head % capacity_].load( std::memory_order_relaxed );
+	  if( head_.compare_exchange_weak( head, head + 1, std::memory_order_acq_rel ) )
+	    {
+	      return true;
+	    }
+	}
+
+      return false;
+    }
+
+  private:
+    std::unique_ptr<std::atomic<uint32_t>[]> buffer_;
+    const uint64_t capacity_;
+
+    std::atomic<uint64_t> head_;
+    std::atomic<uint64_t> tail_;
+  };
+
+  // Single-producer/single-consumer hand-off of preallocated frames. The producer
+  // fills writeSlot() and pushes it, the consumer pops frames and owns each one until
+  // its next pop. Frames are exchanged by index, so nothing is copied or allocated.
+  // When the consumer falls behind, either the oldest queued or the newest frame is
+  // dropped; the producer never blocks.
+  template <typename T>
+  class FrameRing
+  {
+  public:
+    enum OverflowPolicy { DROP_OLDEST, DROP_NEWEST };
+
+    FrameRing( unsigned int capacity, OverflowPolicy policy ) :
+      slots_( capacity + 3 ),
+      queue_( capacity ),
+      free_( capacity + 3 ),
+      policy_( policy ),
+      num_pushed_( 0 ),
+      num_dropped_( 0 ),
+      num_popped_( 0 )
+    {
+      // One slot is always owned by the producer and one by the consumer; the spare
+      // covers a consumer between taking a new slot and returning its old one:
+      for( uint32_t i = 0; i < slots_.size() - 2; ++i )
+	{
+	  free_.push( i );
+	}
+      write_ind_ = slots_.size() - 2;
+      read_ind_ = slots_.size() - 1;
+
+      event_fd_ = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+    }
+
+    ~FrameRing( void )
+    {
+      close( event_fd_ );
+    }
+
+    std::size_t numSlots( void ) const
+    {
+      return slots_.size();
+    }
+
+    T& slot( std::size_t i )
+    {
+      return slots_[i];
+    }
+
+    // Producer side:
+    T& writeSlot( void )
+    {
+      return slots_[write_ind_];
+    }
+
+    // Hand the write slot to the consumer, returning false if a frame was dropped:
+    bool push( void )
+    {
+      num_pushed_.fetch_add( 1, std::memory_order_relaxed );
+
+      bool dropped = false;
+      uint32_t next_ind;
+      if( queue_.push( write_ind_ ) )
+	{
+	  free_.pop( next_ind );
+	}
+      else if( policy_ == DROP_NEWEST )
+	{
+	  // Keep the write slot, so the frame just received is overwritten by the next one:
+	  num_dropped_.fetch_add( 1, std::memory_order_relaxed );
+	  return false;
+	}
+      else
+	{
+	  // Take back the oldest queued frame unless the consumer just got to it first:
+	  if( queue_.pop( next_ind ) )
+	    {
+	      num_dropped_.fetch_add( 1, std::memory_order_relaxed );
+	      dropped = true;
+	    }
+	  else
+	    {
+	      free_.pop( next_ind );
+	    }
+	  queue_.push( write_ind_ );
+	}
+      write_ind_ = next_ind;
+
+      notify();
+      return !dropped;
+    }
+
+    // Consumer side, returning nullptr if no frame is queued:
+    T* pop( void )
+    {
+      uint32_t ind;
+      if( !queue_.pop( ind ) )
+	{
+	  return nullptr;
+	}
+
+      free_.push( read_ind_ );
+      read_ind_ = ind;
+      num_popped_.fetch_add( 1, std::memory_order_relaxed );
+
+      return &slots_[read_ind_];
+    }
+
+    // Block the consumer until a frame may have been pushed, notify() is called or the timeout expires:
+    void wait( int timeout_ms )
+    {
+      struct pollfd pfd;
+      pfd.fd = event_fd_;
+      pfd.events = POLLIN;
+      if( poll( &pfd, 1, timeout_ms ) > 0 )
+	{
+	  uint64_t count;
+	  ssize_t res = read( event_fd_, &count, sizeof( count ) );
+	  (void)res;
+	}
+    }
+
+    void notify( void )
+    {
+      uint64_t one = 1;
+      ssize_t res = write( event_fd_, &one, sizeof( one ) );
+      (void)res;
+    }
+
+    // Frames offered by the producer, dropped on overflow, and taken by the consumer:
+    uint64_t numPushed( void ) const
+    {
+      return num_pushed_.load( std::memory_order_relaxed );
+    }
+    uint64_t numDropped( void ) const
+    {
+      return num_dropped_.load( std::memory_order_relaxed );
+    }
+    uint64_t numPopped( void ) const
+    {
+      return num_popped_.load( std::memory_order_relaxed );
+    }
+
+  private:
+    std::vector<T> slots_;
+    IndexRing queue_;
+    IndexRing free_;
+    const OverflowPolicy policy_;
+
+    uint32_t write_ind_;
+    uint32_t read_ind_;
+    int event_fd_;
+
+    std::atomic<uint64_t> num_pushed_;
+    std::atomic<uint64_t> num_dropped_;
+    std::atomic<uint64_t> num_popped_;
+  };
+
+} // namespace ainstein_radar_drivers
+
+#endif // FRAME_RING_H_
@@ -2,24 +2,100 @@
 #define RADAR_DRIVER_K79_H_
 
 #include <netinet/in.h>
+#include <sys/socket.h>
+#include <time.h>
 #include <string>
 #include <memory>
 #include <vector>
 
-#include "radar_target.h"
+#include <ainstein_radar_core/radar_target.h>
+#include <ainstein_radar_core/radar_target_decoder.h>
+
+#include "datagram_log.h"
+#include "udp_handshake.h"
+#include "udp_radar_stats.h"
 
 namespace ainstein_radar_drivers
 {  
+  using ainstein_radar_core::RadarTarget;
+  using ainstein_radar_core::RadarTargetDecoder;
+  using ainstein_radar_core::RadarTargetGate;
+  using ainstein_radar_core::RadarTargetSink;
+
   class RadarDriverK79 {
 
   public:
     RadarDriverK79( std::string host_ip_address, int host_port,
-		    std::string radar_ip_address, int radar_port );         
+		    std::string radar_ip_address, int radar_port,
+		    bool use_batch_receive = false,
+		    bool use_kernel_timestamps = false );
     ~RadarDriverK79( void );
 
     bool connect( void );
-    bool receiveTargets( std::vector<ainstein_radar_drivers::RadarTarget> &targets,
-			 std::vector<ainstein_radar_drivers::RadarTarget> &targets_tracked );
+
+    // Whether the radar is streaming, after the handshake or once data arrives anyway:
+    bool isReady( void ) const
+    {
+      return ( use_replay_ || handshake_.getState() == UdpHandshake::READY );
+    }
+    const UdpHandshake& getHandshake( void ) const
+    {
+      return handshake_;
+    }
+    void setHandshakeParameters( const UdpHandshake::Parameters& params )
+    {
+      handshake_.setParameters( params );
+    }
+
+    // Watchdog reconnecting to the radar when its stream stalls. Call it after receiving,
+    // which times out after getHandshake().getCheckPeriod() without data:
+    bool checkStream( void )
+    {
+      return ( use_replay_ || handshake_.checkStream( stats_.numFrames(), UdpHandshake::now() ) );
+    }
+
+    // Drop raw targets outside the gate while decoding, tracked targets are all kept:
+    void setTargetGate( const RadarTargetGate& gate )
+    {
+      decoder_raw_.setGate( gate );
+    }
+
+    int getSocket( void ) const
+    {
+      return sockfd_;
+    }
+
+    // Append every received datagram to a capture log:
+    bool startCapture( const std::string& filename );
+
+    // Receive datagrams from a capture log instead of the radar, paced at the
+    // recorded rate times rate (as fast as possible if rate <= 0):
+    bool startReplay( const std::string& filename, double rate = 1.0 );
+    bool isReplaying( void ) const
+    {
+      return use_replay_;
+    }
+    const DatagramReplay& getReplay( void ) const
+    {
+      return replay_;
+    }
+
+    // Whether the last receive found nothing more to read. A receive returning false
+    // without this (a malformed datagram, or one the handshake consumed) can be retried:
+    bool isDrained( void ) const
+    {
+      return ( use_replay_ ? replay_.done() : socket_drained_ ) && batch_ind_ >= batch_len_;
+    }
+
+    // Receive counters, safe to read from any thread:
+    const UdpRadarStats& getStats( void ) const
+    {
+      return stats_;
+    }
+
+    bool receiveTargets( ainstein_radar_drivers::RadarTargetSink &targets,
+			 ainstein_radar_drivers::RadarTargetSink &targets_tracked,
+			 struct timespec &receive_time );
   
     static const std::string connect_cmd_str;
     static const unsigned int connect_res_len;
@@ -27,9 +103,22 @@ namespace ainstein_radar_drivers
     static const std::string run_cmd_str;
 
     static const unsigned int radar_msg_len;
+    static const unsigned int max_batch_len;
     static const unsigned int target_msg_len;
   
   private:
+    bool receiveTargetsBatch( ainstein_radar_drivers::RadarTargetSink &targets,
+			      ainstein_radar_drivers::RadarTargetSink &targets_tracked,
+			      struct timespec &receive_time );
+    bool isTrackedMessage( const char* buffer, int msg_len );
+    bool processDatagram( const char* buffer, int msg_len, bool truncated,
+			  const struct timespec &receive_time,
+			  ainstein_radar_drivers::RadarTargetSink &targets,
+			  ainstein_radar_drivers::RadarTargetSink &targets_tracked );
+    bool decodeMessage( const char* buffer, int msg_len,
+			ainstein_radar_drivers::RadarTargetSink &targets,
+			ainstein_radar_drivers::RadarTargetSink &targets_tracked );
+
     std::string host_ip_addr_;
     int host_port_;
     std::string radar_ip_addr_;
@@ -40,6 +129,30 @@ namespace ainstein_radar_drivers
     char* buffer_;
 
     struct sockaddr_in destaddr_;
+
+    bool use_kernel_timestamps_;
+
+    RadarTargetDecoder decoder_;
+    RadarTargetDecoder decoder_raw_;
+
+    // Batched receive state, datagrams are decoded from batch_ind_ up to batch_len_:
+    bool use_batch_receive_;
+    std::vector<char> batch_buffer_;
+    std::vector<char> batch_control_;
+    std::vector<struct iovec> batch_iovecs_;
+    std::vector<struct mmsghdr> batch_msgs_;
+    std::vector<struct sockaddr_in> batch_addrs_;
+    int batch_len_;
+    int batch_ind_;
+    bool socket_drained_;
+
+    DatagramCapture capture_;
+    DatagramReplay replay_;
+    bool use_replay_;
+
+    UdpRadarStats stats_;
+    UdpHandshake handshake_;
+    bool in_raw_frame_;
   };
 
 } // namespace ainstein_radar_drivers
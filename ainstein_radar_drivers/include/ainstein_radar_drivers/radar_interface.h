@@ -1,11 +1,25 @@
 #ifndef RADAR_INTERFACE_H_
 #define RADAR_INTERFACE_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include <ros/ros.h>
 #include <can_msgs/Frame.h>
 #include <ainstein_radar_msgs/RadarTargetArray.h>
 #include <ainstein_radar_msgs/RadarAlarmArray.h>
 
+#include <ainstein_radar_core/can_protocol.h>
+
+#include "ainstein_radar_drivers/can_frame_assembler.h"
+#include "ainstein_radar_drivers/socket_can.h"
+#include "ainstein_radar_drivers/target_gate_params.h"
+
 namespace ainstein_radar_drivers
 {
 
@@ -14,6 +28,13 @@ namespace ainstein_radar_drivers
 //    RadarInterface<can_msgs::Frame> radar_interface( "tipi_79_bsd_front_left", "received_messages", "sent_messages" );
 //
 // The user must implement the startRadar, stopRadar and dataMsgCallback functions.
+//
+// If the private can_device parameter is set, CAN frames are read straight from that
+// SocketCAN device instead of the data topic, once the derived interface has called
+// startSocketCan() with the IDs it decodes, and commands go out on the same socket.
+//
+// Raw targets outside the gate set by the private gate/ parameters should be dropped
+// before they are decoded, see gate_.
 template<typename data_msg_type>
 class RadarInterface
 {
@@ -28,14 +49,21 @@ public:
   nh_( node_handle ),
     nh_private_( node_handle_private ),
     name_( radar_name ),
-    radar_data_msg_ptr_raw_( new ainstein_radar_msgs::RadarTargetArray ),
-    radar_data_msg_ptr_tracked_( new ainstein_radar_msgs::RadarTargetArray ),
-    radar_data_msg_ptr_alarms_( new ainstein_radar_msgs::RadarAlarmArray )
+    can_running_( false )
     {
+        // Get the SocketCAN device to receive from directly, if any:
+        nh_private_.param( "can_device", can_device_, std::string( "" ) );
+
+        // Get the gate for raw targets:
+        gate_ = getTargetGateParams( nh_private_ );
+
         // Set up the subscriber to receive radar data:
-        sub_data_msg_ = nh_.subscribe( data_msg_topic, 10,
-				       &RadarInterface::dataMsgCallback,
-				       this );
+        if( can_device_.empty() )
+          {
+            sub_data_msg_ = nh_.subscribe( data_msg_topic, 10,
+                                           &RadarInterface::dataMsgCallback,
+                                           this );
+          }
 
         // Set up the publisher for sending commands to the radar:
         pub_radar_cmd_ = nh_.advertise<data_msg_type>( radar_cmd_topic,
@@ -55,6 +83,7 @@ public:
     }
     virtual ~RadarInterface( void )
     {
+      stopSocketCan();
     }
 
     virtual void startRadar( void ) = 0;
@@ -67,8 +96,110 @@ protected:
 
     virtual void dataMsgCallback( const data_msg_type& data_msg ) = 0;
 
+    // Start assembling a new frame, warning if the previous one never got its stop frame.
+    // While pub has no subscribers (nodelets in the same process included), the frame is
+    // only tracked and its items are not decoded:
+    template<typename msg_type>
+    void startFrame( const ros::Publisher& pub, CanFrameAssembler<msg_type>& frame, const ros::Time& stamp )
+    {
+      if( !frame.start( stamp, pub.getNumSubscribers() > 0 ) )
+        {
+          ROS_WARN_STREAM_THROTTLE( 1.0, name_ << ": dropped an incomplete frame, " << frame.numIncomplete() << " so far" );
+        }
+    }
+
+    // Publish a finished frame, unless no frame was open (or it is empty and publish_empty
+    // is false), warning about frames and items the assembler dropped. The message is
+    // shared with nodelet subscribers and never modified again:
+    template<typename msg_type>
+    void publishFrame( const ros::Publisher& pub, CanFrameAssembler<msg_type>& frame, bool publish_empty = true )
+    {
+      bool orphaned = !frame.isOpen();
+      bool empty = ( frame.size() == 0 );
+      boost::shared_ptr<const msg_type> msg = frame.finish();
+      if( orphaned )
+        {
+          ROS_WARN_STREAM_THROTTLE( 1.0, name_ << ": dropped a stop frame without a start frame, "
+                                    << frame.numOrphaned() << " stop and item frames so far" );
+        }
+      else if( frame.numOverflowedInFrame() > 0 )
+        {
+          ROS_WARN_STREAM_THROTTLE( 1.0, name_ << ": dropped " << frame.numOverflowedInFrame()
+                                    << " items beyond the maximum per frame, " << frame.numOverflowed() << " so far" );
+        }
+
+      if( msg && ( publish_empty || !empty ) )
+        {
+          pub.publish( msg );
+        }
+    }
+
+    // Open the SocketCAN device, if one is configured, passing only frames with the given IDs:
+    void startSocketCan( const std::vector<uint32_t>& ids )
+    {
+      if( can_device_.empty() )
+        {
+          return;
+        }
+
+      can_socket_.reset( new SocketCan( can_device_ ) );
+      for( uint32_t id : ids )
+        {
+          can_socket_->addFilter( id );
+        }
+      if( !can_socket_->connect() )
+        {
+          ROS_ERROR_STREAM( "Failed to open CAN device " << can_device_ );
+          can_socket_.reset();
+          return;
+        }
+
+      can_running_ = true;
+      can_thread_ = std::unique_ptr<std::thread>( new std::thread( &RadarInterface::socketCanLoop, this ) );
+    }
+
+    // Stop receiving from the SocketCAN device. Derived interfaces must call this from their
+    // destructor, since the receiving thread calls their dataMsgCallback:
+    void stopSocketCan( void )
+    {
+      if( can_thread_ )
+        {
+          can_running_ = false;
+          can_thread_->join();
+          can_thread_.reset();
+        }
+    }
+
+    // Send a command frame to the radar, on the SocketCAN device if there is one:
+    void sendCommand( const can_msgs::Frame& msg )
+    {
+      if( can_socket_ )
+        {
+          struct can_frame frame;
+          std::memset( &frame, 0, sizeof( frame ) );
+          frame.can_id = msg.id;
+          if( msg.is_extended )
+            {
+              frame.can_id |= CAN_EFF_FLAG;
+            }
+          if( msg.is_rtr )
+            {
+              frame.can_id |= CAN_RTR_FLAG;
+            }
+          frame.can_dlc = std::min<uint8_t>( msg.dlc, CAN_MAX_DLEN );
+          std::memcpy( frame.data, msg.data.data(), frame.can_dlc );
+          can_socket_->sendFrame( frame );
+        }
+      else
+        {
+          pub_radar_cmd_.publish( msg );
+        }
+    }
+
     ros::NodeHandle nh_;
     ros::NodeHandle nh_private_;
+
+    RadarTargetGate gate_;
     
     ros::Publisher pub_radar_cmd_;
     ros::Publisher pub_radar_data_raw_;
@@ -77,9 +208,60 @@ protected:
 
     ros::Subscriber sub_data_msg_;
 
-    boost::shared_ptr<ainstein_radar_msgs::RadarTargetArray> radar_data_msg_ptr_raw_;
-    boost::shared_ptr<ainstein_radar_msgs::RadarTargetArray> radar_data_msg_ptr_tracked_;
-    boost::shared_ptr<ainstein_radar_msgs::RadarAlarmArray> radar_data_msg_ptr_alarms_;
+    // Frames being assembled from the received CAN frames:
+    CanFrameAssembler<ainstein_radar_msgs::RadarTargetArray> frame_raw_;
+    CanFrameAssembler<ainstein_radar_msgs::RadarTargetArray> frame_tracked_;
+    CanFrameAssembler<ainstein_radar_msgs::RadarAlarmArray> frame_alarms_;
+
+private:
+    void socketCanLoop( void )
+    {
+      // Convert each received frame to the same message socketcan_bridge would publish:
+      can_msgs::Frame msg;
+      msg.header.frame_id = can_device_;
+      uint32_t kernel_drops = 0;
+      while( can_running_ && !ros::isShuttingDown() )
+        {
+          int num_frames = can_socket_->receiveFrames();
+          if( num_frames < 0 )
+            {
+              if( errno != EAGAIN && errno != EWOULDBLOCK )
+                {
+                  ROS_WARN_STREAM_THROTTLE( 1.0, "Failed to read CAN frames: " << std::strerror( errno ) );
+                }
+              continue;
+            }
+
+          // Frames the kernel dropped were never seen, so their frames show up as incomplete:
+          if( can_socket_->getKernelDrops() != kernel_drops )
+            {
+              kernel_drops = can_socket_->getKernelDrops();
+              ROS_WARN_STREAM_THROTTLE( 1.0, name_ << ": kernel dropped CAN frames on " << can_device_ << ", "
+                                        << kernel_drops << " so far" );
+            }
+
+          for( int i = 0; i < num_frames; ++i )
+            {
+              const struct can_frame& frame = can_socket_->getFrame( i );
+              const struct timespec& receive_time = can_socket_->getReceiveTime( i );
+
+              msg.header.stamp = ros::Time( receive_time.tv_sec, receive_time.tv_nsec );
+              msg.is_extended = ( frame.can_id & CAN_EFF_FLAG );
+              msg.is_rtr = ( frame.can_id & CAN_RTR_FLAG );
+              msg.is_error = ( frame.can_id & CAN_ERR_FLAG );
+              msg.id = frame.can_id & ( msg.is_extended ? CAN_EFF_MASK : CAN_SFF_MASK );
+              msg.dlc = frame.can_dlc;
+              std::memcpy( msg.data.data(), frame.data, sizeof( frame.data ) );
+
+              dataMsgCallback( msg );
+            }
+        }
+    }
+
+    std::string can_device_;
+    std::unique_ptr<SocketCan> can_socket_;
+    std::atomic<bool> can_running_;
+    std::unique_ptr<std::thread> can_thread_;
 };
 
 } // namespace ainstein_radar_drivers
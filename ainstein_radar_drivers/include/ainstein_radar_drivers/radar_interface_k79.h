@@ -10,6 +10,13 @@
 #include <ainstein_radar_msgs/RadarInfo.h>
 #include <ainstein_radar_msgs/RadarTargetArray.h>
 #include <ainstein_radar_drivers/radar_driver_k79.h>
+#include <ainstein_radar_drivers/frame_ring.h>
+#include <ainstein_radar_drivers/radar_target_array_sink.h>
+#include <ainstein_radar_drivers/target_gate_params.h>
+#include <ainstein_radar_drivers/udp_reactor.h>
+#include <ainstein_radar_drivers/udp_radar_diagnostics.h>
+#include <diagnostic_msgs/DiagnosticArray.h>
+#include <std_msgs/Bool.h>
 #include <ros/ros.h>
 
 namespace ainstein_radar_drivers
@@ -23,6 +30,8 @@ public:
   ~RadarInterfaceK79();
 
   void mainLoop( void );
+  void onReadable( void );
+  void publishLoop( void );
   ainstein_radar_msgs::RadarTarget targetToROSMsg( const ainstein_radar_drivers::RadarTarget &t )
   {
     ainstein_radar_msgs::RadarTarget target;
@@ -66,9 +75,28 @@ public:
   
 private:
 
+  // Everything received from the radar in one receive call, decoded in place:
+  struct Frame
+  {
+    ainstein_radar_msgs::RadarTargetArray targets_raw;
+    ainstein_radar_msgs::RadarTargetArray targets_tracked;
+    struct timespec receive_time;
+    ros::Time decode_time;
+
+    std::unique_ptr<RadarTargetArraySink> sink_raw;
+    std::unique_ptr<RadarTargetArraySink> sink_tracked;
+  };
+
   void publishRadarInfo( void );
+  void publishReady( bool ready );
+  void checkStream( void );
+  void initFrame( Frame& frame );
+  bool receiveFrame( void );
+  void publishFrame( Frame& frame );
+  void publishDiagnostics( const ros::TimerEvent& event );
   
   std::string frame_id_;
+  bool use_kernel_timestamps_;
 
   std::unique_ptr<ainstein_radar_drivers::RadarDriverK79> driver_;
   
@@ -76,14 +104,29 @@ private:
   std::unique_ptr<std::thread> thread_;
   std::mutex mutex_;
 
+  // Whether the radar is streaming, as last published:
+  bool is_ready_;
+
+  std::shared_ptr<UdpReactor> reactor_;
+
+  // Frames are either published by the receiving thread, or handed off through the ring:
+  Frame frame_;
+  std::unique_ptr<FrameRing<Frame>> ring_;
+  std::unique_ptr<std::thread> publish_thread_;
+
   ros::NodeHandle nh_;
   ros::NodeHandle nh_private_;
   ros::Publisher pub_radar_data_raw_;
   ros::Publisher pub_radar_data_tracked_;
   ros::Publisher pub_radar_info_;
+  ros::Publisher pub_ready_;
+  ros::Publisher pub_diagnostics_;
+
+  double diagnostics_period_;
+  ros::Timer diagnostics_timer_;
+  diagnostic_msgs::DiagnosticStatus diagnostic_status_;
+  UdpRadarStats::Snapshot last_stats_;
 
-  boost::shared_ptr<ainstein_radar_msgs::RadarTargetArray> radar_data_msg_ptr_raw_;      
-  boost::shared_ptr<ainstein_radar_msgs::RadarTargetArray> radar_data_msg_ptr_tracked_;      
   boost::shared_ptr<ainstein_radar_msgs::RadarInfo> radar_info_msg_ptr_;      
 };
 
@@ -9,6 +9,11 @@
 
 #include <ros/ros.h>
 #include <ainstein_radar_msgs/RadarTargetArray.h>
+#include <ainstein_radar_drivers/radar_target_array_sink.h>
+#include <ainstein_radar_drivers/target_gate_params.h>
+#include <ainstein_radar_drivers/udp_handshake.h>
+#include <ainstein_radar_drivers/udp_radar_stats.h>
+#include <ainstein_radar_drivers/udp_reactor.h>
 
 namespace ainstein_radar_drivers
 {
@@ -22,6 +27,7 @@ public:
 
   bool connect( void );
   void mainLoop( void );
+  void onReadable( void );
   
   static const std::string connect_cmd_str;
   static const unsigned int connect_res_len;
@@ -33,8 +39,13 @@ public:
 
   static const unsigned int radar_msg_len;
   static const unsigned int target_msg_len;
+
+  static constexpr double UPDATE_RATE = 10.0;
   
 private:
+  bool receiveAndPublish( void );
+  void checkStream( void );
+
   std::string host_ip_addr_;
   int host_port_;
 
@@ -42,6 +53,7 @@ private:
   std::string radar_ip_addr_;
   int radar_port_;
   std::string frame_id_;
+  bool use_kernel_timestamps_;
 
   int sockfd_; // socket file descriptor
   struct sockaddr_in sockaddr_;
@@ -53,11 +65,20 @@ private:
   std::unique_ptr<std::thread> thread_;
   std::mutex mutex_;
 
+  std::shared_ptr<UdpReactor> reactor_;
+
+  // Connect/run handshake, also restarted by the stream watchdog, and receive counters:
+  UdpRadarStats stats_;
+  UdpHandshake handshake_;
+  bool is_ready_;
+
   ros::NodeHandle nh_;
   ros::NodeHandle nh_private_;
   ros::Publisher pub_radar_data_raw_;
 
   boost::shared_ptr<ainstein_radar_msgs::RadarTargetArray> radar_data_msg_ptr_raw_;      
+
+  RadarTargetDecoder decoder_;
 };
 
 } // namespace ainstein_radar_drivers
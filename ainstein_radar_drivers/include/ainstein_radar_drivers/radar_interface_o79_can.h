@@ -17,6 +17,7 @@ namespace ainstein_radar_drivers
 			  ros::NodeHandle node_Handle_private );
     ~RadarInterfaceO79CAN()
     {
+      stopSocketCan();
     }
 
     // Start and stop not required, currently autostarts
@@ -70,6 +71,7 @@ namespace ainstein_radar_drivers
     unsigned int can_id_;
     std::string frame_id_;
     std::string can_id_str_;
+    ainstein_radar_core::can_protocol::TargetGate<ainstein_radar_core::can_protocol::O79RawTargetLayout> raw_gate_;
     
     ros::Publisher pub_radar_info_;
     boost::shared_ptr<ainstein_radar_msgs::RadarInfo> radar_info_msg_ptr_;      
@@ -19,6 +19,7 @@ namespace ainstein_radar_drivers
     {
       // Stop the radar (doesn't seem to get called):
       stopRadar();
+      stopSocketCan();
     }
 
     void startRadar( void );
@@ -28,6 +29,12 @@ namespace ainstein_radar_drivers
   
     void updateZOI( double range_min, double range_max,
 		    double azimuth_min, double azimuth_max );
+
+    // Decode a raw or tracked target CAN frame:
+    static void decodeTarget( const can_msgs::Frame& msg, ainstein_radar_msgs::RadarTarget& target );
+
+    // Fill in the fixed T79 specifications:
+    static void fillRadarInfo( ainstein_radar_msgs::RadarInfo& info );
         
     // Radar command message IDs
     static const uint16_t RADAR_COMMAND = 0x100;
@@ -87,6 +94,7 @@ namespace ainstein_radar_drivers
   
     int can_id_;
     std::string frame_id_;
+    ainstein_radar_core::can_protocol::TargetGate<ainstein_radar_core::can_protocol::T79TargetLayout> raw_gate_;
   
     dynamic_reconfigure::Server<ainstein_radar_drivers::ZoneOfInterestT79Config> dyn_config_server_;
     ainstein_radar_drivers::ZoneOfInterestT79Config config_;
@@ -18,6 +18,7 @@ class RadarInterfaceT79BSD: public RadarInterface<can_msgs::Frame>
     {
       // Stop the radar (doesn't seem to get called):
       stopRadar();
+      stopSocketCan();
     }
 
     void startRadar( void );
@@ -29,6 +30,7 @@ private:
     ConfigT79BSD::RadarType type_;
     std::string frame_id_;
     std::string name_;
+    ainstein_radar_core::can_protocol::TargetGate<ainstein_radar_core::can_protocol::T79TargetLayout> raw_gate_;
 };
 
 } // namespace ainstein_drivers
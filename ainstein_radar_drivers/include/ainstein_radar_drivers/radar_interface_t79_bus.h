@@ -0,0 +1,69 @@
+#ifndef RADAR_INTERFACE_T79_BUS_H_
+#define RADAR_INTERFACE_T79_BUS_H_
+
+#include <linux/can.h>
+#include <vector>
+
+#include <can_msgs/Frame.h>
+
+#include "ainstein_radar_drivers/radar_interface.h"
+#include "ainstein_radar_drivers/radar_interface_t79.h"
+#include <ainstein_radar_msgs/RadarInfo.h>
+
+namespace ainstein_radar_drivers
+{
+  // Interface to every T79 radar on one CAN bus. The bus is received once and each frame
+  // is dispatched through a table indexed by CAN ID to the radar it belongs to, so the cost
+  // per frame does not grow with the number of radars. Radar i publishes its targets on
+  // ~<name i>/targets/raw and ~<name i>/targets/tracked.
+  class RadarInterfaceT79Bus: public RadarInterface<can_msgs::Frame>
+  {
+  public:
+    RadarInterfaceT79Bus( ros::NodeHandle node_Handle,
+			  ros::NodeHandle node_Handle_private );
+    ~RadarInterfaceT79Bus()
+    {
+      stopRadar();
+      stopSocketCan();
+    }
+
+    void startRadar( void );
+    void stopRadar( void );
+
+  private:
+    // Frame assembly state of one radar on the bus:
+    struct Radar
+    {
+      int can_id;
+      std::string name;
+
+      ros::Publisher pub_raw;
+      ros::Publisher pub_tracked;
+      ros::Publisher pub_info;
+
+      CanFrameAssembler<ainstein_radar_msgs::RadarTargetArray> frame_raw;
+      CanFrameAssembler<ainstein_radar_msgs::RadarTargetArray> frame_tracked;
+    };
+
+    // What a CAN ID carries, and for which radar:
+    enum MessageType { UNUSED = 0, START_FRAME, STOP_FRAME, RAW_TARGET, TRACKED_TARGET };
+    struct Route
+    {
+      uint8_t type;
+      uint8_t radar;
+    };
+
+    bool addRoute( uint32_t id, MessageType type, int radar );
+
+    void dataMsgCallback( const can_msgs::Frame &msg );
+
+    void sendStartStop( uint8_t command );
+
+    std::vector<Radar> radars_;
+    std::vector<Route> routes_; // indexed by standard CAN ID
+    ainstein_radar_core::can_protocol::TargetGate<ainstein_radar_core::can_protocol::T79TargetLayout> raw_gate_;
+  };
+
+} // namespace ainstein_radar_drivers
+
+#endif // RADAR_INTERFACE_T79_BUS_H_
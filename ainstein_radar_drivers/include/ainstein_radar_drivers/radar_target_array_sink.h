@@ -0,0 +1,194 @@
+#ifndef RADAR_TARGET_ARRAY_SINK_H_
+#define RADAR_TARGET_ARRAY_SINK_H_
+
+#include <cstring>
+
+#include <boost/shared_ptr.hpp>
+#include <ros/time.h>
+#include <ainstein_radar_msgs/RadarTargetArray.h>
+#include <ainstein_radar_filters/data_conversions.h>
+#include <sensor_msgs/PointCloud2.h>
+
+#include <ainstein_radar_core/radar_target_decoder.h>
+
+namespace ainstein_radar_drivers
+{
+  using ainstein_radar_core::RadarTargetDecoder;
+  using ainstein_radar_core::RadarTargetSink;
+
+  // Sink decoding targets straight into a RadarTargetArray message and, optionally,
+  // a PointCloud2 message in the same pass. Both messages keep their buffers between
+  // frames, so decoding does not allocate; only taking a message to publish does.
+  // Either output can be switched off per frame, e.g. while nobody subscribes to it,
+  // and with both off targets are only counted.
+  class RadarTargetArraySink : public RadarTargetSink
+  {
+  public:
+    RadarTargetArraySink( ainstein_radar_msgs::RadarTargetArray& msg,
+			  sensor_msgs::PointCloud2* cloud = nullptr ) :
+      msg_( msg ),
+      cloud_( cloud ),
+      fill_targets_( true ),
+      fill_cloud_( cloud != nullptr ),
+      num_targets_( 0 ),
+      base_( 0 ),
+      cloud_data_( nullptr )
+    {
+      if( cloud_ )
+	{
+	  // Let PCL fill in the PointRadarTarget field layout once, points are then copied in directly:
+	  pcl::toROSMsg( pcl::PointCloud<PointRadarTarget>(), *cloud_ );
+	  cloud_->header.frame_id = msg_.header.frame_id;
+	}
+    }
+
+    // Choose the outputs filled from the next frame on. The cloud can only be filled if
+    // one was passed to the constructor:
+    void setOutputs( bool fill_targets, bool fill_cloud )
+    {
+      fill_targets_ = fill_targets;
+      fill_cloud_ = fill_cloud && cloud_;
+    }
+
+    bool fillsTargets( void ) const
+    {
+      return fill_targets_;
+    }
+
+    bool fillsCloud( void ) const
+    {
+      return fill_cloud_;
+    }
+
+    // Number of targets decoded since the last clear, whether or not they were stored. With
+    // both outputs off, targets are not checked against the decoder's gate either:
+    std::size_t size( void ) const
+    {
+      return num_targets_;
+    }
+
+    void clear( void ) override
+    {
+      num_targets_ = 0;
+      msg_.targets.clear();
+      if( cloud_ )
+	{
+	  cloud_->data.clear();
+	  cloud_->width = 0;
+	  cloud_->row_step = 0;
+	}
+    }
+
+    void append( const RadarTargetDecoder& decoder, const char* data,
+		 int num_records, int first_id ) override
+    {
+      if( num_records <= 0 )
+	{
+	  return;
+	}
+
+      base_ = num_targets_;
+      num_targets_ += num_records;
+      if( !fill_targets_ && !fill_cloud_ )
+	{
+	  return;
+	}
+
+      if( fill_targets_ )
+	{
+	  msg_.targets.resize( base_ + num_records );
+	}
+      if( fill_cloud_ )
+	{
+	  cloud_->width = base_ + num_records;
+	  cloud_->row_step = cloud_->width * cloud_->point_step;
+	  cloud_->data.resize( cloud_->row_step );
+	  cloud_data_ = cloud_->data.data() + base_ * cloud_->point_step;
+	}
+
+      // Targets outside the decoder's gate leave the outputs shorter:
+      int num_decoded = decoder.decodeRows( data, num_records, first_id, *this );
+      if( num_decoded < num_records )
+	{
+	  num_targets_ = base_ + num_decoded;
+	  if( fill_targets_ )
+	    {
+	      msg_.targets.resize( num_targets_ );
+	    }
+	  if( fill_cloud_ )
+	    {
+	      cloud_->width = num_targets_;
+	      cloud_->row_step = cloud_->width * cloud_->point_step;
+	      cloud_->data.resize( cloud_->row_step );
+	    }
+	}
+    }
+
+    // Called by the decoder for each target:
+    void set( int k, uint16_t id, float range, float speed,
+	      float azimuth, float elevation, float snr )
+    {
+      ainstein_radar_msgs::RadarTarget cloud_target;
+      ainstein_radar_msgs::RadarTarget& target = fill_targets_ ? msg_.targets[base_ + k] : cloud_target;
+      target.target_id = id;
+      target.range = range;
+      target.speed = speed;
+      target.azimuth = azimuth;
+      target.elevation = elevation;
+      target.snr = snr;
+
+      if( fill_cloud_ )
+	{
+	  PointRadarTarget pcl_point;
+	  ainstein_radar_filters::data_conversions::radarTargetToPclPoint( target, pcl_point );
+	  std::memcpy( cloud_data_ + k * cloud_->point_step, &pcl_point, sizeof( pcl_point ) );
+	}
+    }
+
+    // Move the decoded targets into a new message for publishing. Nodelet subscribers share
+    // the published message, so it must never be modified afterwards; the decoding buffer
+    // gets the same capacity back for the next frame:
+    boost::shared_ptr<const ainstein_radar_msgs::RadarTargetArray> takeMessage( const ros::Time& stamp )
+    {
+      boost::shared_ptr<ainstein_radar_msgs::RadarTargetArray> msg( new ainstein_radar_msgs::RadarTargetArray );
+      msg->header.frame_id = msg_.header.frame_id;
+      msg->header.stamp = stamp;
+      msg->targets.swap( msg_.targets );
+      msg_.targets.reserve( msg->targets.size() );
+
+      return msg;
+    }
+
+    // Same for the point cloud, which must have been passed to the constructor:
+    boost::shared_ptr<const sensor_msgs::PointCloud2> takeCloud( const ros::Time& stamp )
+    {
+      boost::shared_ptr<sensor_msgs::PointCloud2> cloud( new sensor_msgs::PointCloud2 );
+      cloud->header.frame_id = cloud_->header.frame_id;
+      cloud->header.stamp = stamp;
+      cloud->height = cloud_->height;
+      cloud->width = cloud_->width;
+      cloud->fields = cloud_->fields;
+      cloud->is_bigendian = cloud_->is_bigendian;
+      cloud->point_step = cloud_->point_step;
+      cloud->row_step = cloud_->row_step;
+      cloud->is_dense = cloud_->is_dense;
+      cloud->data.swap( cloud_->data );
+      cloud_->data.reserve( cloud->data.size() );
+
+      return cloud;
+    }
+
+  private:
+    ainstein_radar_msgs::RadarTargetArray& msg_;
+    sensor_msgs::PointCloud2* cloud_;
+    bool fill_targets_;
+    bool fill_cloud_;
+
+    std::size_t num_targets_;
+    std::size_t base_;
+    uint8_t* cloud_data_;
+  };
+
+} // namespace ainstein_radar_drivers
+
+#endif // RADAR_TARGET_ARRAY_SINK_H_
@@ -0,0 +1,61 @@
+#ifndef RECEIVE_TIMESTAMP_H_
+#define RECEIVE_TIMESTAMP_H_
+
+#include <sys/socket.h>
+#include <time.h>
+#include <cstdint>
+#include <cstring>
+
+namespace ainstein_radar_drivers
+{
+  // Control message buffer length needed to receive an SO_TIMESTAMPNS timestamp and an SO_RXQ_OVFL drop count:
+  static const unsigned int receive_control_len = CMSG_SPACE( sizeof( struct timespec ) ) + CMSG_SPACE( sizeof( uint32_t ) );
+
+  // Enable kernel receive timestamps (SCM_TIMESTAMPNS control messages) on a socket:
+  inline bool enableReceiveTimestamps( int sockfd )
+  {
+    int timestampns = 1;
+    return ( setsockopt( sockfd, SOL_SOCKET, SO_TIMESTAMPNS, &timestampns, sizeof( timestampns ) ) == 0 );
+  }
+
+  // Extract the kernel receive time from a received message, falling back to the
+  // current (realtime) clock if the socket did not provide one:
+  inline void getReceiveTimestamp( const struct msghdr* msg, struct timespec& receive_time )
+  {
+    for( struct cmsghdr* cmsg = CMSG_FIRSTHDR( msg ); cmsg != NULL; cmsg = CMSG_NXTHDR( const_cast<struct msghdr*>( msg ), cmsg ) )
+      {
+	if( cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS )
+	  {
+	    std::memcpy( &receive_time, CMSG_DATA( cmsg ), sizeof( struct timespec ) );
+	    return;
+	  }
+      }
+
+    clock_gettime( CLOCK_REALTIME, &receive_time );
+  }
+
+  // Have the socket report how many datagrams the kernel dropped (SO_RXQ_OVFL control messages):
+  inline bool enableDropCount( int sockfd )
+  {
+    int rxq_ovfl = 1;
+    return ( setsockopt( sockfd, SOL_SOCKET, SO_RXQ_OVFL, &rxq_ovfl, sizeof( rxq_ovfl ) ) == 0 );
+  }
+
+  // Extract the socket's total kernel drop count, which is only attached once drops have occurred:
+  inline bool getDropCount( const struct msghdr* msg, uint32_t& drops )
+  {
+    for( struct cmsghdr* cmsg = CMSG_FIRSTHDR( msg ); cmsg != NULL; cmsg = CMSG_NXTHDR( const_cast<struct msghdr*>( msg ), cmsg ) )
+      {
+	if( cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL )
+	  {
+	    std::memcpy( &drops, CMSG_DATA( cmsg ), sizeof( uint32_t ) );
+	    return true;
+	  }
+      }
+
+    return false;
+  }
+
+} // namespace ainstein_radar_drivers
+
+#endif // RECEIVE_TIMESTAMP_H_
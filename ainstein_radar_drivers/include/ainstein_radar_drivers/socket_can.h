@@ -0,0 +1,73 @@
+#ifndef SOCKET_CAN_H_
+#define SOCKET_CAN_H_
+
+#include <linux/can.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ainstein_radar_drivers
+{
+  // Raw SocketCAN socket on one CAN device (e.g. can0, or vcan0 for testing).
+  // Frames are received in batches with recvmmsg, and the kernel only passes
+  // frames with one of the IDs added with addFilter() to the socket.
+  class SocketCan
+  {
+  public:
+    explicit SocketCan( const std::string& device );
+    ~SocketCan( void );
+
+    // Accept frames with this ID, which is taken as extended (29-bit) if it does not
+    // fit a standard 11-bit ID. Filters must be added before connecting:
+    void addFilter( uint32_t id );
+
+    bool connect( void );
+    int getSocket( void ) const
+    {
+      return sockfd_;
+    }
+
+    // Block until at least one frame arrives (or the receive timeout expires), then
+    // take whatever else is queued. Returns the number of frames received, or -1:
+    int receiveFrames( void );
+    const struct can_frame& getFrame( int i ) const
+    {
+      return frames_[i];
+    }
+    const struct timespec& getReceiveTime( int i ) const
+    {
+      return receive_times_[i];
+    }
+
+    // Total number of frames the kernel dropped for lack of socket buffer space:
+    uint32_t getKernelDrops( void ) const
+    {
+      return kernel_drops_;
+    }
+
+    bool sendFrame( const struct can_frame& frame );
+
+    static const unsigned int max_batch_len;
+    static const int receive_timeout_ms;
+
+  private:
+    std::string device_;
+    int sockfd_;
+
+    std::vector<struct can_filter> filters_;
+
+    // Batched receive buffers, one frame per message:
+    std::vector<struct can_frame> frames_;
+    std::vector<struct timespec> receive_times_;
+    std::vector<char> control_;
+    std::vector<struct iovec> iovecs_;
+    std::vector<struct mmsghdr> msgs_;
+
+    uint32_t kernel_drops_;
+  };
+
+} // namespace ainstein_radar_drivers
+
+#endif // SOCKET_CAN_H_
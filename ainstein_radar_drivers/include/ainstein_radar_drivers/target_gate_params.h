@@ -0,0 +1,42 @@
+#ifndef TARGET_GATE_PARAMS_H_
+#define TARGET_GATE_PARAMS_H_
+
+#include <ros/ros.h>
+
+#include <ainstein_radar_core/radar_target_gate.h>
+
+namespace ainstein_radar_drivers
+{
+  using ainstein_radar_core::RadarTargetGate;
+
+  // Read the gate applied to raw targets while decoding from the gate/ parameters, e.g.
+  // gate/range_min or gate/snr_min. Limits which are not set leave that side open:
+  inline RadarTargetGate getTargetGateParams( ros::NodeHandle nh )
+  {
+    RadarTargetGate gate;
+    nh.param( "gate/range_min", gate.range.min, gate.range.min );
+    nh.param( "gate/range_max", gate.range.max, gate.range.max );
+    nh.param( "gate/speed_min", gate.speed.min, gate.speed.min );
+    nh.param( "gate/speed_max", gate.speed.max, gate.speed.max );
+    nh.param( "gate/azimuth_min", gate.azimuth.min, gate.azimuth.min );
+    nh.param( "gate/azimuth_max", gate.azimuth.max, gate.azimuth.max );
+    nh.param( "gate/elevation_min", gate.elevation.min, gate.elevation.min );
+    nh.param( "gate/elevation_max", gate.elevation.max, gate.elevation.max );
+    nh.param( "gate/snr_min", gate.snr.min, gate.snr.min );
+    nh.param( "gate/snr_max", gate.snr.max, gate.snr.max );
+
+    if( !gate.isOpen() )
+      {
+	ROS_INFO_STREAM( "Gating raw targets to range [" << gate.range.min << ", " << gate.range.max
+			 << "] m, speed [" << gate.speed.min << ", " << gate.speed.max
+			 << "] m/s, azimuth [" << gate.azimuth.min << ", " << gate.azimuth.max
+			 << "] deg, elevation [" << gate.elevation.min << ", " << gate.elevation.max
+			 << "] deg, SNR [" << gate.snr.min << ", " << gate.snr.max << "]" );
+      }
+
+    return gate;
+  }
+
+} // namespace ainstein_radar_drivers
+
+#endif // TARGET_GATE_PARAMS_H_
@@ -0,0 +1,138 @@
+#ifndef UDP_HANDSHAKE_H_
+#define UDP_HANDSHAKE_H_
+
+#include <netinet/in.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "udp_radar_stats.h"
+
+namespace ainstein_radar_drivers
+{
+  // Connect/run handshake with a UDP radar, as a non-blocking state machine. The radar
+  // is first listened to for a short time in case it is already streaming; otherwise
+  // the connect command is sent, and resent with exponential backoff until the connect
+  // response arrives, which is answered with the run command. The handshake is stepped
+  // with each datagram received and whenever its deadline passes, so it never blocks
+  // and can run alongside receiving. Times are steady clock seconds, from now().
+  //
+  // Once streaming, checkStream() acts as a watchdog: when no frame has arrived for the
+  // stall timeout, the handshake is run again, and a handshake which fails is retried
+  // with backoff for as long as the radar stays silent.
+  class UdpHandshake
+  {
+  public:
+    enum State { IDLE = 0, PROBING, CONNECTING, READY, FAILED };
+
+    class Parameters
+    {
+    public:
+      Parameters( void ) :
+	probe_timeout( 0.25 ),
+	response_timeout( 0.1 ),
+	max_response_timeout( 1.0 ),
+	max_attempts( 5 ),
+	stall_timeout( 0.0 ),
+	max_retry_interval( 5.0 )
+      {
+      }
+
+      double probe_timeout; // time listened for data before sending connect
+      double response_timeout; // first wait for the connect response, doubled on each retry
+      double max_response_timeout;
+      int max_attempts; // connect commands sent before giving up
+      double stall_timeout; // time without frames before reconnecting, zero disables the watchdog
+      double max_retry_interval; // longest wait before retrying a failed handshake
+    };
+
+    UdpHandshake( const std::string& connect_cmd, unsigned int connect_res_len,
+		  const std::string& run_cmd, UdpRadarStats& stats );
+
+    void setParameters( const Parameters& params )
+    {
+      params_ = params;
+    }
+
+    // Begin the handshake on a bound socket, with the radar at dest_addr:
+    void start( int sockfd, const struct sockaddr_in& dest_addr, double now );
+
+    // Step with the length of a datagram received from the radar. Returns whether it
+    // is radar data, as opposed to the connect response:
+    bool onDatagram( int len, double now );
+
+    // Step once the deadline has passed:
+    void onDeadline( double now );
+
+    // Step on the calling thread until done, waiting for datagrams into buffer:
+    bool run( char* buffer, int buffer_len );
+
+    // Watchdog, given the number of frames received so far. It must be called at least
+    // every getCheckPeriod() seconds, and returns whether the radar is streaming:
+    bool checkStream( uint64_t frames, double now );
+
+    double getCheckPeriod( void ) const
+    {
+      return ( params_.stall_timeout > 0.0 ? 0.25 * params_.stall_timeout : 3.0 );
+    }
+
+    State getState( void ) const
+    {
+      return static_cast<State>( state_.load() );
+    }
+    bool isDone( void ) const
+    {
+      State state = getState();
+      return ( state == READY || state == FAILED );
+    }
+    double getDeadline( void ) const
+    {
+      return deadline_;
+    }
+    int getNumAttempts( void ) const
+    {
+      return num_attempts_;
+    }
+
+    // Time from start until the handshake was done, or until now:
+    double getElapsed( double now ) const
+    {
+      return ( isDone() ? time_done_ : now ) - time_start_;
+    }
+
+    static double now( void );
+
+  private:
+    bool sendCommand( const std::string& cmd );
+    void sendConnect( double now );
+    void finish( State state, double now );
+    void restart( double now );
+
+    std::string connect_cmd_;
+    unsigned int connect_res_len_;
+    std::string run_cmd_;
+
+    Parameters params_;
+    UdpRadarStats& stats_;
+
+    int sockfd_;
+    struct sockaddr_in dest_addr_;
+
+    std::atomic<int> state_;
+    double deadline_;
+    double response_timeout_;
+    int num_attempts_;
+    double time_start_;
+    double time_done_;
+
+    // Watchdog state:
+    uint64_t last_frames_;
+    double last_progress_;
+    bool is_stalled_;
+    double retry_interval_;
+    double next_retry_;
+  };
+
+} // namespace ainstein_radar_drivers
+
+#endif // UDP_HANDSHAKE_H_
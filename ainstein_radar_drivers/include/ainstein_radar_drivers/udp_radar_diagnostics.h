@@ -0,0 +1,91 @@
+#ifndef UDP_RADAR_DIAGNOSTICS_H_
+#define UDP_RADAR_DIAGNOSTICS_H_
+
+#include <sstream>
+#include <string>
+
+#include <diagnostic_msgs/DiagnosticStatus.h>
+
+#include "ainstein_radar_drivers/udp_radar_stats.h"
+
+namespace ainstein_radar_drivers
+{
+  template <typename T>
+  inline void addDiagnosticValue( diagnostic_msgs::DiagnosticStatus& status, const std::string& key, const T& value )
+  {
+    std::ostringstream ss;
+    ss << value;
+
+    diagnostic_msgs::KeyValue kv;
+    kv.key = key;
+    kv.value = ss.str();
+    status.values.push_back( kv );
+  }
+
+  // Fill in the diagnostic status of one UDP radar, warning about anything lost or
+  // missing since the previous report (period seconds ago):
+  inline void fillDiagnosticStatus( const UdpRadarStats::Snapshot& stats, const UdpRadarStats::Snapshot& last,
+				    double period, diagnostic_msgs::DiagnosticStatus& status )
+  {
+    if( stats.stalls > stats.recoveries )
+      {
+	status.level = diagnostic_msgs::DiagnosticStatus::ERROR;
+	status.message = "Stream stalled, reconnecting";
+      }
+    else if( stats.datagrams_received == last.datagrams_received )
+      {
+	status.level = diagnostic_msgs::DiagnosticStatus::WARN;
+	status.message = "No data received";
+      }
+    else if( stats.kernel_drops > last.kernel_drops ||
+	     stats.datagrams_dropped > last.datagrams_dropped ||
+	     stats.datagrams_truncated > last.datagrams_truncated )
+      {
+	status.level = diagnostic_msgs::DiagnosticStatus::WARN;
+	status.message = "Datagrams lost";
+      }
+    else
+      {
+	status.level = diagnostic_msgs::DiagnosticStatus::OK;
+	status.message = "Receiving";
+      }
+
+    status.values.clear();
+    addDiagnosticValue( status, "Datagrams received", stats.datagrams_received );
+    addDiagnosticValue( status, "Datagram rate (Hz)", ( stats.datagrams_received - last.datagrams_received ) / period );
+    addDiagnosticValue( status, "Data rate (kB/s)", ( stats.bytes_received - last.bytes_received ) / period * 1e-3 );
+    addDiagnosticValue( status, "Datagrams dropped", stats.datagrams_dropped );
+    addDiagnosticValue( status, "Datagrams truncated", stats.datagrams_truncated );
+    addDiagnosticValue( status, "Kernel drops", stats.kernel_drops );
+    addDiagnosticValue( status, "Frames", stats.frames );
+    addDiagnosticValue( status, "Frame rate (Hz)", ( stats.frames - last.frames ) / period );
+
+    uint64_t datagrams = stats.datagrams_received - last.datagrams_received;
+    addDiagnosticValue( status, "Mean decode time (us)",
+			datagrams > 0 ? ( stats.decode_time_ns - last.decode_time_ns ) * 1e-3 / datagrams : 0.0 );
+    addDiagnosticValue( status, "Max decode time (us)", stats.max_decode_time_ns * 1e-3 );
+    addDiagnosticValue( status, "Stalls", stats.stalls );
+    addDiagnosticValue( status, "Last recovery time (s)", stats.last_recovery_time_ns * 1e-9 );
+    addDiagnosticValue( status, "Max recovery time (s)", stats.max_recovery_time_ns * 1e-9 );
+
+    // Cumulative inter-frame gap histogram:
+    double lower_ms = 0.0;
+    for( int i = 0; i < UdpRadarStats::num_gap_bins; ++i )
+      {
+	std::ostringstream key;
+	if( i < UdpRadarStats::num_gap_bins - 1 )
+	  {
+	    key << "Frame gaps " << lower_ms << "-" << UdpRadarStats::gapBinUpperMs( i ) << " ms";
+	    lower_ms = UdpRadarStats::gapBinUpperMs( i );
+	  }
+	else
+	  {
+	    key << "Frame gaps over " << lower_ms << " ms";
+	  }
+	addDiagnosticValue( status, key.str(), stats.gap_histogram[i] );
+      }
+  }
+
+} // namespace ainstein_radar_drivers
+
+#endif // UDP_RADAR_DIAGNOSTICS_H_
@@ -0,0 +1,184 @@
+#ifndef UDP_RADAR_STATS_H_
+#define UDP_RADAR_STATS_H_
+
+#include <time.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace ainstein_radar_drivers
+{
+  // Per-sensor receive counters. They are written only by the thread receiving
+  // from the sensor and can be read from any thread without locking.
+  class UdpRadarStats
+  {
+  public:
+    // Inter-frame gap histogram bins, bin i counting gaps below gapBinUpperMs( i ):
+    static const int num_gap_bins = 8;
+    static double gapBinUpperMs( int bin )
+    {
+      static const double upper_ms[num_gap_bins] = { 10.0, 25.0, 50.0, 75.0, 100.0, 150.0, 250.0, 1e300 };
+      return upper_ms[bin];
+    }
+
+    // Plain copy of the counters for reporting:
+    struct Snapshot
+    {
+      uint64_t datagrams_received;
+      uint64_t bytes_received;
+      uint64_t datagrams_dropped;
+      uint64_t datagrams_truncated;
+      uint64_t kernel_drops;
+      uint64_t frames;
+      uint64_t decode_time_ns;
+      uint64_t max_decode_time_ns;
+      uint64_t gap_histogram[num_gap_bins];
+      uint64_t stalls;
+      uint64_t recoveries;
+      uint64_t last_recovery_time_ns;
+      uint64_t max_recovery_time_ns;
+    };
+
+    UdpRadarStats( void ) :
+      datagrams_received_( 0 ),
+      bytes_received_( 0 ),
+      datagrams_dropped_( 0 ),
+      datagrams_truncated_( 0 ),
+      kernel_drops_( 0 ),
+      frames_( 0 ),
+      decode_time_ns_( 0 ),
+      max_decode_time_ns_( 0 ),
+      stalls_( 0 ),
+      recoveries_( 0 ),
+      last_recovery_time_ns_( 0 ),
+      max_recovery_time_ns_( 0 ),
+      has_last_frame_( false )
+    {
+      for( auto& bin : gap_histogram_ )
+	{
+	  bin.store( 0, std::memory_order_relaxed );
+	}
+    }
+
+    void recordDatagram( int len, bool truncated )
+    {
+      increment( datagrams_received_ );
+      bytes_received_.store( bytes_received_.load( std::memory_order_relaxed ) + len, std::memory_order_relaxed );
+      if( truncated )
+	{
+	  increment( datagrams_truncated_ );
+	}
+    }
+
+    // Datagrams received but discarded by the driver (malformed, truncated or unknown):
+    void recordDropped( void )
+    {
+      increment( datagrams_dropped_ );
+    }
+
+    // The socket reports the total number of datagrams the kernel dropped for lack of buffer space:
+    void setKernelDrops( uint32_t drops )
+    {
+      kernel_drops_.store( drops, std::memory_order_relaxed );
+    }
+
+    void recordDecodeTime( uint64_t ns )
+    {
+      decode_time_ns_.store( decode_time_ns_.load( std::memory_order_relaxed ) + ns, std::memory_order_relaxed );
+      if( ns > max_decode_time_ns_.load( std::memory_order_relaxed ) )
+	{
+	  max_decode_time_ns_.store( ns, std::memory_order_relaxed );
+	}
+    }
+
+    // Called with the receive time of the first datagram of each radar frame:
+    void recordFrameStart( const struct timespec& receive_time )
+    {
+      increment( frames_ );
+      if( has_last_frame_ )
+	{
+	  double gap_ms = ( receive_time.tv_sec - last_frame_time_.tv_sec ) * 1e3 +
+	    ( receive_time.tv_nsec - last_frame_time_.tv_nsec ) * 1e-6;
+	  int bin = 0;
+	  while( gap_ms >= gapBinUpperMs( bin ) && bin < num_gap_bins - 1 )
+	    {
+	      ++bin;
+	    }
+	  increment( gap_histogram_[bin] );
+	}
+      last_frame_time_ = receive_time;
+      has_last_frame_ = true;
+    }
+
+    // The stream stopped, and came back after recovery_time seconds without data:
+    void recordStall( void )
+    {
+      increment( stalls_ );
+    }
+    void recordRecovery( double recovery_time )
+    {
+      uint64_t ns = static_cast<uint64_t>( recovery_time * 1e9 );
+      increment( recoveries_ );
+      last_recovery_time_ns_.store( ns, std::memory_order_relaxed );
+      if( ns > max_recovery_time_ns_.load( std::memory_order_relaxed ) )
+	{
+	  max_recovery_time_ns_.store( ns, std::memory_order_relaxed );
+	}
+    }
+
+    uint64_t numFrames( void ) const
+    {
+      return frames_.load( std::memory_order_relaxed );
+    }
+
+    Snapshot snapshot( void ) const
+    {
+      Snapshot s;
+      s.datagrams_received = datagrams_received_.load( std::memory_order_relaxed );
+      s.bytes_received = bytes_received_.load( std::memory_order_relaxed );
+      s.datagrams_dropped = datagrams_dropped_.load( std::memory_order_relaxed );
+      s.datagrams_truncated = datagrams_truncated_.load( std::memory_order_relaxed );
+      s.kernel_drops = kernel_drops_.load( std::memory_order_relaxed );
+      s.frames = frames_.load( std::memory_order_relaxed );
+      s.decode_time_ns = decode_time_ns_.load( std::memory_order_relaxed );
+      s.max_decode_time_ns = max_decode_time_ns_.load( std::memory_order_relaxed );
+      for( int i = 0; i < num_gap_bins; ++i )
+	{
+	  s.gap_histogram[i] = gap_histogram_[i].load( std::memory_order_relaxed );
+	}
+      s.stalls = stalls_.load( std::memory_order_relaxed );
+      s.recoveries = recoveries_.load( std::memory_order_relaxed );
+      s.last_recovery_time_ns = last_recovery_time_ns_.load( std::memory_order_relaxed );
+      s.max_recovery_time_ns = max_recovery_time_ns_.load( std::memory_order_relaxed );
+      return s;
+    }
+
+  private:
+    // Single writer, so a plain load and store is enough and avoids a locked add:
+    static void increment( std::atomic<uint64_t>& counter )
+    {
+      counter.store( counter.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+    }
+
+    std::atomic<uint64_t> datagrams_received_;
+    std::atomic<uint64_t> bytes_received_;
+    std::atomic<uint64_t> datagrams_dropped_;
+    std::atomic<uint64_t> datagrams_truncated_;
+    std::atomic<uint64_t> kernel_drops_;
+    std::atomic<uint64_t> frames_;
+    std::atomic<uint64_t> decode_time_ns_;
+    std::atomic<uint64_t> max_decode_time_ns_;
+    std::atomic<uint64_t> gap_histogram_[num_gap_bins];
+    std::atomic<uint64_t> stalls_;
+    std::atomic<uint64_t> recoveries_;
+    std::atomic<uint64_t> last_recovery_time_ns_;
+    std::atomic<uint64_t> max_recovery_time_ns_;
+
+    // Only touched by the receiving thread:
+    struct timespec last_frame_time_;
+    bool has_last_frame_;
+  };
+
+} // namespace ainstein_radar_drivers
+
+#endif // UDP_RADAR_STATS_H_
@@ -0,0 +1,64 @@
+#ifndef UDP_REACTOR_H_
+#define UDP_REACTOR_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ainstein_radar_drivers
+{
+  // Single epoll loop (on one or a few threads) multiplexing the sockets of many
+  // radars. Each socket has a handler which is called when the socket becomes
+  // readable and should drain it without blocking. A given handler never runs on
+  // two threads at once.
+  class UdpReactor
+  {
+  public:
+    typedef std::function<void( void )> Handler;
+
+    explicit UdpReactor( int num_threads = 1 );
+    ~UdpReactor( void );
+
+    // Register a socket, which is switched to non-blocking mode. With a period, the handler
+    // is also called every period seconds, e.g. to notice that the socket went quiet:
+    bool addSource( int fd, Handler handler, double period = 0.0 );
+
+    // Unregister a socket, returning once its handler is guaranteed not to be running:
+    void removeSource( int fd );
+
+    // Wake all reactor threads through the eventfd and join them:
+    void stop( void );
+
+    // Reactor shared by every radar interface in the process, created on first use:
+    static std::shared_ptr<UdpReactor> instance( void );
+
+    static const int max_events;
+
+  private:
+    struct Source
+    {
+      int fd;
+      int timer_fd;
+      Handler handler;
+      bool active;
+      std::mutex mutex;
+    };
+
+    void run( void );
+    bool watch( int fd );
+
+    int epoll_fd_;
+    int event_fd_;
+
+    std::mutex sources_mutex_;
+    std::map<int, std::shared_ptr<Source>> sources_;
+
+    std::vector<std::thread> threads_;
+  };
+
+} // namespace ainstein_radar_drivers
+
+#endif // UDP_REACTOR_H_
@@ -0,0 +1,302 @@
+/*
+  Copyright <2018-2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <thread>
+
+#include "ainstein_radar_drivers/datagram_log.h"
+
+namespace ainstein_radar_drivers
+{
+  const char DatagramLog::magic[8] = { 'A', 'I', 'N', 'C', 'A', 'P', '0', '1' };
+  const unsigned int DatagramLog::record_header_len = 20;
+
+  // Capture files grow by at least this much at a time:
+  static const std::size_t capture_grow_len = 16 * 1024 * 1024;
+
+  DatagramCapture::DatagramCapture( void ) :
+    fd_( -1 ),
+    map_( nullptr ),
+    map_len_( 0 ),
+    len_( 0 )
+  {
+  }
+
+  DatagramCapture::~DatagramCapture( void )
+  {
+    close();
+  }
+
+  bool DatagramCapture::open( const std::string& filename )
+  {
+    close();
+
+    fd_ = ::open( filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+    if( fd_ < 0 )
+      {
+	std::cout << "Failed to open capture file " << filename << ": " << std::strerror( errno ) << std::endl;
+	return false;
+      }
+
+    if( !reserve( sizeof( DatagramLog::magic ) ) )
+      {
+	close();
+	return false;
+      }
+
+    std::memcpy( map_, DatagramLog::magic, sizeof( DatagramLog::magic ) );
+    len_ = sizeof( DatagramLog::magic );
+
+    return true;
+  }
+
+  void DatagramCapture::close( void )
+  {
+    if( map_ )
+      {
+	munmap( map_, map_len_ );
+	map_ = nullptr;
+      }
+
+    // Trim the preallocated tail so the file holds only the records written:
+    if( fd_ >= 0 )
+      {
+	if( ftruncate( fd_, len_ ) < 0 )
+	  {
+	    std::cout << "Failed to truncate capture file: " << std::strerror( errno ) << std::endl;
+	  }
+	::close( fd_ );
+	fd_ = -1;
+      }
+
+    map_len_ = 0;
+    len_ = 0;
+  }
+
+  bool DatagramCapture::reserve( std::size_t len )
+  {
+    if( len_ + len <= map_len_ )
+      {
+	return true;
+      }
+
+    std::size_t new_map_len = std::max( map_len_ * 2, len_ + len + capture_grow_len );
+    if( ftruncate( fd_, new_map_len ) < 0 )
+      {
+	std::cout << "Failed to grow capture file: " << std::strerror( errno ) << std::endl;
+	return false;
+      }
+
+    if( map_ )
+      {
+	munmap( map_, map_len_ );
+      }
+
+    void* map = mmap( NULL, new_map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0 );
+    if( map == MAP_FAILED )
+      {
+	std::cout << "Failed to map capture file: " << std::strerror( errno ) << std::endl;
+	map_ = nullptr;
+	map_len_ = 0;
+	return false;
+      }
+
+    map_ = static_cast<char*>( map );
+    map_len_ = new_map_len;
+
+    return true;
+  }
+
+  bool DatagramCapture::append( const char* data, int len, const struct timespec& receive_time,
+				const struct sockaddr_in& src_addr )
+  {
+    if( fd_ < 0 || len <= 0 || len > UINT16_MAX || !reserve( DatagramLog::record_header_len + len ) )
+      {
+	return false;
+      }
+
+    int64_t sec = receive_time.tv_sec;
+    int32_t nsec = receive_time.tv_nsec;
+    uint16_t msg_len = static_cast<uint16_t>( len );
+
+    char* rec = map_ + len_;
+    std::memcpy( rec + 0, &sec, sizeof( sec ) );
+    std::memcpy( rec + 8, &nsec, sizeof( nsec ) );
+    std::memcpy( rec + 12, &src_addr.sin_addr.s_addr, sizeof( src_addr.sin_addr.s_addr ) );
+    std::memcpy( rec + 16, &src_addr.sin_port, sizeof( src_addr.sin_port ) );
+    std::memcpy( rec + 18, &msg_len, sizeof( msg_len ) );
+    std::memcpy( rec + DatagramLog::record_header_len, data, len );
+
+    len_ += DatagramLog::record_header_len + len;
+
+    return true;
+  }
+
+  DatagramReplay::DatagramReplay( void ) :
+    fd_( -1 ),
+    map_( nullptr ),
+    len_( 0 ),
+    pos_( 0 ),
+    rate_( 1.0 ),
+    num_replayed_( 0 )
+  {
+  }
+
+  DatagramReplay::~DatagramReplay( void )
+  {
+    close();
+  }
+
+  bool DatagramReplay::open( const std::string& filename, double rate )
+  {
+    close();
+
+    fd_ = ::open( filename.c_str(), O_RDONLY | O_CLOEXEC );
+    if( fd_ < 0 )
+      {
+	std::cout << "Failed to open replay file " << filename << ": " << std::strerror( errno ) << std::endl;
+	return false;
+      }
+
+    struct stat st;
+    if( fstat( fd_, &st ) < 0 || static_cast<std::size_t>( st.st_size ) < sizeof( DatagramLog::magic ) )
+      {
+	std::cout << "Replay file " << filename << " is too short" << std::endl;
+	close();
+	return false;
+      }
+
+    void* map = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd_, 0 );
+    if( map == MAP_FAILED )
+      {
+	std::cout << "Failed to map replay file: " << std::strerror( errno ) << std::endl;
+	close();
+	return false;
+      }
+    map_ = static_cast<const char*>( map );
+    len_ = st.st_size;
+
+    if( std::memcmp( map_, DatagramLog::magic, sizeof( DatagramLog::magic ) ) != 0 )
+      {
+	std::cout << "Replay file " << filename << " is not a datagram capture" << std::endl;
+	close();
+	return false;
+      }
+
+    // The whole log is read front to back:
+    madvise( const_cast<char*>( map_ ), len_, MADV_SEQUENTIAL );
+
+    pos_ = sizeof( DatagramLog::magic );
+    rate_ = rate;
+    num_replayed_ = 0;
+
+    return true;
+  }
+
+  void DatagramReplay::close( void )
+  {
+    if( map_ )
+      {
+	munmap( const_cast<char*>( map_ ), len_ );
+	map_ = nullptr;
+      }
+
+    if( fd_ >= 0 )
+      {
+	::close( fd_ );
+	fd_ = -1;
+      }
+
+    len_ = 0;
+    pos_ = 0;
+  }
+
+  bool DatagramReplay::next( const char*& data, int& len, struct timespec& receive_time )
+  {
+    if( done() || pos_ + DatagramLog::record_header_len > len_ )
+      {
+	pos_ = len_;
+	return false;
+      }
+
+    int64_t sec;
+    int32_t nsec;
+    uint16_t msg_len;
+    const char* rec = map_ + pos_;
+    std::memcpy( &sec, rec + 0, sizeof( sec ) );
+    std::memcpy( &nsec, rec + 8, sizeof( nsec ) );
+    std::memcpy( &msg_len, rec + 18, sizeof( msg_len ) );
+
+    // The zero-filled tail of an unclosed capture, or a record cut short, ends the replay:
+    if( msg_len == 0 || pos_ + DatagramLog::record_header_len + msg_len > len_ )
+      {
+	pos_ = len_;
+	return false;
+      }
+
+    receive_time.tv_sec = sec;
+    receive_time.tv_nsec = nsec;
+    data = rec + DatagramLog::record_header_len;
+    len = msg_len;
+
+    // Pace the replay relative to the first datagram:
+    if( num_replayed_ == 0 )
+      {
+	first_stamp_ = receive_time;
+	first_wall_ = std::chrono::steady_clock::now();
+      }
+    else if( rate_ > 0.0 )
+      {
+	double offset = ( receive_time.tv_sec - first_stamp_.tv_sec ) + 1e-9 * ( receive_time.tv_nsec - first_stamp_.tv_nsec );
+	std::this_thread::sleep_until( first_wall_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double>( offset / rate_ ) ) );
+      }
+
+    pos_ += DatagramLog::record_header_len + msg_len;
+    ++num_replayed_;
+
+    return true;
+  }
+
+  double DatagramReplay::elapsed( void ) const
+  {
+    if( num_replayed_ == 0 )
+      {
+	return 0.0;
+      }
+
+    return std::chrono::duration<double>( std::chrono::steady_clock::now() - first_wall_ ).count();
+  }
+
+} // namespace ainstein_radar_drivers
@@ -38,6 +38,7 @@
 #include <cerrno>
 
 #include "ainstein_radar_drivers/radar_driver_o79_udp.h"
+#include "ainstein_radar_drivers/receive_timestamp.h"
 
 namespace ainstein_radar_drivers
 {
@@ -48,6 +49,7 @@ namespace ainstein_radar_drivers
   const std::string RadarDriverO79UDP::run_cmd_str = std::string( "run" );
 
   const unsigned int RadarDriverO79UDP::max_msg_len = 3000; // maximum length in bytes
+  const unsigned int RadarDriverO79UDP::max_batch_len = 16; // maximum datagrams per batched receive
   const unsigned int RadarDriverO79UDP::msg_len_raw_targets = 8; // 8 bytes per raw target
   const unsigned int RadarDriverO79UDP::msg_len_tracked_targets = 8; // 8 bytes per raw target
   const unsigned int RadarDriverO79UDP::msg_len_bounding_boxes = 9; // 9 bytes per bounding box
@@ -61,13 +63,47 @@ namespace ainstein_radar_drivers
   const unsigned int RadarDriverO79UDP::msg_id_tracked_targets_cart = 0x04;
   
   RadarDriverO79UDP::RadarDriverO79UDP( std::string host_ip_address, int host_port,
-		  std::string radar_ip_address, int radar_port ) :
+		  std::string radar_ip_address, int radar_port,
+		  bool use_batch_receive,
+		  bool use_kernel_timestamps ) :
     host_ip_addr_( host_ip_address ),
     host_port_( host_port ),
     radar_ip_addr_( radar_ip_address ),
-    radar_port_( radar_port )
+    radar_port_( radar_port ),
+    sockfd_( -1 ),
+    use_kernel_timestamps_( use_kernel_timestamps ),
+    decoder_( RadarTargetDecoder::format_o79 ),
+    decoder_raw_( RadarTargetDecoder::format_o79 ),
+    use_batch_receive_( use_batch_receive ),
+    batch_len_( 0 ),
+    batch_ind_( 0 ),
+    socket_drained_( false ),
+    use_replay_( false ),
+    handshake_( RadarDriverO79UDP::connect_cmd_str, RadarDriverO79UDP::connect_res_len, RadarDriverO79UDP::run_cmd_str, stats_ ),
+    in_raw_frame_( false )
   {
     buffer_ = static_cast<char*>( malloc( RadarDriverO79UDP::max_msg_len * sizeof( char ) ) );
+
+    // Preallocate one receive buffer per datagram for batched receives:
+    if( use_batch_receive_ )
+      {
+	batch_buffer_.resize( RadarDriverO79UDP::max_batch_len * RadarDriverO79UDP::max_msg_len );
+	batch_control_.resize( RadarDriverO79UDP::max_batch_len * receive_control_len );
+	batch_iovecs_.resize( RadarDriverO79UDP::max_batch_len );
+	batch_msgs_.resize( RadarDriverO79UDP::max_batch_len );
+	batch_addrs_.resize( RadarDriverO79UDP::max_batch_len );
+	for( int i = 0; i < RadarDriverO79UDP::max_batch_len; ++i )
+	  {
+	    batch_iovecs_.at( i ).iov_base = batch_buffer_.data() + i * RadarDriverO79UDP::max_msg_len;
+	    batch_iovecs_.at( i ).iov_len = RadarDriverO79UDP::max_msg_len;
+
+	    memset( &batch_msgs_.at( i ), 0, sizeof( struct mmsghdr ) );
+	    batch_msgs_.at( i ).msg_hdr.msg_iov = &batch_iovecs_.at( i );
+	    batch_msgs_.at( i ).msg_hdr.msg_iovlen = 1;
+	    batch_msgs_.at( i ).msg_hdr.msg_control = batch_control_.data() + i * receive_control_len;
+	    batch_msgs_.at( i ).msg_hdr.msg_name = &batch_addrs_.at( i );
+	  }
+      }
   }
 
   RadarDriverO79UDP::~RadarDriverO79UDP(void)
@@ -78,6 +114,12 @@ namespace ainstein_radar_drivers
 
   bool RadarDriverO79UDP::connect(void)
   {
+    // Replayed datagrams come from the log, there is no radar to talk to:
+    if( use_replay_ )
+      {
+	return true;
+      }
+
     // Create the host UDP socket:
     sockfd_ = socket( AF_INET, SOCK_DGRAM, 0 );
     if( sockfd_ < 0 )
@@ -106,16 +148,30 @@ namespace ainstein_radar_drivers
 	return false;
       }
 
-    // Set socket timeout:
+    // Set socket timeout, so that the stream watchdog runs while no data arrives:
+    double check_period = handshake_.getCheckPeriod();
     struct timeval tv;
-    tv.tv_sec = 3; // 3 second timeout
-    tv.tv_usec = 0;
+    tv.tv_sec = static_cast<time_t>( check_period );
+    tv.tv_usec = static_cast<suseconds_t>( ( check_period - tv.tv_sec ) * 1e6 );
     res  = setsockopt( sockfd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) );
     if( res < 0 )
       {
 	std::cout << "Failed to set socket timeout: " << std::strerror( errno ) << std::endl;
 	return false;
       }
+
+    // Optionally have the kernel timestamp each datagram on arrival:
+    if( use_kernel_timestamps_ && !enableReceiveTimestamps( sockfd_ ) )
+      {
+	std::cout << "Failed to enable kernel receive timestamps: " << std::strerror( errno ) << std::endl;
+	return false;
+      }
+
+    // Have the kernel report datagrams dropped on a full socket buffer, for diagnostics only:
+    if( !enableDropCount( sockfd_ ) )
+      {
+	std::cout << "Failed to enable socket drop counts: " << std::strerror( errno ) << std::endl;
+      }
     
     // Explicitly bind the host UDP socket:
     res = bind( sockfd_, ( struct sockaddr * )( &sockaddr_ ), sizeof( sockaddr_ ) );
@@ -125,82 +181,92 @@ namespace ainstein_radar_drivers
 	return false;
       }
 
-    // Try to receive data until the timeout to see if the O79 is already running:
-    struct sockaddr_storage src_addr;
-    socklen_t src_addr_len = sizeof( src_addr );
-    res = recvfrom( sockfd_, ( char* )buffer_, RadarDriverO79UDP::max_msg_len, MSG_WAITALL, ( struct sockaddr *)( &src_addr ), &src_addr_len );
-    if( res < 0 )
+    // Connect unless the radar is already streaming, without blocking on it for long:
+    handshake_.start( sockfd_, destaddr_, UdpHandshake::now() );
+    if( !handshake_.run( buffer_, RadarDriverO79UDP::max_msg_len ) )
       {
-	// If blocking recvfrom times out, errno is set to EAGAIN:
-	if( errno == EAGAIN )
-	  {
-	    // Send the connect command to the radar:
-	    RadarDriverO79UDP::connect_cmd_str.copy( buffer_, RadarDriverO79UDP::connect_cmd_str.length() );
-	    res = sendto( sockfd_, ( char* )buffer_, RadarDriverO79UDP::connect_cmd_str.length(), 0, ( struct sockaddr *)( &destaddr_ ), sizeof( destaddr_ ) );
-	    if( res < 0 )
-	      {
-		std::cout << "Failed to send connect command to radar: " << std::strerror( errno ) << std::endl;
-		return false;
-	      }
-
-	    // Wait for a response to the connect command:
-	    res = recvfrom( sockfd_, ( char* )buffer_, RadarDriverO79UDP::connect_res_len, MSG_WAITALL, ( struct sockaddr *)( &src_addr ), &src_addr_len );
-	    if( res < 0 )
-	      {
-		std::cout << "Failed to receive connect response from radar: " << std::strerror( errno ) << std::endl;
-		return false;
-	      }
-	    else
-	      {
-		// TODO: print settings stored on radar from connect response message
-	      }
-
-	    // Send the run command to the radar:
-	    RadarDriverO79UDP::run_cmd_str.copy( buffer_, RadarDriverO79UDP::run_cmd_str.length() );
-	    res = sendto( sockfd_, ( char* )buffer_, RadarDriverO79UDP::run_cmd_str.length(), 0, ( struct sockaddr *)( &destaddr_ ), sizeof( destaddr_ ) );
-	    if( res < 0 )
-	      {
-		std::cout << "Failed to send run command to radar: " << std::strerror( errno ) << std::endl;
-		return false;
-	      }
-	  }
-	else // encountered some error other than timeout
-	  {
-	    std::cout << "Failed when attempting to detect whether radar is running: " << std::strerror( errno ) << std::endl;
-	    return false;
-	  }
+	std::cout << "Failed to connect to radar after " << handshake_.getElapsed( UdpHandshake::now() ) << "s." << std::endl;
+	return false;
       }
-  
+
     return true;
   }
 
-  bool RadarDriverO79UDP::receiveTargets( std::vector<ainstein_radar_drivers::RadarTarget> &targets,
-					  std::vector<ainstein_radar_drivers::RadarTarget> &targets_tracked,
+  bool RadarDriverO79UDP::startCapture( const std::string& filename )
+  {
+    return capture_.open( filename );
+  }
+
+  bool RadarDriverO79UDP::startReplay( const std::string& filename, double rate )
+  {
+    use_replay_ = replay_.open( filename, rate );
+    return use_replay_;
+  }
+
+  bool RadarDriverO79UDP::receiveTargets( ainstein_radar_drivers::RadarTargetSink &targets,
+					  ainstein_radar_drivers::RadarTargetSink &targets_tracked,
 					  std::vector<ainstein_radar_drivers::BoundingBox> &bounding_boxes,
-					  std::vector<ainstein_radar_drivers::RadarTargetCartesian> &targets_tracked_cart )
+					  std::vector<ainstein_radar_drivers::RadarTargetCartesian> &targets_tracked_cart,
+					  struct timespec &receive_time )
   {
     // Clear the targets array in preparation for message processing:
     targets.clear();
     targets_tracked.clear();
     bounding_boxes.clear();
     targets_tracked_cart.clear();
+
+    // Replay mode feeds logged datagrams through the same decoding path:
+    if( use_replay_ )
+      {
+	const char* data;
+	int len;
+	if( !replay_.next( data, len, receive_time ) )
+	  {
+	    errno = ENODATA;
+	    return false;
+	  }
+	return processDatagram( data, len, false, receive_time, targets, targets_tracked, bounding_boxes, targets_tracked_cart );
+      }
+
+    // Batched mode drains all queued datagrams with a single call:
+    if( use_batch_receive_ )
+      {
+	return receiveTargetsBatch( targets, targets_tracked, bounding_boxes, targets_tracked_cart, receive_time );
+      }
     
     // Received message length:
     int msg_len;
 
-    // Received message data length (excluding header):
-    int msg_data_len;
-    
     // Structures to store where the UDP message came from:
     struct sockaddr_storage src_addr;
     socklen_t src_addr_len = sizeof( src_addr );
 
+    // Message header with room for the kernel receive timestamp:
+    struct iovec iov;
+    iov.iov_base = buffer_;
+    iov.iov_len = RadarDriverO79UDP::max_msg_len;
+
+    alignas( struct cmsghdr ) char control[receive_control_len];
+    struct msghdr msg;
+    memset( &msg, 0, sizeof( msg ) );
+    msg.msg_name = &src_addr;
+    msg.msg_namelen = src_addr_len;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof( control );
+
     // Call to block until data has been received:
-    msg_len = recvfrom( sockfd_, ( char* )buffer_, RadarDriverO79UDP::max_msg_len, MSG_WAITALL, ( struct sockaddr *)( &src_addr ), &src_addr_len );
+    msg_len = recvmsg( sockfd_, &msg, MSG_WAITALL );
+    socket_drained_ = ( msg_len < 0 );
 
     if( msg_len < 0 )
       {
-	std::cout << "Failed to read data: " << std::strerror( errno ) << std::endl;
+	// A non-blocking socket (see UdpReactor) running dry is not worth reporting:
+	if( errno != EAGAIN && errno != EWOULDBLOCK )
+	  {
+	    std::cout << "Failed to read data: " << std::strerror( errno ) << std::endl;
+	  }
 	return false;
       }
     else
@@ -210,132 +276,269 @@ namespace ainstein_radar_drivers
 	unsigned char* src_ip = ( unsigned char* )( &sin->sin_addr.s_addr );
 	// printf("source IP: %d.%d.%d.%d\n", src_ip[0], src_ip[1], src_ip[2], src_ip[3]);
 
-	// Compute length of actual data for checking payload size:
-	msg_data_len = msg_len - RadarDriverO79UDP::msg_header_len;
-	
-	// Extract the target ID and data from the message:
-	int offset;
-	ainstein_radar_drivers::RadarTarget target;
-	ainstein_radar_drivers::BoundingBox box;
-	ainstein_radar_drivers::RadarTargetCartesian target_cart;
-
-	// Check the first byte for the message type ID:
-	if( buffer_[0] == RadarDriverO79UDP::msg_id_tracked_targets )
+	// Get the time at which the datagram arrived, and the kernel's drop count if it has dropped any:
+	getReceiveTimestamp( &msg, receive_time );
+
+	uint32_t kernel_drops;
+	if( getDropCount( &msg, kernel_drops ) )
 	  {
-	    // Check data is a valid length:
-	    if( ( msg_data_len % RadarDriverO79UDP::msg_len_tracked_targets ) != 0 )
-	      {
-		std::cout << "WARNING >> Incorrect number of bytes: " << msg_len << std::endl;
-		return false;
-	      }
-	    else
+	    stats_.setKernelDrops( kernel_drops );
+	  }
+
+	// Log the datagram as received:
+	if( capture_.isOpen() )
+	  {
+	    capture_.append( buffer_, msg_len, receive_time, *sin );
+	  }
+
+	return processDatagram( buffer_, msg_len, ( msg.msg_flags & MSG_TRUNC ) != 0, receive_time,
+				targets, targets_tracked, bounding_boxes, targets_tracked_cart );
+      }
+  }
+
+  bool RadarDriverO79UDP::receiveTargetsBatch( ainstein_radar_drivers::RadarTargetSink &targets,
+					       ainstein_radar_drivers::RadarTargetSink &targets_tracked,
+					       std::vector<ainstein_radar_drivers::BoundingBox> &bounding_boxes,
+					       std::vector<ainstein_radar_drivers::RadarTargetCartesian> &targets_tracked_cart,
+					       struct timespec &receive_time )
+  {
+    // Only go back to the socket once every datagram from the previous batch has been decoded:
+    if( batch_ind_ >= batch_len_ )
+      {
+	// Reset the address and control buffer lengths, which the kernel overwrites on return:
+	for( auto& msg : batch_msgs_ )
+	  {
+	    msg.msg_hdr.msg_namelen = sizeof( struct sockaddr_in );
+	    msg.msg_hdr.msg_controllen = receive_control_len;
+	  }
+
+	// Block until at least one datagram arrives, then take whatever else is queued without blocking:
+	int res = recvmmsg( sockfd_, batch_msgs_.data(), RadarDriverO79UDP::max_batch_len, MSG_WAITFORONE, NULL );
+	socket_drained_ = ( res < 0 );
+	if( res < 0 )
+	  {
+	    if( errno != EAGAIN && errno != EWOULDBLOCK )
 	      {
-		for( int i = 0; i < ( msg_data_len / RadarDriverO79UDP::msg_len_tracked_targets ); ++i )
-		  {
-		    // Offset per target includes header
-		    offset = i * RadarDriverO79UDP::msg_len_tracked_targets + RadarDriverO79UDP::msg_header_len;
-
-		    target.id = i;
-		    target.azimuth =  static_cast<double>( static_cast<int16_t>( ( buffer_[offset + 1] & 0xff ) << 8 ) | static_cast<int16_t>( buffer_[offset + 0] & 0xff ) );
-		    target.range = static_cast<uint8_t>( buffer_[offset + 2] ) * 0.116;   // 1 count = 0.1 m
-
-		    // Speed is 0-127, with 0-64 negative (moving away) and 65-127 positive (moving towards).
-		    // Note that 65 is the highest speed moving towards, hence the manipulation below.
-		    if( static_cast<uint8_t>( buffer_[offset + 3] ) <= 64 ) // MOVING AWAY FROM RADAR
-		      {
-			target.speed = static_cast<uint8_t>( buffer_[offset + 3] ) * 0.045; // 1 count = 0.045 m/s
-		      }
-		    else // MOVING TOWARDS RADAR
-		      {
-			target.speed = ( static_cast<uint8_t>( buffer_[offset + 3] ) - 127 ) * 0.045; // 1 count = 0.045 m/s
-		      }
-
-		    target.elevation = static_cast<double>( static_cast<int16_t>( ( buffer_[offset + 5] & 0xff ) << 8 ) | static_cast<int16_t>( buffer_[offset + 4] & 0xff ) );
-		    target.snr =  static_cast<double>( static_cast<uint16_t>( ( buffer_[offset + 7] & 0xff ) << 8 ) | static_cast<uint16_t>( buffer_[offset + 6] & 0xff ) );
-
-		    targets_tracked.push_back( target );
-		  }
+		std::cout << "Failed to read data: " << std::strerror( errno ) << std::endl;
 	      }
+	    batch_len_ = 0;
+	    batch_ind_ = 0;
+	    return false;
 	  }
-	else if( buffer_[0] == RadarDriverO79UDP::msg_id_raw_targets )
+
+	batch_len_ = res;
+	batch_ind_ = 0;
+
+	// The kernel drop count is a running total, so only the latest one reported matters:
+	uint32_t kernel_drops;
+	for( int i = batch_len_ - 1; i >= 0; --i )
 	  {
-	    for( int i = 0; i < ( msg_data_len / RadarDriverO79UDP::msg_len_raw_targets ); ++i )
+	    if( getDropCount( &batch_msgs_.at( i ).msg_hdr, kernel_drops ) )
 	      {
-		offset = i * RadarDriverO79UDP::msg_len_raw_targets + RadarDriverO79UDP::msg_header_len;
-
-		target.id = i;
-		target.azimuth =  static_cast<double>( static_cast<int16_t>( ( buffer_[offset + 1] & 0xff ) << 8 ) | static_cast<int16_t>( buffer_[offset + 0] & 0xff ) );
-		target.range = static_cast<uint8_t>( buffer_[offset + 2] ) * 0.116;   // 1 count = 0.1 m
-
-		// Speed is 0-127, with 0-64 negative (moving away) and 65-127 positive (moving towards).
-		// Note that 65 is the highest speed moving towards, hence the manipulation below.
-		if( static_cast<uint8_t>( buffer_[offset + 3] ) <= 64 ) // MOVING AWAY FROM RADAR
-		  {
-		    target.speed = static_cast<uint8_t>( buffer_[offset + 3] ) * 0.045; // 1 count = 0.045 m/s
-		  }
-		else // MOVING TOWARDS RADAR
-		  {
-		    target.speed = ( static_cast<uint8_t>( buffer_[offset + 3] ) - 127 ) * 0.045; // 1 count = 0.045 m/s
-		  }
-
-		target.elevation = static_cast<double>( static_cast<int16_t>( ( buffer_[offset + 5] & 0xff ) << 8 ) | static_cast<int16_t>( buffer_[offset + 4] & 0xff ) );
-		target.snr =  static_cast<double>( static_cast<uint16_t>( ( buffer_[offset + 7] & 0xff ) << 8 ) | static_cast<uint16_t>( buffer_[offset + 6] & 0xff ) );
-
-		targets.push_back( target );
+		stats_.setKernelDrops( kernel_drops );
+		break;
 	      }
 	  }
-	else if( buffer_[0] == RadarDriverO79UDP::msg_id_bounding_boxes )
+
+	// Log every datagram of the batch as received:
+	if( capture_.isOpen() )
 	  {
-	    for( int i = 0; i < ( msg_data_len / RadarDriverO79UDP::msg_len_bounding_boxes ); ++i )
+	    struct timespec stamp;
+	    for( int i = 0; i < batch_len_; ++i )
 	      {
-		offset = i * RadarDriverO79UDP::msg_len_bounding_boxes + RadarDriverO79UDP::msg_header_len;
-
-		// Compute box pose (identity orientation, geometric center is position):
-		box.pose.linear() = Eigen::Matrix3d::Identity();
-		box.pose.translation().x() = static_cast<double>( static_cast<int16_t>( ( buffer_[offset + 1] & 0xff ) << 8 ) | static_cast<int16_t>( buffer_[offset + 0] & 0xff ) ) * 0.1; 
-		box.pose.translation().y() = static_cast<double>( static_cast<int16_t>( ( buffer_[offset + 3] & 0xff ) << 8 ) | static_cast<int16_t>( buffer_[offset + 2] & 0xff ) ) * 0.1; 
-		box.pose.translation().z() = static_cast<double>( static_cast<int16_t>( ( buffer_[offset + 5] & 0xff ) << 8 ) | static_cast<int16_t>( buffer_[offset + 4] & 0xff ) ) * 0.1; 
+		getReceiveTimestamp( &batch_msgs_.at( i ).msg_hdr, stamp );
+		capture_.append( batch_buffer_.data() + i * RadarDriverO79UDP::max_msg_len, batch_msgs_.at( i ).msg_len, stamp, batch_addrs_.at( i ) );
+	      }
+	  }
+      }
 
-		box.dimensions.x() = std::max( 0.1, static_cast<uint8_t>( buffer_[offset + 6] ) * 0.1 );
-		box.dimensions.y() = std::max( 0.1, static_cast<uint8_t>( buffer_[offset + 7] ) * 0.1 );
-		box.dimensions.z() = std::max( 0.1, static_cast<uint8_t>( buffer_[offset + 8] ) * 0.1);
+    // Decode queued datagrams in order until a message type repeats, so that one call never
+    // merges messages from two different radar frames:
+    unsigned int decoded_ids = 0;
+    int num_decoded = 0;
+    struct timespec stamp;
+    while( batch_ind_ < batch_len_ )
+      {
+	const char* buffer = batch_buffer_.data() + batch_ind_ * RadarDriverO79UDP::max_msg_len;
+	int msg_len = batch_msgs_.at( batch_ind_ ).msg_len;
+	bool truncated = ( batch_msgs_.at( batch_ind_ ).msg_hdr.msg_flags & MSG_TRUNC ) != 0;
+
+	// IDs too large for the bitmask are invalid anyway and never end the batch:
+	unsigned int msg_id = static_cast<uint8_t>( buffer[0] );
+	unsigned int msg_id_bit = ( msg_id < 32 ) ? ( 1u << msg_id ) : 0u;
+	if( ( decoded_ids & msg_id_bit ) != 0 )
+	  {
+	    break;
+	  }
 
-		bounding_boxes.push_back( box );
-	      }
+	// Stamp the call with the arrival time of its first datagram:
+	getReceiveTimestamp( &batch_msgs_.at( batch_ind_ ).msg_hdr, stamp );
+	if( num_decoded == 0 )
+	  {
+	    receive_time = stamp;
 	  }
-	else if( buffer_[0] == RadarDriverO79UDP::msg_id_tracked_targets_cart )
+
+	if( !processDatagram( buffer, msg_len, truncated, stamp, targets, targets_tracked, bounding_boxes, targets_tracked_cart ) )
 	  {
-	    // Check data is a valid length:
-	    if( ( msg_data_len % RadarDriverO79UDP::msg_len_tracked_targets_cart ) != 0 )
+	    // Report a malformed datagram on its own call so the messages before it still get published:
+	    if( num_decoded == 0 )
 	      {
-		std::cout << "WARNING >> Incorrect number of bytes: " << msg_len << std::endl;
+		++batch_ind_;
 		return false;
 	      }
-	    else
-	      {
-		for( int i = 0; i < ( msg_data_len / RadarDriverO79UDP::msg_len_tracked_targets_cart ); ++i )
-		  {
-		    // Offset per target includes header
-		    offset = i * RadarDriverO79UDP::msg_len_tracked_targets_cart + RadarDriverO79UDP::msg_header_len;
+	    break;
+	  }
 
-		    target_cart.pos.x() = static_cast<double>( static_cast<int16_t>( ( buffer_[offset + 1] & 0xff ) << 8 ) | static_cast<int16_t>( buffer_[offset + 0] & 0xff ) ) * 0.1; 
-		    target_cart.pos.y() = static_cast<double>( static_cast<int16_t>( ( buffer_[offset + 3] & 0xff ) << 8 ) | static_cast<int16_t>( buffer_[offset + 2] & 0xff ) ) * 0.1; 
-		    target_cart.pos.z() = static_cast<double>( static_cast<int16_t>( ( buffer_[offset + 5] & 0xff ) << 8 ) | static_cast<int16_t>( buffer_[offset + 4] & 0xff ) ) * 0.1; 
+	decoded_ids |= msg_id_bit;
+	++num_decoded;
+	++batch_ind_;
+      }
 
-		    target_cart.vel.x() = static_cast<double>( static_cast<int16_t>( ( buffer_[offset + 7] & 0xff ) << 8 ) | static_cast<int16_t>( buffer_[offset + 6] & 0xff ) ) * 0.1; 
-		    target_cart.vel.y() = static_cast<double>( static_cast<int16_t>( ( buffer_[offset + 9] & 0xff ) << 8 ) | static_cast<int16_t>( buffer_[offset + 8] & 0xff ) ) * 0.1; 
-		    target_cart.vel.z() = static_cast<double>( static_cast<int16_t>( ( buffer_[offset + 11] & 0xff ) << 8 ) | static_cast<int16_t>( buffer_[offset + 10] & 0xff ) ) * 0.1; 
+    return true;
+  }
 
-		    targets_tracked_cart.push_back( target_cart );
-		  }
-	      }
-	    
+  bool RadarDriverO79UDP::processDatagram( const char* buffer, int msg_len, bool truncated,
+					   const struct timespec &receive_time,
+					   ainstein_radar_drivers::RadarTargetSink &targets,
+					   ainstein_radar_drivers::RadarTargetSink &targets_tracked,
+					   std::vector<ainstein_radar_drivers::BoundingBox> &bounding_boxes,
+					   std::vector<ainstein_radar_drivers::RadarTargetCartesian> &targets_tracked_cart )
+  {
+    stats_.recordDatagram( msg_len, truncated );
+
+    // Datagrams arriving while (re)connecting step the handshake, which consumes the connect response:
+    if( handshake_.getState() != UdpHandshake::READY && !handshake_.onDatagram( msg_len, UdpHandshake::now() ) )
+      {
+	errno = EAGAIN;
+	return false;
+      }
+
+    // A datagram longer than the receive buffer has lost its tail, so none of it is decoded:
+    if( truncated )
+      {
+	std::cout << "WARNING >> Datagram truncated to " << msg_len << " bytes." << std::endl;
+	stats_.recordDropped();
+	errno = EMSGSIZE;
+	return false;
+      }
+
+    // Raw targets start a new frame unless they continue a full-length raw targets datagram:
+    bool is_raw = ( msg_len >= static_cast<int>( RadarDriverO79UDP::msg_header_len ) &&
+		    buffer[0] == RadarDriverO79UDP::msg_id_raw_targets );
+    if( is_raw && !in_raw_frame_ )
+      {
+	stats_.recordFrameStart( receive_time );
+      }
+    in_raw_frame_ = ( is_raw && msg_len == static_cast<int>( RadarDriverO79UDP::max_msg_len ) );
+
+    struct timespec decode_start, decode_end;
+    clock_gettime( CLOCK_MONOTONIC, &decode_start );
+    bool res = decodeMessage( buffer, msg_len, targets, targets_tracked, bounding_boxes, targets_tracked_cart );
+    clock_gettime( CLOCK_MONOTONIC, &decode_end );
+    stats_.recordDecodeTime( ( decode_end.tv_sec - decode_start.tv_sec ) * 1000000000ull + decode_end.tv_nsec - decode_start.tv_nsec );
+
+    return res;
+  }
+
+  bool RadarDriverO79UDP::decodeMessage( const char* buffer, int msg_len,
+					 ainstein_radar_drivers::RadarTargetSink &targets,
+					 ainstein_radar_drivers::RadarTargetSink &targets_tracked,
+					 std::vector<ainstein_radar_drivers::BoundingBox> &bounding_boxes,
+					 std::vector<ainstein_radar_drivers::RadarTargetCartesian> &targets_tracked_cart )
+  {
+    // A datagram shorter than the header would make the payload length below negative:
+    if( msg_len < static_cast<int>( RadarDriverO79UDP::msg_header_len ) )
+      {
+	std::cout << "WARNING >> Incorrect number of bytes: " << msg_len << std::endl;
+	stats_.recordDropped();
+	errno = EBADMSG;
+	return false;
+      }
+
+    // Compute length of actual data for checking payload size:
+    int msg_data_len = msg_len - RadarDriverO79UDP::msg_header_len;
+
+    // Extract the target ID and data from the message:
+    int offset;
+    ainstein_radar_drivers::BoundingBox box;
+    ainstein_radar_drivers::RadarTargetCartesian target_cart;
+
+    // Check the first byte for the message type ID:
+    if( buffer[0] == RadarDriverO79UDP::msg_id_tracked_targets )
+      {
+	// Check data is a valid length:
+	if( ( msg_data_len % RadarDriverO79UDP::msg_len_tracked_targets ) != 0 )
+	  {
+	    std::cout << "WARNING >> Incorrect number of bytes: " << msg_len << std::endl;
+	    stats_.recordDropped();
+	    errno = EBADMSG;
+	    return false;
 	  }
 	else
 	  {
-	    std::cout << "WARNING >> Message received with invalid ID." << std::endl;
+	    targets_tracked.append( decoder_, buffer + RadarDriverO79UDP::msg_header_len,
+				    msg_data_len / static_cast<int>( RadarDriverO79UDP::msg_len_tracked_targets ), 0 );
 	  }
       }
+    else if( buffer[0] == RadarDriverO79UDP::msg_id_raw_targets )
+      {
+	targets.append( decoder_raw_, buffer + RadarDriverO79UDP::msg_header_len,
+			msg_data_len / static_cast<int>( RadarDriverO79UDP::msg_len_raw_targets ), 0 );
+      }
+    else if( buffer[0] == RadarDriverO79UDP::msg_id_bounding_boxes )
+      {
+	for( int i = 0; i < ( msg_data_len / RadarDriverO79UDP::msg_len_bounding_boxes ); ++i )
+	  {
+	    offset = i * RadarDriverO79UDP::msg_len_bounding_boxes + RadarDriverO79UDP::msg_header_len;
+
+	    // Compute box pose (identity orientation, geometric center is position):
+	    box.pose.linear() = Eigen::Matrix3d::Identity();
+	    box.pose.translation().x() = static_cast<double>( static_cast<int16_t>( ( buffer[offset + 1] & 0xff ) << 8 ) | static_cast<int16_t>( buffer[offset + 0] & 0xff ) ) * 0.1; 
+	    box.pose.translation().y() = static_cast<double>( static_cast<int16_t>( ( buffer[offset + 3] & 0xff ) << 8 ) | static_cast<int16_t>( buffer[offset + 2] & 0xff ) ) * 0.1; 
+	    box.pose.translation().z() = static_cast<double>( static_cast<int16_t>( ( buffer[offset + 5] & 0xff ) << 8 ) | static_cast<int16_t>( buffer[offset + 4] & 0xff ) ) * 0.1; 
+
+	    box.dimensions.x() = std::max( 0.1, static_cast<uint8_t>( buffer[offset + 6] ) * 0.1 );
+	    box.dimensions.y() = std::max( 0.1, static_cast<uint8_t>( buffer[offset + 7] ) * 0.1 );
+	    box.dimensions.z() = std::max( 0.1, static_cast<uint8_t>( buffer[offset + 8] ) * 0.1);
+
+	    bounding_boxes.push_back( box );
+	  }
+      }
+    else if( buffer[0] == RadarDriverO79UDP::msg_id_tracked_targets_cart )
+      {
+	// Check data is a valid length:
+	if( ( msg_data_len % RadarDriverO79UDP::msg_len_tracked_targets_cart ) != 0 )
+	  {
+	    std::cout << "WARNING >> Incorrect number of bytes: " << msg_len << std::endl;
+	    stats_.recordDropped();
+	    errno = EBADMSG;
+	    return false;
+	  }
+	else
+	  {
+	    for( int i = 0; i < ( msg_data_len / RadarDriverO79UDP::msg_len_tracked_targets_cart ); ++i )
+	      {
+		// Offset per target includes header
+		offset = i * RadarDriverO79UDP::msg_len_tracked_targets_cart + RadarDriverO79UDP::msg_header_len;
+
+		target_cart.pos.x() = static_cast<double>( static_cast<int16_t>( ( buffer[offset + 1] & 0xff ) << 8 ) | static_cast<int16_t>( buffer[offset + 0] & 0xff ) ) * 0.1; 
+		target_cart.pos.y() = static_cast<double>( static_cast<int16_t>( ( buffer[offset + 3] & 0xff ) << 8 ) | static_cast<int16_t>( buffer[offset + 2] & 0xff ) ) * 0.1; 
+		target_cart.pos.z() = static_cast<double>( static_cast<int16_t>( ( buffer[offset + 5] & 0xff ) << 8 ) | static_cast<int16_t>( buffer[offset + 4] & 0xff ) ) * 0.1; 
+
+		target_cart.vel.x() = static_cast<double>( static_cast<int16_t>( ( buffer[offset + 7] & 0xff ) << 8 ) | static_cast<int16_t>( buffer[offset + 6] & 0xff ) ) * 0.1; 
+		target_cart.vel.y() = static_cast<double>( static_cast<int16_t>( ( buffer[offset + 9] & 0xff ) << 8 ) | static_cast<int16_t>( buffer[offset + 8] & 0xff ) ) * 0.1; 
+		target_cart.vel.z() = static_cast<double>( static_cast<int16_t>( ( buffer[offset + 11] & 0xff ) << 8 ) | static_cast<int16_t>( buffer[offset + 10] & 0xff ) ) * 0.1; 
+
+		targets_tracked_cart.push_back( target_cart );
+	      }
+	  }
+	    
+      }
+    else
+      {
+	std::cout << "WARNING >> Message received with invalid ID." << std::endl;
+	stats_.recordDropped();
+      }
 
     return true;
   }
@@ -35,6 +35,8 @@
 #include <iostream>
 #include <cstdint>
 #include <cerrno>
+#include <functional>
+#include <algorithm>
 
 #include "ainstein_radar_drivers/radar_interface_k79.h"
 
@@ -45,8 +47,7 @@ RadarInterfaceK79::RadarInterfaceK79( ros::NodeHandle node_handle,
 				      ros::NodeHandle node_handle_private ) :
   nh_( node_handle ),
   nh_private_( node_handle_private ),
-  radar_data_msg_ptr_raw_( new ainstein_radar_msgs::RadarTargetArray ),
-  radar_data_msg_ptr_tracked_( new ainstein_radar_msgs::RadarTargetArray ),
+  last_stats_(),
   radar_info_msg_ptr_( new ainstein_radar_msgs::RadarInfo )
 {
   // Get the host IP and port:
@@ -66,28 +67,132 @@ RadarInterfaceK79::RadarInterfaceK79( ros::NodeHandle node_handle,
   // Get the radar data frame ID:
   nh_private_.param( "frame_id", frame_id_, std::string( "map" ) );
 
-  // Set the frame ID:
-  radar_data_msg_ptr_raw_->header.frame_id = frame_id_;
-  radar_data_msg_ptr_tracked_->header.frame_id = frame_id_;
+  // Get whether to drain all queued datagrams with one batched receive call:
+  bool batch_receive;
+  nh_private_.param( "batch_receive", batch_receive, false );
+
+  // Get whether to stamp frames with the kernel receive time instead of the publish time:
+  nh_private_.param( "use_kernel_timestamps", use_kernel_timestamps_, false );
+
+  // Get whether to receive on the process-wide reactor instead of a dedicated thread:
+  bool use_reactor;
+  nh_private_.param( "use_reactor", use_reactor, false );
+  if( use_reactor )
+    {
+      reactor_ = UdpReactor::instance();
+    }
+
+  // Get the period at which receive diagnostics are published, zero to disable them:
+  nh_private_.param( "diagnostics_period", diagnostics_period_, 1.0 );
+
+  // Get the depth of the receive-to-publish queue, zero to publish from the receiving thread:
+  int publish_queue_size;
+  nh_private_.param( "publish_queue_size", publish_queue_size, 0 );
+
+  // Get whether a full queue drops the oldest queued frame or the newly received one:
+  std::string publish_queue_overflow;
+  nh_private_.param( "publish_queue_overflow", publish_queue_overflow, std::string( "drop_oldest" ) );
+
+  // Targets are decoded straight into preallocated frames:
+  if( publish_queue_size > 0 )
+    {
+      FrameRing<Frame>::OverflowPolicy policy = FrameRing<Frame>::DROP_OLDEST;
+      if( publish_queue_overflow == "drop_newest" )
+	{
+	  policy = FrameRing<Frame>::DROP_NEWEST;
+	}
+      else if( publish_queue_overflow != "drop_oldest" )
+	{
+	  ROS_WARN_STREAM( "Unknown publish_queue_overflow " << publish_queue_overflow << ", using drop_oldest" << std::endl );
+	}
+
+      ring_.reset( new FrameRing<Frame>( publish_queue_size, policy ) );
+      for( std::size_t i = 0; i < ring_->numSlots(); ++i )
+	{
+	  initFrame( ring_->slot( i ) );
+	}
+    }
+  else
+    {
+      initFrame( frame_ );
+    }
 
   // Publish the RadarInfo message:
   publishRadarInfo();
   
   // Create the radar driver object:
   driver_.reset( new RadarDriverK79( host_ip_addr, host_port,
-				     radar_ip_addr, radar_port ) );
-  
-  // Start the data collection thread:
-  thread_ = std::unique_ptr<std::thread>( new std::thread( &RadarInterfaceK79::mainLoop, this ) );
-  mutex_.lock();
-  is_running_ = true;
-  mutex_.unlock();
+				     radar_ip_addr, radar_port,
+				     batch_receive, use_kernel_timestamps_ ) );
+
+  // Optionally replay a capture log instead of talking to the radar, or capture what is received:
+  std::string capture_file;
+  nh_private_.param( "capture_file", capture_file, std::string( "" ) );
+
+  std::string replay_file;
+  nh_private_.param( "replay_file", replay_file, std::string( "" ) );
+
+  double replay_rate;
+  nh_private_.param( "replay_rate", replay_rate, 1.0 );
+
+  if( !replay_file.empty() )
+    {
+      if( !driver_->startReplay( replay_file, replay_rate ) )
+	{
+	  ROS_ERROR_STREAM( "Failed to open replay file " << replay_file << std::endl );
+	}
+
+      // Replay has no socket to wait on, so it always runs on its own thread:
+      reactor_.reset();
+    }
+  else if( !capture_file.empty() && !driver_->startCapture( capture_file ) )
+    {
+      ROS_ERROR_STREAM( "Failed to open capture file " << capture_file << std::endl );
+    }
+
+  // Get the handshake timing, short by default so that startup does not wait on the radar:
+  UdpHandshake::Parameters handshake_params;
+  nh_private_.param( "handshake_probe_timeout", handshake_params.probe_timeout, handshake_params.probe_timeout );
+  nh_private_.param( "handshake_response_timeout", handshake_params.response_timeout, handshake_params.response_timeout );
+  nh_private_.param( "handshake_max_attempts", handshake_params.max_attempts, handshake_params.max_attempts );
 
+  // Reconnect after this many frame periods without data, zero disables the watchdog:
+  double stall_timeout_frames;
+  nh_private_.param( "stall_timeout_frames", stall_timeout_frames, 5.0 );
+  handshake_params.stall_timeout = stall_timeout_frames / RadarInterfaceK79::UPDATE_RATE;
+  driver_->setHandshakeParameters( handshake_params );
+
+  // Drop raw targets outside the gate while decoding:
+  driver_->setTargetGate( getTargetGateParams( nh_private_ ) );
+  
   // Advertise the K79 raw targets data:
   pub_radar_data_raw_ = nh_private_.advertise<ainstein_radar_msgs::RadarTargetArray>( "targets/raw", 10 );
 
   // Advertise the K79 tracked targets data:
   pub_radar_data_tracked_ = nh_private_.advertise<ainstein_radar_msgs::RadarTargetArray>( "targets/tracked", 10 );
+
+  // Advertise whether the radar is streaming (LATCHED), false until the handshake completes:
+  pub_ready_ = nh_private_.advertise<std_msgs::Bool>( "ready", 1, true );
+  publishReady( false );
+
+  // Publish receive diagnostics for this radar periodically:
+  if( diagnostics_period_ > 0.0 )
+    {
+      diagnostic_status_.name = nh_private_.getNamespace();
+      diagnostic_status_.hardware_id = radar_ip_addr;
+      pub_diagnostics_ = nh_.advertise<diagnostic_msgs::DiagnosticArray>( "/diagnostics", 10 );
+      diagnostics_timer_ = nh_.createTimer( ros::Duration( diagnostics_period_ ), &RadarInterfaceK79::publishDiagnostics, this );
+    }
+
+  // Start the data collection thread, and the publishing thread if frames are handed off:
+  mutex_.lock();
+  is_running_ = true;
+  mutex_.unlock();
+  thread_ = std::unique_ptr<std::thread>( new std::thread( &RadarInterfaceK79::mainLoop, this ) );
+  if( ring_ )
+    {
+      publish_thread_ = std::unique_ptr<std::thread>( new std::thread( &RadarInterfaceK79::publishLoop, this ) );
+    }
 }
 
 RadarInterfaceK79::~RadarInterfaceK79(void)
@@ -96,54 +201,111 @@ RadarInterfaceK79::~RadarInterfaceK79(void)
   is_running_ = false;
   mutex_.unlock();
   thread_->join();
+
+  // Make sure the reactor is no longer calling into this interface:
+  if( reactor_ )
+    {
+      reactor_->removeSource( driver_->getSocket() );
+    }
+
+  // Stop the publishing thread once nothing more is being received:
+  if( publish_thread_ )
+    {
+      ring_->notify();
+      publish_thread_->join();
+
+      ROS_INFO_STREAM( "Receive stage: " << ring_->numPushed() << " frames, " << ring_->numDropped()
+		       << " dropped; publish stage: " << ring_->numPopped() << " frames" );
+    }
 } 
 
+void RadarInterfaceK79::initFrame( Frame& frame )
+{
+  frame.targets_raw.header.frame_id = frame_id_;
+  frame.targets_tracked.header.frame_id = frame_id_;
+  frame.sink_raw.reset( new RadarTargetArraySink( frame.targets_raw ) );
+  frame.sink_tracked.reset( new RadarTargetArraySink( frame.targets_tracked ) );
+}
+
+bool RadarInterfaceK79::receiveFrame( void )
+{
+  Frame& frame = ring_ ? ring_->writeSlot() : frame_;
+
+  // Only fill the target arrays someone subscribes to, nodelets in the same process included:
+  frame.sink_raw->setOutputs( pub_radar_data_raw_.getNumSubscribers() > 0, false );
+  frame.sink_tracked->setOutputs( pub_radar_data_tracked_.getNumSubscribers() > 0, false );
+
+  if( !driver_->receiveTargets( *frame.sink_raw, *frame.sink_tracked, frame.receive_time ) )
+    {
+      return false;
+    }
+
+  // Decoding is done once the driver returns, before any hand-off to the publishing thread:
+  frame.decode_time = ros::Time::now();
+
+  // Hand the frame to the publishing thread, or publish it from here:
+  if( ring_ )
+    {
+      if( !ring_->push() )
+	{
+	  ROS_WARN_STREAM_THROTTLE( 1.0, "Publishing is falling behind, " << ring_->numDropped() << " frames dropped so far" );
+	}
+    }
+  else
+    {
+      publishFrame( frame );
+    }
+
+  return true;
+}
+
 void RadarInterfaceK79::mainLoop(void)
 {
-  // Connect to the radar:
-  driver_->connect();
+  // Connect to the radar, then signal whether it is streaming:
+  if( !driver_->connect() )
+    {
+      ROS_ERROR_STREAM( "Failed to connect to the radar, waiting for it to start streaming" );
+    }
+  else if( !driver_->isReplaying() )
+    {
+      ROS_INFO_STREAM( "Radar ready after " << driver_->getHandshake().getElapsed( UdpHandshake::now() ) << " s" );
+    }
+  publishReady( driver_->isReady() );
+
+  // In reactor mode, the shared reactor receives from the socket from here on:
+  if( reactor_ )
+    {
+      if( !reactor_->addSource( driver_->getSocket(), std::bind( &RadarInterfaceK79::onReadable, this ),
+				driver_->getHandshake().getCheckPeriod() ) )
+	{
+	  ROS_ERROR_STREAM( "Failed to register the radar socket with the reactor." << std::endl );
+	}
+      return;
+    }
   
   // Enter the main data receiving loop:
   bool running = true;
-  std::vector<ainstein_radar_drivers::RadarTarget> targets_raw;
-  std::vector<ainstein_radar_drivers::RadarTarget> targets_tracked;
   while( running && !ros::isShuttingDown() )
     {
       // Call to block until data has been received:
-      if( driver_->receiveTargets( targets_raw, targets_tracked ) == false )
+      if( receiveFrame() == false )
 	{
-	  ROS_WARN_STREAM( "Failed to read data: " << std::strerror( errno ) << std::endl );
-	}
-      else
-	{
-	  if( targets_raw.size() > 0 )
+	  // Stop at the end of a replayed log and report the throughput achieved:
+	  if( driver_->isReplaying() && driver_->getReplay().done() )
 	    {
-	      // Fill in the raw RadarTargetArray message from the received targets:
-	      radar_data_msg_ptr_raw_->header.stamp = ros::Time::now();
-	      radar_data_msg_ptr_raw_->targets.clear();
-	      for( const auto &t : targets_raw )
-		{
-		  radar_data_msg_ptr_raw_->targets.push_back( targetToROSMsg( t ) );
-		}
-	      
-	      // Publish the raw target data:
-	      pub_radar_data_raw_.publish( radar_data_msg_ptr_raw_ );
+	      const DatagramReplay& replay = driver_->getReplay();
+	      ROS_INFO_STREAM( "Replayed " << replay.numReplayed() << " datagrams in " << replay.elapsed() << " s ("
+			       << replay.numReplayed() / std::max( replay.elapsed(), 1e-9 ) << " datagrams/s)" );
+	      break;
 	    }
 
-	  if( targets_tracked.size() > 0 )
+	  // Timeouts only wake the loop up to check the stream:
+	  if( errno != EAGAIN && errno != EWOULDBLOCK )
 	    {
-	      // Fill in the tracked RadarTargetArray message from the received targets:
-	      radar_data_msg_ptr_tracked_->header.stamp = ros::Time::now();
-	      radar_data_msg_ptr_tracked_->targets.clear();
-	      for( const auto &t : targets_tracked )
-		{
-		  radar_data_msg_ptr_tracked_->targets.push_back( targetToROSMsg( t ) );
-		}
-	  
-	      // Publish the tracked target data:
-	      pub_radar_data_tracked_.publish( radar_data_msg_ptr_tracked_ );
+	      ROS_WARN_STREAM( "Failed to read data: " << std::strerror( errno ) << std::endl );
 	    }
-	} 
+	}
+      checkStream();
 
       // Check whether the data loop should still be running:
       mutex_.lock();
@@ -152,6 +314,116 @@ void RadarInterfaceK79::mainLoop(void)
     }
 }
 
+void RadarInterfaceK79::onReadable(void)
+{
+  // The socket is non-blocking in reactor mode, so drain every queued datagram. A datagram
+  // that is not decoded does not mean the socket or the batch is drained, so keep going:
+  while( true )
+    {
+      if( receiveFrame() )
+	{
+	  continue;
+	}
+
+      if( errno != EAGAIN && errno != EWOULDBLOCK )
+	{
+	  ROS_WARN_STREAM( "Failed to read data: " << std::strerror( errno ) << std::endl );
+	}
+      if( driver_->isDrained() )
+	{
+	  break;
+	}
+    }
+
+  // Also called periodically by the reactor, so a silent socket is noticed:
+  checkStream();
+}
+
+void RadarInterfaceK79::checkStream( void )
+{
+  // Reconnects if the stream stalled, and publishes when the radar starts or stops streaming:
+  bool ready = driver_->checkStream();
+  if( ready != is_ready_ )
+    {
+      if( !ready )
+	{
+	  ROS_WARN_STREAM( "Radar stopped streaming, reconnecting" );
+	}
+      publishReady( ready );
+    }
+}
+
+void RadarInterfaceK79::publishLoop( void )
+{
+  bool running = true;
+  while( running && !ros::isShuttingDown() )
+    {
+      // Publish everything queued, then wait for the receiving thread to push more:
+      while( Frame* frame = ring_->pop() )
+	{
+	  publishFrame( *frame );
+	}
+      ring_->wait( 100 );
+
+      // Check whether the publishing loop should still be running:
+      mutex_.lock();
+      running = is_running_;
+      mutex_.unlock();
+    }
+}
+
+void RadarInterfaceK79::publishFrame( Frame& frame )
+{
+  // Stamp the frame with the kernel receive time if requested, otherwise the decode time:
+  const ros::Time receive_time( frame.receive_time.tv_sec, frame.receive_time.tv_nsec );
+  const ros::Time& decode_time = frame.decode_time;
+  ros::Time stamp = use_kernel_timestamps_ ? receive_time : decode_time;
+
+  // Every message is published fresh and never touched again, so nodelet subscribers can share it:
+  if( frame.sink_raw->size() > 0 && frame.sink_raw->fillsTargets() )
+    {
+      // Publish the raw target data:
+      pub_radar_data_raw_.publish( frame.sink_raw->takeMessage( stamp ) );
+    }
+
+  if( frame.sink_tracked->size() > 0 && frame.sink_tracked->fillsTargets() )
+    {
+      // Publish the tracked target data:
+      pub_radar_data_tracked_.publish( frame.sink_tracked->takeMessage( stamp ) );
+    }
+
+  // Report the per-frame latency from socket arrival through decoding to publishing:
+  ROS_DEBUG_STREAM( "Frame receive-to-decode delay: " << ( decode_time - receive_time ).toSec()
+		    << " s, decode-to-publish delay: " << ( ros::Time::now() - decode_time ).toSec() << " s" );
+}
+
+void RadarInterfaceK79::publishReady( bool ready )
+{
+  is_ready_ = ready;
+
+  std_msgs::Bool msg;
+  msg.data = ready;
+  pub_ready_.publish( msg );
+}
+
+void RadarInterfaceK79::publishDiagnostics( const ros::TimerEvent& event )
+{
+  UdpRadarStats::Snapshot stats = driver_->getStats().snapshot();
+  fillDiagnosticStatus( stats, last_stats_, diagnostics_period_, diagnostic_status_ );
+  last_stats_ = stats;
+
+  // Report frames lost between receiving and publishing too:
+  if( ring_ )
+    {
+      addDiagnosticValue( diagnostic_status_, "Frames dropped before publishing", ring_->numDropped() );
+    }
+
+  diagnostic_msgs::DiagnosticArray diagnostics;
+  diagnostics.header.stamp = ros::Time::now();
+  diagnostics.status.push_back( diagnostic_status_ );
+  pub_diagnostics_.publish( diagnostics );
+}
+
   void RadarInterfaceK79::publishRadarInfo( void )
   {    
     // Advertise the K79 sensor info (LATCHED):
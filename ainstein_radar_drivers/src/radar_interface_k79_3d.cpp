@@ -35,8 +35,10 @@
 #include <iostream>
 #include <cstdint>
 #include <cerrno>
+#include <functional>
 
 #include "ainstein_radar_drivers/radar_interface_k79_3d.h"
+#include "ainstein_radar_drivers/receive_timestamp.h"
 
 namespace ainstein_radar_drivers
 {
@@ -51,9 +53,13 @@ const unsigned int RadarInterfaceK793D::target_msg_len = TARGET_MSG_LEN;
 
 RadarInterfaceK793D::RadarInterfaceK793D( ros::NodeHandle node_handle,
 				      ros::NodeHandle node_handle_private ) :
+  handshake_( RadarInterfaceK793D::connect_cmd_str, RadarInterfaceK793D::connect_res_len,
+	      RadarInterfaceK793D::run_cmd_str, stats_ ),
+  is_ready_( false ),
   nh_( node_handle ),
   nh_private_( node_handle_private ),
-  radar_data_msg_ptr_raw_( new ainstein_radar_msgs::RadarTargetArray )
+  radar_data_msg_ptr_raw_( new ainstein_radar_msgs::RadarTargetArray ),
+  decoder_( RadarTargetDecoder::format_k79_3d )
 {
   // Store the host IP and port:
   nh_private_.param( "host_ip", host_ip_addr_, std::string( "10.0.0.75" ) );
@@ -66,6 +72,32 @@ RadarInterfaceK793D::RadarInterfaceK793D( ros::NodeHandle node_handle,
   // Store the radar data frame ID:
   nh_private_.param( "frame_id", frame_id_, std::string( "map" ) );
 
+  // Drop raw targets outside the gate while decoding:
+  decoder_.setGate( getTargetGateParams( nh_private_ ) );
+
+  // Store whether to stamp frames with the kernel receive time instead of the publish time:
+  nh_private_.param( "use_kernel_timestamps", use_kernel_timestamps_, false );
+
+  // Get the handshake timing, short by default so that startup does not wait on the radar:
+  UdpHandshake::Parameters handshake_params;
+  nh_private_.param( "handshake_probe_timeout", handshake_params.probe_timeout, handshake_params.probe_timeout );
+  nh_private_.param( "handshake_response_timeout", handshake_params.response_timeout, handshake_params.response_timeout );
+  nh_private_.param( "handshake_max_attempts", handshake_params.max_attempts, handshake_params.max_attempts );
+
+  // Reconnect after this many frame periods without data, zero disables the watchdog:
+  double stall_timeout_frames;
+  nh_private_.param( "stall_timeout_frames", stall_timeout_frames, 5.0 );
+  handshake_params.stall_timeout = stall_timeout_frames / RadarInterfaceK793D::UPDATE_RATE;
+  handshake_.setParameters( handshake_params );
+
+  // Store whether to receive on the process-wide reactor instead of a dedicated thread:
+  bool use_reactor;
+  nh_private_.param( "use_reactor", use_reactor, false );
+  if( use_reactor )
+    {
+      reactor_ = UdpReactor::instance();
+    }
+
   // Set the frame ID:
   radar_data_msg_ptr_raw_->header.frame_id = frame_id_;
 }
@@ -76,7 +108,16 @@ RadarInterfaceK793D::~RadarInterfaceK793D(void)
   is_running_ = false;
   mutex_.unlock();
 
-  thread_->join();
+  if( thread_ )
+    {
+      thread_->join();
+    }
+
+  // Make sure the reactor is no longer reading the socket before closing it:
+  if( reactor_ )
+    {
+      reactor_->removeSource( sockfd_ );
+    }
 
   close( sockfd_ );
 }
@@ -111,16 +152,30 @@ bool RadarInterfaceK793D::connect(void)
       return false;
     }
 
-  // Set socket timeout:
+  // Set socket timeout, so that the stream watchdog runs while no data arrives:
+  double check_period = handshake_.getCheckPeriod();
   struct timeval tv;
-  tv.tv_sec = 3; // 3 second timeout
-  tv.tv_usec = 0;
+  tv.tv_sec = static_cast<time_t>( check_period );
+  tv.tv_usec = static_cast<suseconds_t>( ( check_period - tv.tv_sec ) * 1e6 );
   res  = setsockopt( sockfd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) );
   if( res < 0 )
     {
       ROS_ERROR_STREAM( "Failed to set socket timeout: " << std::strerror( errno ) << std::endl );
       return false;
     }
+
+  // Optionally have the kernel timestamp each datagram on arrival:
+  if( use_kernel_timestamps_ && !enableReceiveTimestamps( sockfd_ ) )
+    {
+      ROS_ERROR_STREAM( "Failed to enable kernel receive timestamps: " << std::strerror( errno ) << std::endl );
+      return false;
+    }
+
+  // Have the kernel report datagrams dropped on a full socket buffer, for diagnostics only:
+  if( !enableDropCount( sockfd_ ) )
+    {
+      ROS_WARN_STREAM( "Failed to enable socket drop counts: " << std::strerror( errno ) << std::endl );
+    }
     
   // Explicitly bind the host UDP socket:
   res = bind( sockfd_, ( struct sockaddr * )( &sockaddr_ ), sizeof( sockaddr_ ) );
@@ -130,65 +185,102 @@ bool RadarInterfaceK793D::connect(void)
       return false;
     }
 
-  // Try to receive data until the timeout to see if the K79 is already running:
-  struct sockaddr_storage src_addr;
-  socklen_t src_addr_len = sizeof( src_addr );
-  res = recvfrom( sockfd_, ( char* )buffer_, RadarInterfaceK793D::radar_msg_len, MSG_WAITALL, ( struct sockaddr *)( &src_addr ), &src_addr_len );
-  if( res < 0 )
+  // Connect unless the radar is already streaming, without blocking on it for long. If it
+  // does not answer, the stream watchdog keeps retrying:
+  handshake_.start( sockfd_, destaddr_, UdpHandshake::now() );
+  if( handshake_.run( buffer_, RadarInterfaceK793D::radar_msg_len ) )
     {
-      // If blocking recvfrom times out, errno is set to EAGAIN:
-      if( errno == EAGAIN )
-	{
-	  // Send the connect command to the radar:
-	  RadarInterfaceK793D::connect_cmd_str.copy( buffer_, RadarInterfaceK793D::connect_cmd_str.length() );
-	  res = sendto( sockfd_, ( char* )buffer_, RadarInterfaceK793D::connect_cmd_str.length(), 0, ( struct sockaddr *)( &destaddr_ ), sizeof( destaddr_ ) );
-	  if( res < 0 )
-	    {
-	      ROS_ERROR_STREAM( "Failed to send connect command to radar: " << std::strerror( errno ) << std::endl );
-	      return false;
-	    }
+      ROS_INFO_STREAM( "Radar ready after " << handshake_.getElapsed( UdpHandshake::now() ) << " s" );
+      is_ready_ = true;
+    }
+  else
+    {
+      ROS_ERROR_STREAM( "Failed to connect to the radar, waiting for it to start streaming" );
+    }
 
-	  // Wait for a response to the connect command:
-	  res = recvfrom( sockfd_, ( char* )buffer_, RadarInterfaceK793D::connect_res_len, MSG_WAITALL, ( struct sockaddr *)( &src_addr ), &src_addr_len );
-	  if( res < 0 )
-	    {
-	      ROS_ERROR_STREAM( "Failed to receive connect response from radar: " << std::strerror( errno ) << std::endl );
-	      return false;
-	    }
-	  else
-	    {
-	      // TODO: print settings stored on radar from connect response message
-	    }
+  // Advertise the K-79 data using the ROS node handle:
+  pub_radar_data_raw_ = nh_private_.advertise<ainstein_radar_msgs::RadarTargetArray>( "targets/raw", 10 );
 
-	  // Send the run command to the radar:
-	  RadarInterfaceK793D::run_cmd_str.copy( buffer_, RadarInterfaceK793D::run_cmd_str.length() );
-	  res = sendto( sockfd_, ( char* )buffer_, RadarInterfaceK793D::run_cmd_str.length(), 0, ( struct sockaddr *)( &destaddr_ ), sizeof( destaddr_ ) );
-	  if( res < 0 )
-	    {
-	      ROS_ERROR_STREAM( "Failed to send run command to radar: " << std::strerror( errno ) << std::endl );
-	      return false;
-	    }
-	}
-      else // encountered some error other than timeout
-	{
-	  ROS_ERROR_STREAM( "Failed when attempting to detect whether radar is running: " << std::strerror( errno ) << std::endl );
-	  return false;
-	}
-    }
-  
-  // Start the data collection thread:
-  thread_ = std::unique_ptr<std::thread>( new std::thread( &RadarInterfaceK793D::mainLoop, this ) );
   mutex_.lock();
   is_running_ = true;
   mutex_.unlock();
 
-  // Advertise the K-79 data using the ROS node handle:
-  pub_radar_data_raw_ = nh_private_.advertise<ainstein_radar_msgs::RadarTargetArray>( "targets/raw", 10 );
+  // Hand the socket to the shared reactor, or start the data collection thread:
+  if( reactor_ )
+    {
+      if( !reactor_->addSource( sockfd_, std::bind( &RadarInterfaceK793D::onReadable, this ),
+				handshake_.getCheckPeriod() ) )
+	{
+	  ROS_ERROR_STREAM( "Failed to register the radar socket with the reactor." << std::endl );
+	  return false;
+	}
+    }
+  else
+    {
+      thread_ = std::unique_ptr<std::thread>( new std::thread( &RadarInterfaceK793D::mainLoop, this ) );
+    }
   
   return true;
 }
 
 void RadarInterfaceK793D::mainLoop(void)
+{
+  // Enter the main data receiving loop:
+  bool running = true;
+  while( running && !ros::isShuttingDown() )
+    {
+      if( !receiveAndPublish() )
+	{
+	  // Timeouts only wake the loop up to check the stream:
+	  if( errno != EAGAIN && errno != EWOULDBLOCK )
+	    {
+	      ROS_WARN_STREAM( "Failed to read data: " << std::strerror( errno ) << std::endl );
+	    }
+	}
+      checkStream();
+
+      // Check whether the data loop should still be running:
+      mutex_.lock();
+      running = is_running_;
+      mutex_.unlock();  
+     }
+}
+
+void RadarInterfaceK793D::onReadable(void)
+{
+  // The socket is non-blocking in reactor mode, so drain every queued datagram:
+  while( receiveAndPublish() )
+    {
+    }
+
+  if( errno != EAGAIN && errno != EWOULDBLOCK )
+    {
+      ROS_WARN_STREAM( "Failed to read data: " << std::strerror( errno ) << std::endl );
+    }
+
+  // Also called periodically by the reactor, so a silent socket is noticed:
+  checkStream();
+}
+
+void RadarInterfaceK793D::checkStream( void )
+{
+  // Reconnects if the stream stalled:
+  bool ready = handshake_.checkStream( stats_.numFrames(), UdpHandshake::now() );
+  if( ready != is_ready_ )
+    {
+      if( ready )
+	{
+	  ROS_INFO_STREAM( "Radar streaming" );
+	}
+      else
+	{
+	  ROS_WARN_STREAM( "Radar stopped streaming, reconnecting" );
+	}
+      is_ready_ = ready;
+    }
+}
+
+bool RadarInterfaceK793D::receiveAndPublish(void)
 {
   // Received message length:
   int msg_len;
@@ -197,84 +289,95 @@ void RadarInterfaceK793D::mainLoop(void)
   struct sockaddr_storage src_addr;
   socklen_t src_addr_len = sizeof( src_addr );
 
-  // Enter the main data receiving loop:
-  bool running = true;
-  while( running && !ros::isShuttingDown() )
+  // Message header with room for the kernel receive timestamp:
+  struct iovec iov;
+  iov.iov_base = buffer_;
+  iov.iov_len = RadarInterfaceK793D::radar_msg_len;
+
+  alignas( struct cmsghdr ) char control[receive_control_len];
+  struct msghdr msg;
+  memset( &msg, 0, sizeof( msg ) );
+  msg.msg_name = &src_addr;
+  msg.msg_namelen = src_addr_len;
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof( control );
+
+  struct timespec receive_time;
+
+  // Call to block until data has been received (returns immediately in reactor mode):
+  msg_len = recvmsg( sockfd_, &msg, MSG_WAITALL );
+
+  if( msg_len < 0 )
+    {
+      return false;
+    }
+  else
     {
-      // Call to block until data has been received:
-      msg_len = recvfrom( sockfd_, ( char* )buffer_, RadarInterfaceK793D::radar_msg_len, MSG_WAITALL, ( struct sockaddr *)( &src_addr ), &src_addr_len );
+      // Extract the sender's IP address:
+      struct sockaddr_in* sin = ( struct sockaddr_in* )&src_addr;
+      unsigned char* src_ip = ( unsigned char* )( &sin->sin_addr.s_addr );
+      // printf("source IP: %d.%d.%d.%d\n", src_ip[0], src_ip[1], src_ip[2], src_ip[3]);
+      
+      getReceiveTimestamp( &msg, receive_time );
 
-      if( msg_len < 0 )
+      uint32_t kernel_drops;
+      if( getDropCount( &msg, kernel_drops ) )
 	{
-	  ROS_WARN_STREAM( "Failed to read data: " << std::strerror( errno ) << std::endl );
+	  stats_.setKernelDrops( kernel_drops );
 	}
-      else
+
+      // A datagram longer than the buffer was cut short, so its last targets are missing:
+      bool truncated = ( msg.msg_flags & MSG_TRUNC ) != 0;
+      stats_.recordDatagram( msg_len, truncated );
+      if( truncated )
 	{
-	  // Extract the sender's IP address:
-	  struct sockaddr_in* sin = ( struct sockaddr_in* )&src_addr;
-	  unsigned char* src_ip = ( unsigned char* )( &sin->sin_addr.s_addr );
-	  // printf("source IP: %d.%d.%d.%d\n", src_ip[0], src_ip[1], src_ip[2], src_ip[3]);
-      
-	  // Prepare the radar targets messages:
-	  radar_data_msg_ptr_raw_->header.stamp = ros::Time::now();
-	  radar_data_msg_ptr_raw_->targets.clear();
+	  ROS_WARN_STREAM_THROTTLE( 1.0, "Dropped a datagram longer than " << RadarInterfaceK793D::radar_msg_len << " bytes" );
+	  stats_.recordDropped();
+	  return true;
+	}
 
-	  // Extract the target ID and data from the message:
-	  if( ( msg_len % RadarInterfaceK793D::target_msg_len ) != 0 )
-	    {
-	      ROS_WARN_STREAM( "WARNING >> Incorrect number of bytes: " << msg_len << std::endl );
-	    }
-	  else
-	    {
-	      ainstein_radar_msgs::RadarTarget target;
-	      int offset;
-	      for( int i = 0; i < ( msg_len / RadarInterfaceK793D::target_msg_len ); ++i )
-		{
-		  offset = i * RadarInterfaceK793D::target_msg_len;
-
-		  for( int b = 0; b < RadarInterfaceK793D::target_msg_len; ++b )
-		    {
-		      ROS_DEBUG( "%02x ", static_cast<uint8_t>( buffer_[offset + b] ) );
-		    }
-		  ROS_DEBUG( "\n" );
-
-		  target.target_id = i;
-		  target.azimuth = static_cast<double>( static_cast<uint16_t>( ( buffer_[offset + 1] & 0xff ) << 8 ) | static_cast<uint16_t>( buffer_[offset + 0] & 0xff ) ) * -1.0 + 90.0; // 1 count = 1 deg, 90 deg offset
-		  target.range = static_cast<double>( static_cast<uint8_t>( buffer_[offset + 2] & 0xff ) ) * 0.1;   // 1 count = 0.1 m
-
-		  // Speed is 0-127, with 0-64 negative (moving away) and 65-127 positive (moving towards).
-		  // Note that 65 is the highest speed moving towards, hence the manipulation below.
-		  if( static_cast<uint8_t>( buffer_[offset + 3] & 0xff ) <= 64 ) // MOVING AWAY FROM RADAR
-		    {
-		      target.speed = static_cast<double>( static_cast<uint8_t>( buffer_[offset + 3] & 0xff ) ) * -0.045; // 1 count = 0.045 m/s
-		    }
-		  else // MOVING TOWARDS RADAR
-		    {
-		      target.speed = static_cast<double>( static_cast<uint8_t>( buffer_[offset + 3] & 0xff ) - 127 ) * -0.045; // 1 count = 0.045 m/s
-		    }
-
-		  // Negate speed, required for new SNR firmware:
-		  target.speed *= -1.0;
-		  
-		  target.elevation = static_cast<double>( static_cast<uint16_t>( ( buffer_[offset + 5] & 0xff ) << 8 ) | static_cast<uint16_t>( buffer_[offset + 4] & 0xff ) ) * 0.1 - 90.0;
-
-		  target.snr =  static_cast<double>( static_cast<uint16_t>( ( buffer_[offset + 7] & 0xff ) << 8 ) | static_cast<uint16_t>( buffer_[offset + 6] & 0xff ) );
-		  
-		  ROS_DEBUG_STREAM( target << std::endl );
-		  
-		  radar_data_msg_ptr_raw_->targets.push_back( target );
-		}
-
-	      // Publish the target data:
-	      pub_radar_data_raw_.publish( radar_data_msg_ptr_raw_ );
-	    }
+      // Datagrams arriving while (re)connecting step the handshake, which consumes the connect response:
+      if( handshake_.getState() != UdpHandshake::READY && !handshake_.onDatagram( msg_len, UdpHandshake::now() ) )
+	{
+	  return true;
 	}
 
-      // Check whether the data loop should still be running:
-      mutex_.lock();
-      running = is_running_;
-      mutex_.unlock();  
-     }
+      // Prepare the radar targets messages:
+      radar_data_msg_ptr_raw_->targets.clear();
+
+      // Extract the target ID and data from the message:
+      if( ( msg_len % RadarInterfaceK793D::target_msg_len ) != 0 )
+	{
+	  ROS_WARN_STREAM( "WARNING >> Incorrect number of bytes: " << msg_len << std::endl );
+	  stats_.recordDropped();
+	  return true;
+	}
+
+      // Each datagram is a frame, which keeps the stream watchdog fed:
+      stats_.recordFrameStart( receive_time );
+      if( pub_radar_data_raw_.getNumSubscribers() > 0 )
+	{
+	  // Decode the targets straight into the outgoing message, if anyone is listening:
+	  RadarTargetArraySink sink( *radar_data_msg_ptr_raw_ );
+	  sink.append( decoder_, buffer_, msg_len / static_cast<int>( RadarInterfaceK793D::target_msg_len ), 0 );
+
+	  // Stamp the frame with the kernel receive time if requested, otherwise the decode time:
+	  const ros::Time receive_stamp( receive_time.tv_sec, receive_time.tv_nsec );
+	  ros::Time decode_time = ros::Time::now();
+	  ros::Time stamp = use_kernel_timestamps_ ? receive_stamp : decode_time;
+
+	  // Publish the target data as a fresh message, so nodelet subscribers can share it:
+	  pub_radar_data_raw_.publish( sink.takeMessage( stamp ) );
+
+	  // Report the per-frame latency from socket arrival through decoding to publishing:
+	  ROS_DEBUG_STREAM( "Frame receive-to-decode delay: " << ( decode_time - receive_stamp ).toSec()
+			    << " s, decode-to-publish delay: " << ( ros::Time::now() - decode_time ).toSec() << " s" );
+	}
+    }
+
+  return true;
 }
 
 } // namespace ainstein_radar_drivers
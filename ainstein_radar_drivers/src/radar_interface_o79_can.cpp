@@ -25,9 +25,11 @@
 */
 
 #include "ainstein_radar_drivers/radar_interface_o79_can.h"
+#include <ainstein_radar_core/can_protocol.h>
 
 namespace ainstein_radar_drivers
 {
+  namespace can_protocol = ainstein_radar_core::can_protocol;
   
   RadarInterfaceO79CAN::RadarInterfaceO79CAN( ros::NodeHandle node_handle,
 					      ros::NodeHandle node_handle_private ) :
@@ -36,6 +38,7 @@ namespace ainstein_radar_drivers
 				     ros::this_node::getName(),
 				     "received_messages",
 				     "sent_messages" ),
+    raw_gate_( gate_ ),
     radar_info_msg_ptr_( new ainstein_radar_msgs::RadarInfo )
   {
     // Store the radar data frame ID:
@@ -45,9 +48,9 @@ namespace ainstein_radar_drivers
     // Convert the CAN ID string to an int:
     can_id_ = std::stoul( can_id_str_, nullptr, 16 );
     
-    // Set the frame ID:
-    radar_data_msg_ptr_raw_->header.frame_id = frame_id_;
-    radar_data_msg_ptr_tracked_->header.frame_id = frame_id_;
+    // Set the frame ID and preallocate the frames for the maximum number of targets:
+    frame_raw_.configure( frame_id_, RadarInterfaceO79CAN::MAX_NUM_TARGETS );
+    frame_tracked_.configure( frame_id_, RadarInterfaceO79CAN::MAX_NUM_TARGETS );
 
     // Publish the RadarInfo message:
     publishRadarInfo();
@@ -58,6 +61,9 @@ namespace ainstein_radar_drivers
     can_frame_msg_.is_extended = false;
     can_frame_msg_.is_error = false;
     can_frame_msg_.dlc = 8;
+
+    // Receive straight from the CAN device if one is configured, passing only the radar's frames:
+    startSocketCan( { can_id_ } );
   }
 
   void RadarInterfaceO79CAN::dataMsgCallback( const can_msgs::Frame &msg )
@@ -68,73 +74,37 @@ namespace ainstein_radar_drivers
 	if( msg.data[4]==0xFF && msg.data[5]==0xFF && msg.data[6]==0xFF && msg.data[7]==0xFF )
 	  {
 	    ROS_DEBUG( "received start frame from radar" );
-	    // clear radar data message arrays here
-	    radar_data_msg_ptr_raw_->header.stamp = ros::Time::now();
-	    radar_data_msg_ptr_tracked_->header.stamp = ros::Time::now();
-
-	    radar_data_msg_ptr_raw_->targets.clear();
-	    radar_data_msg_ptr_tracked_->targets.clear();
+	    ros::Time stamp = msg.header.stamp.isZero() ? ros::Time::now() : msg.header.stamp;
+	    startFrame( pub_radar_data_raw_, frame_raw_, stamp );
+	    startFrame( pub_radar_data_tracked_, frame_tracked_, stamp );
 	  }
 	// Parse out end of frame messages:
 	else if( msg.data[0]==0xFF && msg.data[1]==0xFF && msg.data[2]==0xFF && msg.data[3]==0xFF )
 	  {
 	    ROS_DEBUG( "received stop frame from radar" );
-	    if( radar_data_msg_ptr_raw_->targets.size() > 0 )
-	      {
-		pub_radar_data_raw_.publish( radar_data_msg_ptr_raw_ );
-	      }
-	    if( radar_data_msg_ptr_tracked_->targets.size() > 0 )
-	      {
-		pub_radar_data_tracked_.publish( radar_data_msg_ptr_tracked_ );
-	      }
+	    publishFrame( pub_radar_data_raw_, frame_raw_, false );
+	    publishFrame( pub_radar_data_tracked_, frame_tracked_, false );
 	  }
 	// Parse out raw target data messages:
 	else if( msg.data[0] == 0x00 )
 	  {
 	    ROS_DEBUG( "received raw target from radar" );
-	
-	    // Extract the target ID and data from the message:
-	    ainstein_radar_msgs::RadarTarget target;
-	    target.target_id = msg.data[0];
-	    target.snr = msg.data[1];
-
-	    // Range scaling is 0.1m per count:
-	    target.range = (uint16_t)( ( msg.data[2] << 8 ) + msg.data[3] ) / 10.0;
-
-	    // Speed scaling is 0.01m/s per count, +ve AWAY from radar, -ve TOWARDS:
-	    target.speed = (int16_t)( ( msg.data[4] << 8 ) + msg.data[5] ) * 0.045;
-
-	    // Azimuth angle scaling is 1 deg per count: 
-	    target.azimuth = (int8_t)( msg.data[6] );
-
-	    // Elevation angle scaling is 1 deg per count: 
-	    target.elevation = (int8_t)( msg.data[7] );
-
-	    radar_data_msg_ptr_raw_->targets.push_back( target );
+	    if( raw_gate_.accepts( msg.data.data() ) )
+	      {
+		if( ainstein_radar_msgs::RadarTarget* target = frame_raw_.add() )
+		  {
+		    can_protocol::decodeTarget<can_protocol::O79RawTargetLayout>( msg.data.data(), *target );
+		  }
+	      }
 	  }
 	// Parse out tracked target data messages:
 	else if( msg.data[0] == 0x01 )
 	  {
 	    ROS_DEBUG( "received tracked target from radar" );
-
-	    // Extract the target ID and data from the message:
-	    ainstein_radar_msgs::RadarTarget target;
-	    target.target_id = msg.data[0];
-	    target.snr = msg.data[1];
-
-	    // Range scaling is 0.01m per count:
-	    target.range = (int16_t)( ( msg.data[2] << 8 ) + msg.data[3] ) / 10.0;
-
-	    // Speed scaling is 0.01m/s per count, +ve AWAY from radar, -ve TOWARDS:
-	    target.speed = (int16_t)( ( msg.data[4] << 8 ) + msg.data[5] ) * 0.045;
-
-	    // Azimuth angle scaling is 1 deg per count: 
-	    target.azimuth = (int8_t)( msg.data[6] );
-
-	    // Elevation angle scaling is 1 deg per count: 
-	    target.elevation = (int8_t)( msg.data[7] );
-
-	    radar_data_msg_ptr_tracked_->targets.push_back( target );
+	    if( ainstein_radar_msgs::RadarTarget* target = frame_tracked_.add() )
+	      {
+		can_protocol::decodeTarget<can_protocol::O79TrackedTargetLayout>( msg.data.data(), *target );
+	      }
 	  }
 	else
 	  {
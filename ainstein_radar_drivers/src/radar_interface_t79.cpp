@@ -25,9 +25,24 @@
 */
 
 #include "ainstein_radar_drivers/radar_interface_t79.h"
+#include <ainstein_radar_core/can_protocol.h>
 
 namespace ainstein_radar_drivers
 {
+  namespace can_protocol = ainstein_radar_core::can_protocol;
+
+  namespace
+  {
+    // Data message types, indexing the IDs (less the radar's CAN ID) they are sent with:
+    enum MessageType { UNKNOWN = 0, START_FRAME, STOP_FRAME, RAW_TARGET, TRACKED_TARGET, N_MESSAGE_TYPES };
+    constexpr uint32_t t79_message_ids[N_MESSAGE_TYPES] = { can_protocol::no_id,
+							     RadarInterfaceT79::RADAR_START_FRAME,
+							     RadarInterfaceT79::RADAR_STOP_FRAME,
+							     RadarInterfaceT79::RADAR_RAW_TARGET,
+							     RadarInterfaceT79::RADAR_TRACKED_TARGET };
+    constexpr can_protocol::IdDispatch t79_dispatch = can_protocol::makeIdDispatch( t79_message_ids );
+    static_assert( t79_dispatch.multiplier != 0, "no perfect hash found for the T79 message IDs" );
+  }
   
   RadarInterfaceT79::RadarInterfaceT79( ros::NodeHandle node_handle,
 					ros::NodeHandle node_handle_private ) :
@@ -36,6 +51,8 @@ namespace ainstein_radar_drivers
 				     ros::this_node::getName(),
 				     "received_messages",
 				     "sent_messages" ),
+    raw_gate_( gate_ ),
+    dyn_config_server_( node_handle_private ),
     radar_info_msg_ptr_( new ainstein_radar_msgs::RadarInfo )
   {
     // Store the radar CAN ID:
@@ -44,9 +61,9 @@ namespace ainstein_radar_drivers
     // Store the radar data frame ID:
     nh_private_.param( "frame_id", frame_id_, std::string( "map" ) );
 
-    // Set the frame ID:
-    radar_data_msg_ptr_raw_->header.frame_id = frame_id_;
-    radar_data_msg_ptr_tracked_->header.frame_id = frame_id_;
+    // Set the frame ID and preallocate the frames for the maximum number of targets:
+    frame_raw_.configure( frame_id_, RadarInterfaceT79::MAX_NUM_TARGETS );
+    frame_tracked_.configure( frame_id_, RadarInterfaceT79::MAX_NUM_TARGETS );
 
     // Publish the RadarInfo message:
     publishRadarInfo();
@@ -58,11 +75,18 @@ namespace ainstein_radar_drivers
     can_frame_msg_.is_error = false;
     can_frame_msg_.dlc = 8;
 
-    // Set up dynamic reconfigure:
+    // Receive straight from the CAN device if one is configured, passing only this radar's frames:
+    startSocketCan( { RadarInterfaceT79::RADAR_COMMAND_RET,
+	  static_cast<uint32_t>( RadarInterfaceT79::RADAR_START_FRAME + can_id_ ),
+	  static_cast<uint32_t>( RadarInterfaceT79::RADAR_STOP_FRAME + can_id_ ),
+	  static_cast<uint32_t>( RadarInterfaceT79::RADAR_RAW_TARGET + can_id_ ),
+	  static_cast<uint32_t>( RadarInterfaceT79::RADAR_TRACKED_TARGET + can_id_ ) } );
+
+    // Set up dynamic reconfigure once the socket is open, since the callback sends the initial ZOI command:
     dynamic_reconfigure::Server<ainstein_radar_drivers::ZoneOfInterestT79Config>::CallbackType f;
     f = boost::bind(&RadarInterfaceT79::dynConfigCallback, this, _1, _2);
-    dyn_config_server_.setCallback(f);  
-  
+    dyn_config_server_.setCallback(f);
+
     startRadar();
   }
 
@@ -87,7 +111,7 @@ namespace ainstein_radar_drivers
     can_frame_msg_.data[6] = RadarInterfaceT79::RESERVED;
     can_frame_msg_.data[7] = RadarInterfaceT79::RESERVED;
 
-    pub_radar_cmd_.publish( can_frame_msg_ );  
+    sendCommand( can_frame_msg_ );
   }
   
   void RadarInterfaceT79::startRadar( void )
@@ -106,7 +130,7 @@ namespace ainstein_radar_drivers
     can_frame_msg_.data[7] = RadarInterfaceT79::RESERVED;
 
     ROS_DEBUG( "starting data streaming for radar with CAN ID %d", can_id_ );
-    pub_radar_cmd_.publish( can_frame_msg_ );
+    sendCommand( can_frame_msg_ );
   }
 
   void RadarInterfaceT79::stopRadar( void )
@@ -123,7 +147,7 @@ namespace ainstein_radar_drivers
     can_frame_msg_.data[7] = RadarInterfaceT79::RESERVED;
 
     ROS_DEBUG( "stopping data streaming for radar with CAN ID %d", can_id_ );
-    pub_radar_cmd_.publish( can_frame_msg_ );
+    sendCommand( can_frame_msg_ );
   }
 
   void RadarInterfaceT79::dataMsgCallback( const can_msgs::Frame &msg )
@@ -155,71 +179,61 @@ namespace ainstein_radar_drivers
             ROS_ERROR( "received unknown radar start/stop from radar with CAN ID %d", can_id_ );
             break;
 	  }
+        return;
       }
-    // Parse out start of frame messages:
-    else if( msg.id == ( RadarInterfaceT79::RADAR_START_FRAME + can_id_ ) )
-      {
-        ROS_DEBUG( "received start frame from radar with CAN ID %d", can_id_ );
-        // clear radar data message arrays here
-        radar_data_msg_ptr_raw_->header.stamp = ros::Time::now();
-        radar_data_msg_ptr_tracked_->header.stamp = ros::Time::now();
 
-        radar_data_msg_ptr_raw_->targets.clear();
-        radar_data_msg_ptr_tracked_->targets.clear();
-      }
-    // Parse out end of frame messages:
-    else if( msg.id == ( RadarInterfaceT79::RADAR_STOP_FRAME + can_id_ ) )
+    // Look up the data message type with the compile-time hash table, IDs being offset by the radar's CAN ID:
+    switch( t79_dispatch.lookup( msg.id - can_id_ ) )
       {
-        ROS_DEBUG( "received stop frame from radar with CAN ID %d", can_id_ );
-        pub_radar_data_raw_.publish( radar_data_msg_ptr_raw_ );
-        pub_radar_data_tracked_.publish( radar_data_msg_ptr_tracked_ );
-      }
-    // Parse out raw target data messages:
-    else if( msg.id == ( RadarInterfaceT79::RADAR_RAW_TARGET + can_id_ ) )
+	// Parse out start of frame messages:
+      case START_FRAME:
       {
-        ROS_DEBUG( "received raw target from radar with CAN ID %d", can_id_ );
-
-        // Extract the target ID and data from the message:
-        ainstein_radar_msgs::RadarTarget target;
-        target.target_id = msg.data[0];
-        target.snr = msg.data[1];
-
-	// Range scaling is 0.01m per count:
-	target.range = (int16_t)( ( msg.data[2] << 8 ) + msg.data[3] ) / 100.0;
-
-	// Speed scaling is 0.01m/s per count, +ve AWAY from radar, -ve TOWARDS:
-	target.speed = (int16_t)( ( msg.data[4] << 8 ) + msg.data[5] ) / 100.0;
-
-	// Azimuth angle scaling is -0.01rad per count: 
-	target.azimuth = (int16_t)( ( msg.data[6] << 8 ) + msg.data[7] ) / 100.0 * -1;
+        ROS_DEBUG( "received start frame from radar with CAN ID %d", can_id_ );
+        ros::Time stamp = msg.header.stamp.isZero() ? ros::Time::now() : msg.header.stamp;
+        startFrame( pub_radar_data_raw_, frame_raw_, stamp );
+        startFrame( pub_radar_data_tracked_, frame_tracked_, stamp );
+        break;
+      }
 
-	// Elevation angle is unused for T79:
-	target.elevation = 0.0;
+	// Parse out end of frame messages:
+      case STOP_FRAME:
+        ROS_DEBUG( "received stop frame from radar with CAN ID %d", can_id_ );
+        publishFrame( pub_radar_data_raw_, frame_raw_ );
+        publishFrame( pub_radar_data_tracked_, frame_tracked_ );
+        break;
 
-        radar_data_msg_ptr_raw_->targets.push_back( target );
-      }
-    // Parse out tracked target data messages:
-    else if( msg.id == ( RadarInterfaceT79::RADAR_TRACKED_TARGET + can_id_ ) )
-      {
+	// Parse out raw and tracked target data messages:
+      case RAW_TARGET:
+        ROS_DEBUG( "received raw target from radar with CAN ID %d", can_id_ );
+        if( !raw_gate_.accepts( msg.data.data() ) )
+          {
+            break;
+          }
+        if( ainstein_radar_msgs::RadarTarget* target = frame_raw_.add() )
+          {
+            decodeTarget( msg, *target );
+          }
+        break;
+
+      case TRACKED_TARGET:
         ROS_DEBUG( "received tracked target from radar with CAN ID %d", can_id_ );
+        if( ainstein_radar_msgs::RadarTarget* target = frame_tracked_.add() )
+          {
+            decodeTarget( msg, *target );
+          }
+        break;
 
-        // Extract the target ID and data from the message:
-        ainstein_radar_msgs::RadarTarget target;
-        target.target_id = msg.data[0];
-        target.snr = msg.data[1];
-        target.range = (int16_t)( ( msg.data[2] << 8 ) + msg.data[3] ) / 100.0;
-        target.speed = (int16_t)( ( msg.data[4] << 8 ) + msg.data[5] ) / 100.0;
-        target.azimuth = (int16_t)( ( msg.data[6] << 8 ) + msg.data[7] ) / 100.0 * -1;
-        target.elevation = 0.0;
-
-        radar_data_msg_ptr_tracked_->targets.push_back( target );
-      }
-    else
-      {
+      default:
         ROS_DEBUG( "received message with unknown id: %02x", msg.id );
+        break;
       }
   }
 
+  void RadarInterfaceT79::decodeTarget( const can_msgs::Frame& msg, ainstein_radar_msgs::RadarTarget& target )
+  {
+    can_protocol::decodeTarget<can_protocol::T79TargetLayout>( msg.data.data(), target );
+  }
+
   void RadarInterfaceT79::publishRadarInfo( void )
   {    
     // Advertise the T79 sensor info (LATCHED):
@@ -228,36 +242,40 @@ namespace ainstein_radar_drivers
     // Form the RadarInfo message which is fixed for a given sensor:
     radar_info_msg_ptr_->header.stamp = ros::Time::now();
     radar_info_msg_ptr_->header.frame_id = frame_id_;
+    fillRadarInfo( *radar_info_msg_ptr_ );
+
+    // Publish the RadarInfo message once since it's latched:
+    pub_radar_info_.publish( radar_info_msg_ptr_ );
+  }
 
-    radar_info_msg_ptr_->update_rate = UPDATE_RATE;
-    radar_info_msg_ptr_->max_num_targets = MAX_NUM_TARGETS;
+  void RadarInterfaceT79::fillRadarInfo( ainstein_radar_msgs::RadarInfo& info )
+  {
+    info.update_rate = UPDATE_RATE;
+    info.max_num_targets = MAX_NUM_TARGETS;
   
-    radar_info_msg_ptr_->range_min = RANGE_MIN;
-    radar_info_msg_ptr_->range_max = RANGE_MAX;
+    info.range_min = RANGE_MIN;
+    info.range_max = RANGE_MAX;
   
-    radar_info_msg_ptr_->speed_min = SPEED_MIN;
-    radar_info_msg_ptr_->speed_max = SPEED_MAX;
+    info.speed_min = SPEED_MIN;
+    info.speed_max = SPEED_MAX;
 
-    radar_info_msg_ptr_->azimuth_min = AZIMUTH_MIN;
-    radar_info_msg_ptr_->azimuth_max = AZIMUTH_MAX;
+    info.azimuth_min = AZIMUTH_MIN;
+    info.azimuth_max = AZIMUTH_MAX;
 
-    radar_info_msg_ptr_->elevation_min = ELEVATION_MIN;
-    radar_info_msg_ptr_->elevation_max = ELEVATION_MAX;
+    info.elevation_min = ELEVATION_MIN;
+    info.elevation_max = ELEVATION_MAX;
 
-    radar_info_msg_ptr_->range_resolution = RANGE_RES;
-    radar_info_msg_ptr_->range_accuracy = RANGE_ACC;
+    info.range_resolution = RANGE_RES;
+    info.range_accuracy = RANGE_ACC;
   
-    radar_info_msg_ptr_->speed_resolution = SPEED_RES;
-    radar_info_msg_ptr_->speed_accuracy = SPEED_ACC;
+    info.speed_resolution = SPEED_RES;
+    info.speed_accuracy = SPEED_ACC;
 
-    radar_info_msg_ptr_->azimuth_resolution = AZIMUTH_RES;
-    radar_info_msg_ptr_->azimuth_accuracy = AZIMUTH_ACC;
+    info.azimuth_resolution = AZIMUTH_RES;
+    info.azimuth_accuracy = AZIMUTH_ACC;
 
-    radar_info_msg_ptr_->elevation_resolution = ELEVATION_RES;
-    radar_info_msg_ptr_->elevation_accuracy = ELEVATION_ACC;
-  
-    // Publish the RadarInfo message once since it's latched:
-    pub_radar_info_.publish( radar_info_msg_ptr_ );
+    info.elevation_resolution = ELEVATION_RES;
+    info.elevation_accuracy = ELEVATION_ACC;
   }
 
 } // namespace ainstein_drivers
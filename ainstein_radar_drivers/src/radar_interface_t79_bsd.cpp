@@ -35,7 +35,8 @@ RadarInterfaceT79BSD::RadarInterfaceT79BSD( ros::NodeHandle node_handle,
 				   node_handle_private,
 				   ros::this_node::getName(),
 				   "received_messages",
-				   "sent_messages" )
+				   "sent_messages" ),
+  raw_gate_( gate_ )
 {
   // Store the radar type:
   int radar_type;
@@ -45,12 +46,24 @@ RadarInterfaceT79BSD::RadarInterfaceT79BSD( ros::NodeHandle node_handle,
   // Store the radar data frame ID:
   nh_private_.param( "frame_id", frame_id_, std::string( "map" ) );
 
-  // Set the frame ID:
-  radar_data_msg_ptr_raw_->header.frame_id = frame_id_;
-  radar_data_msg_ptr_tracked_->header.frame_id = frame_id_;
-  radar_data_msg_ptr_alarms_->header.frame_id = frame_id_;
+  // Set the frame ID and preallocate the frames for the maximum number of targets and alarms:
+  frame_raw_.configure( frame_id_, ConfigT79BSD::MAX_NUM_TARGETS );
+  frame_tracked_.configure( frame_id_, ConfigT79BSD::MAX_NUM_TARGETS );
+  frame_alarms_.configure( frame_id_, ConfigT79BSD::MAX_NUM_ALARMS );
   
   name_ = ConfigT79BSD::radar_names.at( type_ );
+
+  // Receive straight from the CAN device if one is configured, passing only this radar's frames:
+  std::vector<uint32_t> filter_ids;
+  for( uint32_t id : ConfigT79BSD::message_ids[type_] )
+    {
+      if( id != can_protocol::no_id )
+	{
+	  filter_ids.push_back( id );
+	}
+    }
+  startSocketCan( filter_ids );
+
   startRadar();
 }
 
@@ -75,7 +88,7 @@ void RadarInterfaceT79BSD::startRadar( void )
     can_frame.data[7] = ConfigT79BSD::RESERVED;
 
     ROS_DEBUG( "starting data streaming for %s", name_.c_str() );
-    pub_radar_cmd_.publish( can_frame );
+    sendCommand( can_frame );
 }
 
 void RadarInterfaceT79BSD::stopRadar( void )
@@ -98,27 +111,27 @@ void RadarInterfaceT79BSD::stopRadar( void )
     can_frame.data[7] = ConfigT79BSD::RESERVED;
 
     ROS_DEBUG( "stopping data streaming for %s", name_.c_str() );
-    pub_radar_cmd_.publish( can_frame );
+    sendCommand( can_frame );
 }
 
 void RadarInterfaceT79BSD::dataMsgCallback( const can_msgs::Frame &msg )
 {
-    // Parse out heartbeat frame 1 messages:
-    if( msg.id == ConfigT79BSD::heartbeat_1.at( type_ ) )
-    {
-      ROS_DEBUG( "received hearbeat frame 1 from %s", name_.c_str() );
-    }
-    // Parse out heartbeat frame 2 messages:
-    if( msg.id == ConfigT79BSD::heartbeat_2.at( type_ ) )
+    // Look up the message type from the ID with the radar type's compile-time hash table:
+    switch( ConfigT79BSD::dispatch[type_].lookup( msg.id ) )
     {
-      ROS_DEBUG( "received hearbeat frame 2 from %s", name_.c_str() );
-    }
+    // Parse out heartbeat frame messages:
+    case ConfigT79BSD::HEARTBEAT_1:
+        ROS_DEBUG( "received hearbeat frame 1 from %s", name_.c_str() );
+        break;
+
+    case ConfigT79BSD::HEARTBEAT_2:
+        ROS_DEBUG( "received hearbeat frame 2 from %s", name_.c_str() );
+        break;
+
     // Parse out start radar response messages:
-    if( msg.id == ConfigT79BSD::start_stop_ret.at( type_ ) )
-    {
+    case ConfigT79BSD::START_STOP_RET:
         // Check whether the response is for a start or stop radar message:
-        uint8_t start_stop_byte = msg.data[0];
-        switch( start_stop_byte )
+        switch( msg.data[0] )
         {
         case ConfigT79BSD::RADAR_START:
             ROS_DEBUG( "received radar start from %s", name_.c_str() );
@@ -132,84 +145,66 @@ void RadarInterfaceT79BSD::dataMsgCallback( const can_msgs::Frame &msg )
             ROS_ERROR( "received unknown radar start/stop from %s", name_.c_str() );
             break;
         }
-    }
+        break;
+
     // Parse out start of frame messages (KANZA comes first in BSD firmware):
-    else if( msg.id == ConfigT79BSD::start_frame.at( type_ ) )
+    case ConfigT79BSD::START_FRAME:
     {
         ROS_DEBUG( "received start frame from %s", name_.c_str() );
-        // clear radar data message arrays here
-        radar_data_msg_ptr_raw_->header.stamp = ros::Time::now();
-        radar_data_msg_ptr_tracked_->header.stamp = ros::Time::now();
-        radar_data_msg_ptr_alarms_->header.stamp = ros::Time::now();
-
-        radar_data_msg_ptr_raw_->targets.clear();
-        radar_data_msg_ptr_tracked_->targets.clear();
-        radar_data_msg_ptr_alarms_->alarms.clear();
+        ros::Time stamp = msg.header.stamp.isZero() ? ros::Time::now() : msg.header.stamp;
+        startFrame( pub_radar_data_raw_, frame_raw_, stamp );
+        startFrame( pub_radar_data_tracked_, frame_tracked_, stamp );
+        startFrame( pub_radar_data_alarms_, frame_alarms_, stamp );
+        break;
     }
+
     // Parse out end of frame messages:
-    else if( msg.id == ConfigT79BSD::stop_frame.at( type_ ) )
-    {
+    case ConfigT79BSD::STOP_FRAME:
         ROS_DEBUG( "received stop frame from %s", name_.c_str() );
-        pub_radar_data_raw_.publish( radar_data_msg_ptr_raw_ );
-        pub_radar_data_tracked_.publish( radar_data_msg_ptr_tracked_ );
-        pub_radar_data_alarms_.publish( radar_data_msg_ptr_alarms_ );
-    }
-    // Parse out raw target data messages:
-    else if( msg.id == ConfigT79BSD::raw_id.at( type_ ) )
-    {
-        ROS_DEBUG( "received raw target from %s", name_.c_str() );
-
-        // Extract the target ID and data from the message:
-        ainstein_radar_msgs::RadarTarget target;
-        target.target_id = msg.data[0];
-        target.snr = msg.data[1];
-
-	// Range scaling is 0.01m per count:
-	target.range = (int16_t)( ( msg.data[2] << 8 ) + msg.data[3] ) / 100.0;
+        publishFrame( pub_radar_data_raw_, frame_raw_ );
+        publishFrame( pub_radar_data_tracked_, frame_tracked_ );
+        publishFrame( pub_radar_data_alarms_, frame_alarms_ );
+        break;
 
-	// Speed scaling is 0.01m/s per count, +ve AWAY from radar, -ve TOWARDS:
-	target.speed = (int16_t)( ( msg.data[4] << 8 ) + msg.data[5] ) / 100.0;
-
-	// Azimuth angle scaling is -0.01rad per count: 
-	target.azimuth = (int16_t)( ( msg.data[6] << 8 ) + msg.data[7] ) / 100.0 * -1;
-
-	// Elevation angle is unused for T79:
-	target.elevation = 0.0;
+    // Parse out raw and tracked target data messages:
+    case ConfigT79BSD::RAW_TARGET:
+        ROS_DEBUG( "received raw target from %s", name_.c_str() );
+        if( !raw_gate_.accepts( msg.data.data() ) )
+        {
+            break;
+        }
+        if( ainstein_radar_msgs::RadarTarget* target = frame_raw_.add() )
+        {
+            can_protocol::decodeTarget<can_protocol::T79TargetLayout>( msg.data.data(), *target );
+        }
+        break;
 
-        radar_data_msg_ptr_raw_->targets.push_back( target );
-    }
-    // Parse out tracked target data messages:
-    else if( msg.id == ConfigT79BSD::tracked_id.at( type_ ) )
-    {
+    case ConfigT79BSD::TRACKED_TARGET:
         ROS_DEBUG( "received tracked target from %s", name_.c_str() );
+        if( ainstein_radar_msgs::RadarTarget* target = frame_tracked_.add() )
+        {
+            can_protocol::decodeTarget<can_protocol::T79TargetLayout>( msg.data.data(), *target );
+        }
+        break;
 
-        // Extract the target ID and data from the message:
-        ainstein_radar_msgs::RadarTarget target;
-        target.target_id = msg.data[0];
-        target.snr = msg.data[1];
-        target.range = (int16_t)( ( msg.data[2] << 8 ) + msg.data[3] ) / 100.0;
-        target.speed = (int16_t)( ( msg.data[4] << 8 ) + msg.data[5] ) / 100.0;
-        target.azimuth = (int16_t)( ( msg.data[6] << 8 ) + msg.data[7] ) / 100.0 * -1;
-        target.elevation = 0.0;
-
-        radar_data_msg_ptr_tracked_->targets.push_back( target );
-    }
     // Parse out BSD data messages:
-    else if( msg.id == ConfigT79BSD::bsd_id.at( type_ ) )
+    case ConfigT79BSD::BSD_ALARM:
     {
         ROS_DEBUG( "received BSD from %s", name_.c_str() );
 
         // Extract alarm data from the message:
-        ainstein_radar_msgs::RadarAlarm alarms;
-        alarms.LCA_alarm = ( 1UL << 6 ) & msg.data[1];
-        alarms.CVW_alarm = ( 1UL << 4 ) & msg.data[1];
-        alarms.BSD_alarm = ( 1UL << 2 ) & msg.data[1];
-
-        radar_data_msg_ptr_alarms_->alarms.push_back( alarms );
+        if( ainstein_radar_msgs::RadarAlarm* alarms = frame_alarms_.add() )
+        {
+            alarms->LCA_alarm = ( 1UL << 6 ) & msg.data[1];
+            alarms->CVW_alarm = ( 1UL << 4 ) & msg.data[1];
+            alarms->BSD_alarm = ( 1UL << 2 ) & msg.data[1];
+        }
+        break;
     }
-    else
-    {
-      ROS_DEBUG( "received message with unknown id: %02x", msg.id );
+
+    default:
+        ROS_DEBUG( "received message with unknown id: %02x", msg.id );
+        break;
     }
 }
 
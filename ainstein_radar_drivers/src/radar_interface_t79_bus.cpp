@@ -0,0 +1,214 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "ainstein_radar_drivers/radar_interface_t79_bus.h"
+
+namespace ainstein_radar_drivers
+{
+  
+  RadarInterfaceT79Bus::RadarInterfaceT79Bus( ros::NodeHandle node_handle,
+					      ros::NodeHandle node_handle_private ) :
+    RadarInterface<can_msgs::Frame>( node_handle,
+				     node_handle_private,
+				     ros::this_node::getName(),
+				     "received_messages",
+				     "sent_messages" ),
+    routes_( CAN_SFF_MASK + 1 ),
+    raw_gate_( gate_ )
+  {
+    // Get the CAN IDs of the radars on the bus and, optionally, their names:
+    std::vector<int> can_ids;
+    std::vector<std::string> names;
+    nh_private_.param( "can_ids", can_ids, std::vector<int>( 1, 0 ) );
+    nh_private_.param( "names", names, std::vector<std::string>() );
+    if( names.size() > 0 && names.size() != can_ids.size() )
+      {
+	ROS_ERROR( "names must have one entry per CAN ID, using default names" );
+	names.clear();
+      }
+
+    std::vector<uint32_t> filter_ids( 1, RadarInterfaceT79::RADAR_COMMAND_RET );
+    for( std::size_t i = 0; i < can_ids.size(); ++i )
+      {
+	Radar radar;
+	radar.can_id = can_ids.at( i );
+	radar.name = names.size() > 0 ? names.at( i ) : "t79_" + std::to_string( radar.can_id );
+
+	// Claim the radar's message IDs, skipping it if they clash with a radar already added:
+	int ind = radars_.size();
+	if( ind > 255 ||
+	    !addRoute( RadarInterfaceT79::RADAR_START_FRAME + radar.can_id, START_FRAME, ind ) ||
+	    !addRoute( RadarInterfaceT79::RADAR_STOP_FRAME + radar.can_id, STOP_FRAME, ind ) ||
+	    !addRoute( RadarInterfaceT79::RADAR_RAW_TARGET + radar.can_id, RAW_TARGET, ind ) ||
+	    !addRoute( RadarInterfaceT79::RADAR_TRACKED_TARGET + radar.can_id, TRACKED_TARGET, ind ) )
+	  {
+	    ROS_ERROR( "CAN ID %d clashes with another radar on the bus, ignoring it", radar.can_id );
+	    for( auto& route : routes_ )
+	      {
+		if( route.type != UNUSED && route.radar == ind )
+		  {
+		    route.type = UNUSED;
+		  }
+	      }
+	    continue;
+	  }
+	filter_ids.push_back( RadarInterfaceT79::RADAR_START_FRAME + radar.can_id );
+	filter_ids.push_back( RadarInterfaceT79::RADAR_STOP_FRAME + radar.can_id );
+	filter_ids.push_back( RadarInterfaceT79::RADAR_RAW_TARGET + radar.can_id );
+	filter_ids.push_back( RadarInterfaceT79::RADAR_TRACKED_TARGET + radar.can_id );
+
+	// Set up the radar's publishers and messages, named after the radar:
+	radar.pub_raw = nh_private_.advertise<ainstein_radar_msgs::RadarTargetArray>( radar.name + "/targets/raw", 10 );
+	radar.pub_tracked = nh_private_.advertise<ainstein_radar_msgs::RadarTargetArray>( radar.name + "/targets/tracked", 10 );
+	radar.pub_info = nh_private_.advertise<ainstein_radar_msgs::RadarInfo>( radar.name + "/radar_info", 10, true );
+
+	radar.frame_raw.configure( radar.name, RadarInterfaceT79::MAX_NUM_TARGETS );
+	radar.frame_tracked.configure( radar.name, RadarInterfaceT79::MAX_NUM_TARGETS );
+
+	// Publish the RadarInfo message once since it's latched:
+	ainstein_radar_msgs::RadarInfo info;
+	info.header.stamp = ros::Time::now();
+	info.header.frame_id = radar.name;
+	RadarInterfaceT79::fillRadarInfo( info );
+	radar.pub_info.publish( info );
+
+	radars_.push_back( radar );
+      }
+
+    // Receive straight from the CAN device if one is configured, passing only the radars' frames:
+    startSocketCan( filter_ids );
+
+    startRadar();
+  }
+
+  bool RadarInterfaceT79Bus::addRoute( uint32_t id, MessageType type, int radar )
+  {
+    if( id > CAN_SFF_MASK || routes_.at( id ).type != UNUSED )
+      {
+	return false;
+      }
+
+    routes_.at( id ).type = type;
+    routes_.at( id ).radar = radar;
+    return true;
+  }
+
+  void RadarInterfaceT79Bus::sendStartStop( uint8_t command )
+  {
+    // The start and stop commands are not addressed, so one goes to every radar on the bus:
+    can_msgs::Frame can_frame;
+    can_frame.header.frame_id = "0";
+    can_frame.header.stamp = ros::Time::now();
+    can_frame.is_rtr = false;
+    can_frame.is_extended = false;
+    can_frame.is_error = false;
+    can_frame.dlc = 8;
+    can_frame.id = RadarInterfaceT79::RADAR_COMMAND;
+    can_frame.data[0] = command;
+    can_frame.data[1] = RadarInterfaceT79::RESERVED;
+    can_frame.data[2] = ( command == RadarInterfaceT79::RADAR_START ?
+			  ( RadarInterfaceT79::RADAR_SEND_RAW | RadarInterfaceT79::RADAR_SEND_TRACKED ) :
+			  RadarInterfaceT79::RESERVED );
+    can_frame.data[3] = RadarInterfaceT79::RESERVED;
+    can_frame.data[4] = RadarInterfaceT79::RESERVED;
+    can_frame.data[5] = RadarInterfaceT79::RESERVED;
+    can_frame.data[6] = RadarInterfaceT79::RESERVED;
+    can_frame.data[7] = RadarInterfaceT79::RESERVED;
+
+    sendCommand( can_frame );
+  }
+
+  void RadarInterfaceT79Bus::startRadar( void )
+  {
+    ROS_DEBUG( "starting data streaming for %lu radars", radars_.size() );
+    sendStartStop( RadarInterfaceT79::RADAR_START );
+  }
+
+  void RadarInterfaceT79Bus::stopRadar( void )
+  {
+    ROS_DEBUG( "stopping data streaming for %lu radars", radars_.size() );
+    sendStartStop( RadarInterfaceT79::RADAR_STOP );
+  }
+
+  void RadarInterfaceT79Bus::dataMsgCallback( const can_msgs::Frame &msg )
+  {
+    if( msg.is_extended || msg.id > CAN_SFF_MASK )
+      {
+	return;
+      }
+
+    // Look up the radar and message type for this ID:
+    const Route& route = routes_[msg.id];
+    if( route.type == UNUSED )
+      {
+	if( msg.id == RadarInterfaceT79::RADAR_COMMAND_RET )
+	  {
+	    ROS_DEBUG( "received command response %d from radar", msg.data[0] );
+	  }
+	return;
+      }
+
+    Radar& radar = radars_[route.radar];
+    switch( route.type )
+      {
+      case START_FRAME:
+      {
+	// Start a new frame:
+	ros::Time stamp = msg.header.stamp.isZero() ? ros::Time::now() : msg.header.stamp;
+	startFrame( radar.pub_raw, radar.frame_raw, stamp );
+	startFrame( radar.pub_tracked, radar.frame_tracked, stamp );
+	break;
+      }
+
+      case STOP_FRAME:
+	publishFrame( radar.pub_raw, radar.frame_raw );
+	publishFrame( radar.pub_tracked, radar.frame_tracked );
+	break;
+
+      case RAW_TARGET:
+	if( !raw_gate_.accepts( msg.data.data() ) )
+	  {
+	    break;
+	  }
+	if( ainstein_radar_msgs::RadarTarget* target = radar.frame_raw.add() )
+	  {
+	    RadarInterfaceT79::decodeTarget( msg, *target );
+	  }
+	break;
+
+      case TRACKED_TARGET:
+	if( ainstein_radar_msgs::RadarTarget* target = radar.frame_tracked.add() )
+	  {
+	    RadarInterfaceT79::decodeTarget( msg, *target );
+	  }
+	break;
+
+      default:
+	break;
+      }
+  }
+
+} // namespace ainstein_drivers
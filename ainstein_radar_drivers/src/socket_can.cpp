@@ -0,0 +1,210 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <unistd.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <linux/can/raw.h>
+
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+
+#include "ainstein_radar_drivers/socket_can.h"
+#include "ainstein_radar_drivers/receive_timestamp.h"
+
+namespace ainstein_radar_drivers
+{
+  const unsigned int SocketCan::max_batch_len = 64; // maximum frames per batched receive
+  const int SocketCan::receive_timeout_ms = 100; // so receiving threads can check for shutdown
+
+  SocketCan::SocketCan( const std::string& device ) :
+    device_( device ),
+    sockfd_( -1 ),
+    kernel_drops_( 0 )
+  {
+    // Preallocate one receive buffer per frame for batched receives:
+    frames_.resize( SocketCan::max_batch_len );
+    receive_times_.resize( SocketCan::max_batch_len );
+    control_.resize( SocketCan::max_batch_len * receive_control_len );
+    iovecs_.resize( SocketCan::max_batch_len );
+    msgs_.resize( SocketCan::max_batch_len );
+    for( unsigned int i = 0; i < SocketCan::max_batch_len; ++i )
+      {
+	iovecs_.at( i ).iov_base = &frames_.at( i );
+	iovecs_.at( i ).iov_len = sizeof( struct can_frame );
+
+	memset( &msgs_.at( i ), 0, sizeof( struct mmsghdr ) );
+	msgs_.at( i ).msg_hdr.msg_iov = &iovecs_.at( i );
+	msgs_.at( i ).msg_hdr.msg_iovlen = 1;
+	msgs_.at( i ).msg_hdr.msg_control = control_.data() + i * receive_control_len;
+      }
+  }
+
+  SocketCan::~SocketCan( void )
+  {
+    if( sockfd_ >= 0 )
+      {
+	close( sockfd_ );
+      }
+  }
+
+  void SocketCan::addFilter( uint32_t id )
+  {
+    // Match the ID exactly, including its frame format, and never pass remote requests:
+    struct can_filter filter;
+    if( id > CAN_SFF_MASK )
+      {
+	filter.can_id = ( id & CAN_EFF_MASK ) | CAN_EFF_FLAG;
+	filter.can_mask = CAN_EFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG;
+      }
+    else
+      {
+	filter.can_id = id;
+	filter.can_mask = CAN_SFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG;
+      }
+    filters_.push_back( filter );
+  }
+
+  bool SocketCan::connect( void )
+  {
+    // Create the raw CAN socket:
+    sockfd_ = socket( PF_CAN, SOCK_RAW, CAN_RAW );
+    if( sockfd_ < 0 )
+      {
+	std::cout << "Failed to create CAN socket: " << std::strerror( errno ) << std::endl;
+	return false;
+      }
+
+    // Look up the CAN device:
+    struct ifreq ifr;
+    memset( &ifr, 0, sizeof( ifr ) );
+    strncpy( ifr.ifr_name, device_.c_str(), IFNAMSIZ - 1 );
+    int res = ioctl( sockfd_, SIOCGIFINDEX, &ifr );
+    if( res < 0 )
+      {
+	std::cout << "Failed to find CAN device " << device_ << ": " << std::strerror( errno ) << std::endl;
+	return false;
+      }
+
+    // Install the ID filters in the kernel, so other traffic on the bus never reaches the socket:
+    if( filters_.size() > 0 )
+      {
+	res = setsockopt( sockfd_, SOL_CAN_RAW, CAN_RAW_FILTER, filters_.data(),
+			  filters_.size() * sizeof( struct can_filter ) );
+	if( res < 0 )
+	  {
+	    std::cout << "Failed to set CAN filters: " << std::strerror( errno ) << std::endl;
+	    return false;
+	  }
+      }
+
+    // Set socket timeout:
+    struct timeval tv;
+    tv.tv_sec = 0;
+    tv.tv_usec = SocketCan::receive_timeout_ms * 1000;
+    res = setsockopt( sockfd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) );
+    if( res < 0 )
+      {
+	std::cout << "Failed to set socket timeout: " << std::strerror( errno ) << std::endl;
+	return false;
+      }
+
+    // Have the kernel timestamp each frame on arrival:
+    if( !enableReceiveTimestamps( sockfd_ ) )
+      {
+	std::cout << "Failed to enable kernel receive timestamps: " << std::strerror( errno ) << std::endl;
+      }
+
+    // Have the kernel report frames dropped on a full socket buffer, for diagnostics only:
+    if( !enableDropCount( sockfd_ ) )
+      {
+	std::cout << "Failed to enable socket drop counts: " << std::strerror( errno ) << std::endl;
+      }
+
+    // Bind the socket to the CAN device:
+    struct sockaddr_can addr;
+    memset( &addr, 0, sizeof( addr ) );
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    res = bind( sockfd_, ( struct sockaddr * )( &addr ), sizeof( addr ) );
+    if( res < 0 )
+      {
+	std::cout << "Failed to bind CAN socket to " << device_ << ": " << std::strerror( errno ) << std::endl;
+	return false;
+      }
+
+    return true;
+  }
+
+  int SocketCan::receiveFrames( void )
+  {
+    // Reset the control buffer lengths, which the kernel overwrites on return:
+    for( auto& msg : msgs_ )
+      {
+	msg.msg_hdr.msg_controllen = receive_control_len;
+      }
+
+    // Block until at least one frame arrives, then take whatever else is queued without blocking:
+    int res = recvmmsg( sockfd_, msgs_.data(), SocketCan::max_batch_len, MSG_WAITFORONE, NULL );
+    if( res < 0 )
+      {
+	return -1;
+      }
+
+    for( int i = 0; i < res; ++i )
+      {
+	getReceiveTimestamp( &msgs_.at( i ).msg_hdr, receive_times_.at( i ) );
+      }
+
+    // The kernel drop count is a running total, so only the latest one reported matters:
+    for( int i = res - 1; i >= 0; --i )
+      {
+	if( getDropCount( &msgs_.at( i ).msg_hdr, kernel_drops_ ) )
+	  {
+	    break;
+	  }
+      }
+
+    return res;
+  }
+
+  bool SocketCan::sendFrame( const struct can_frame& frame )
+  {
+    ssize_t res = write( sockfd_, &frame, sizeof( frame ) );
+    if( res != sizeof( frame ) )
+      {
+	std::cout << "Failed to send CAN frame: " << std::strerror( errno ) << std::endl;
+	return false;
+      }
+
+    return true;
+  }
+
+} // namespace ainstein_radar_drivers
@@ -0,0 +1,49 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "ainstein_radar_drivers/radar_interface_t79_bus.h"
+
+int main( int argc, char** argv )
+{
+  // Initialize ROS and the default node name:
+  ros::init( argc, argv, "t79_bus_node" );
+  ros::NodeHandle node_handle;
+  ros::NodeHandle node_handle_private( "~" );
+  
+  // Parse the command line arguments for radar parameters:
+  if( argc < 1 )
+    {
+      std::cerr << "Usage: rosrun ainstein_radar_drivers t79_bus_node [_can_ids:=[CAN_ID, ...]] [_names:=[RADAR_NAME, ...]]" << std::endl;
+      return -1;
+    }
+
+  // Create the interface to every T79 on the bus:
+  ainstein_radar_drivers::RadarInterfaceT79Bus t79_bus_intf( node_handle, node_handle_private );
+  
+  ros::spin();
+
+  return 0;
+}
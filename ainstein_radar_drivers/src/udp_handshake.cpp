@@ -0,0 +1,261 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <sys/socket.h>
+#include <poll.h>
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+
+#include "ainstein_radar_drivers/udp_handshake.h"
+
+namespace ainstein_radar_drivers
+{
+  UdpHandshake::UdpHandshake( const std::string& connect_cmd, unsigned int connect_res_len,
+			      const std::string& run_cmd, UdpRadarStats& stats ) :
+    connect_cmd_( connect_cmd ),
+    connect_res_len_( connect_res_len ),
+    run_cmd_( run_cmd ),
+    stats_( stats ),
+    sockfd_( -1 ),
+    state_( IDLE ),
+    deadline_( 0.0 ),
+    response_timeout_( 0.0 ),
+    num_attempts_( 0 ),
+    time_start_( 0.0 ),
+    time_done_( 0.0 ),
+    last_frames_( 0 ),
+    last_progress_( 0.0 ),
+    is_stalled_( false ),
+    retry_interval_( 0.0 ),
+    next_retry_( 0.0 )
+  {
+    memset( &dest_addr_, 0, sizeof( dest_addr_ ) );
+  }
+
+  double UdpHandshake::now( void )
+  {
+    return std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+  }
+
+  void UdpHandshake::start( int sockfd, const struct sockaddr_in& dest_addr, double now )
+  {
+    sockfd_ = sockfd;
+    dest_addr_ = dest_addr;
+
+    retry_interval_ = params_.max_response_timeout;
+    restart( now );
+  }
+
+  void UdpHandshake::restart( double now )
+  {
+    num_attempts_ = 0;
+    response_timeout_ = params_.response_timeout;
+    time_start_ = now;
+
+    // A running radar sends a frame every 0.1s, so a short listen tells whether it already is:
+    deadline_ = now + params_.probe_timeout;
+    state_ = PROBING;
+  }
+
+  bool UdpHandshake::onDatagram( int len, double now )
+  {
+    State state = getState();
+    if( state == CONNECTING && len == static_cast<int>( connect_res_len_ ) )
+      {
+	if( !sendCommand( run_cmd_ ) )
+	  {
+	    // Retry from the connect command at the next deadline:
+	    return false;
+	  }
+
+	finish( READY, now );
+	return false;
+      }
+
+    // Anything else means the radar is streaming, with or without being asked to:
+    if( state == PROBING || state == CONNECTING || state == FAILED )
+      {
+	finish( READY, now );
+      }
+
+    return true;
+  }
+
+  void UdpHandshake::onDeadline( double now )
+  {
+    State state = getState();
+    if( ( state != PROBING && state != CONNECTING ) || now < deadline_ )
+      {
+	return;
+      }
+
+    if( num_attempts_ >= params_.max_attempts )
+      {
+	std::cout << "No response from radar after " << num_attempts_ << " connect commands." << std::endl;
+	finish( FAILED, now );
+	return;
+      }
+
+    sendConnect( now );
+  }
+
+  bool UdpHandshake::run( char* buffer, int buffer_len )
+  {
+    struct pollfd pfd;
+    pfd.fd = sockfd_;
+    pfd.events = POLLIN;
+    while( !isDone() )
+      {
+	// Wait for a datagram until the deadline:
+	double time_now = UdpHandshake::now();
+	int timeout_ms = std::max( 0, static_cast<int>( std::ceil( ( deadline_ - time_now ) * 1e3 ) ) );
+	int res = poll( &pfd, 1, timeout_ms );
+	if( res < 0 && errno != EINTR )
+	  {
+	    std::cout << "Failed to wait for radar: " << std::strerror( errno ) << std::endl;
+	    finish( FAILED, UdpHandshake::now() );
+	    break;
+	  }
+
+	// Datagrams received before the radar is running are not decoded:
+	if( res > 0 )
+	  {
+	    int len = recv( sockfd_, buffer, buffer_len, MSG_DONTWAIT );
+	    if( len >= 0 )
+	      {
+		onDatagram( len, UdpHandshake::now() );
+	      }
+	    else if( errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR )
+	      {
+		std::cout << "Failed to receive from radar: " << std::strerror( errno ) << std::endl;
+	      }
+	  }
+
+	onDeadline( UdpHandshake::now() );
+      }
+
+    return ( getState() == READY );
+  }
+
+  bool UdpHandshake::checkStream( uint64_t frames, double now )
+  {
+    if( frames != last_frames_ )
+      {
+	last_frames_ = frames;
+	last_progress_ = now;
+      }
+
+    if( params_.stall_timeout <= 0.0 )
+      {
+	return ( getState() == READY );
+      }
+
+    switch( getState() )
+      {
+      case READY:
+	// Frames normally arrive every 1 / UPDATE_RATE seconds:
+	if( now - last_progress_ > params_.stall_timeout )
+	  {
+	    std::cout << "No radar data for " << now - last_progress_ << "s, reconnecting." << std::endl;
+	    stats_.recordStall();
+	    is_stalled_ = true;
+	    restart( now );
+	  }
+	break;
+
+      case PROBING:
+      case CONNECTING:
+	onDeadline( now );
+	break;
+
+      case FAILED:
+	if( now >= next_retry_ )
+	  {
+	    restart( now );
+	  }
+	break;
+
+      default:
+	break;
+      }
+
+    return ( getState() == READY );
+  }
+
+  bool UdpHandshake::sendCommand( const std::string& cmd )
+  {
+    int res = sendto( sockfd_, cmd.data(), cmd.length(), 0, ( struct sockaddr *)( &dest_addr_ ), sizeof( dest_addr_ ) );
+    if( res < 0 )
+      {
+	std::cout << "Failed to send " << cmd << " command to radar: " << std::strerror( errno ) << std::endl;
+	return false;
+      }
+
+    return true;
+  }
+
+  void UdpHandshake::sendConnect( double now )
+  {
+    // A failed send counts as an attempt, and is retried after the same backoff:
+    sendCommand( connect_cmd_ );
+    ++num_attempts_;
+
+    deadline_ = now + response_timeout_;
+    response_timeout_ = std::min( 2.0 * response_timeout_, params_.max_response_timeout );
+    state_ = CONNECTING;
+  }
+
+  void UdpHandshake::finish( State state, double now )
+  {
+    time_done_ = now;
+    if( state == READY )
+      {
+	// Time to recover is counted from the last frame before the stall:
+	if( is_stalled_ )
+	  {
+	    std::cout << "Radar data resumed after " << now - last_progress_ << "s." << std::endl;
+	    stats_.recordRecovery( now - last_progress_ );
+	    is_stalled_ = false;
+	  }
+	last_progress_ = now;
+	retry_interval_ = params_.max_response_timeout;
+      }
+    else if( state == FAILED )
+      {
+	// Back off between handshakes while the radar stays silent:
+	next_retry_ = now + retry_interval_;
+	retry_interval_ = std::min( 2.0 * retry_interval_, params_.max_retry_interval );
+      }
+    state_ = state;
+  }
+
+} // namespace ainstein_radar_drivers
@@ -0,0 +1,512 @@
+/*
+  Copyright <2018-2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <getopt.h>
+#include <signal.h>
+#include <unistd.h>
+#include <string.h>
+
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cerrno>
+
+#include "ainstein_radar_drivers/radar_driver_k79.h"
+#include "ainstein_radar_drivers/radar_driver_o79_udp.h"
+
+// Stand-in for one or more K79, K79-3D or O79 radars on UDP: answers the
+// connect/run handshake the drivers perform and then streams synthetic frames.
+// Intended for load testing the drivers over loopback without hardware. The
+// drivers take each datagram as a whole message of its type, so every message is
+// sent as a single datagram and the target counts are capped at what fits in one.
+
+namespace
+{
+  enum RadarModel { MODEL_K79, MODEL_K79_3D, MODEL_O79 };
+
+  struct EmulatorOptions
+  {
+    RadarModel model = MODEL_O79;
+    std::string radar_ip = "127.0.0.1";
+    int radar_port = 7;
+    std::string host_ip = "127.0.0.1";
+    int host_port = 1024;
+    int num_sensors = 1;
+    double rate = 20.0;
+    int num_targets = 100;
+    int num_tracked = 10;
+    double loss = 0.0;
+    double duration = 0.0;
+    bool autostart = false;
+    unsigned int seed = 0;
+  };
+
+  // One emulated radar, listening on radar_port + index:
+  struct EmulatedRadar
+  {
+    int sockfd;
+    bool running;
+    struct sockaddr_in dest;
+  };
+
+  // Largest datagram the drivers accept, and the size of one target record:
+  const unsigned int max_msg_len = 3000;
+  const unsigned int target_len = 8;
+
+  // Records of record_len bytes fitting in one datagram after a header. The drivers take a
+  // full-length datagram to be continued in the next one, so datagrams stay shorter:
+  int maxRecords( int header_len, int record_len )
+  {
+    return ( static_cast<int>( max_msg_len ) - 1 - header_len ) / record_len;
+  }
+
+  volatile sig_atomic_t shutdown_requested = 0;
+
+  void handleSignal( int )
+  {
+    shutdown_requested = 1;
+  }
+
+  void printUsage( void )
+  {
+    std::cerr << "Usage: udp_radar_emulator [options]\n"
+	      << "  --model k79|k79_3d|o79   wire format to emulate (default o79)\n"
+	      << "  --radar-ip IP            address the emulated radars bind to (default 127.0.0.1)\n"
+	      << "  --radar-port PORT        port of the first emulated radar (default 7)\n"
+	      << "  --host-ip IP             driver address streamed to with --autostart (default 127.0.0.1)\n"
+	      << "  --host-port PORT         driver port of the first radar with --autostart (default 1024)\n"
+	      << "  --sensors N              number of radars, on consecutive ports (default 1)\n"
+	      << "  --rate HZ                frame rate per radar (default 20)\n"
+	      << "  --targets N              raw targets per frame, at most 374 (373 for o79) (default 100)\n"
+	      << "  --tracked N              tracked targets per frame, at most 373 (249 for o79) (default 10)\n"
+	      << "  --loss RATIO             fraction of datagrams dropped, 0-1 (default 0)\n"
+	      << "  --duration S             stop after S seconds, 0 runs until interrupted (default 0)\n"
+	      << "  --autostart              stream without waiting for the connect/run handshake\n"
+	      << "  --seed N                 random seed for target data and losses (default 0)\n";
+  }
+
+  bool parseOptions( int argc, char** argv, EmulatorOptions& opts )
+  {
+    static const struct option long_options[] = {
+      { "model", required_argument, NULL, 'm' },
+      { "radar-ip", required_argument, NULL, 'r' },
+      { "radar-port", required_argument, NULL, 'p' },
+      { "host-ip", required_argument, NULL, 'h' },
+      { "host-port", required_argument, NULL, 'o' },
+      { "sensors", required_argument, NULL, 'n' },
+      { "rate", required_argument, NULL, 'f' },
+      { "targets", required_argument, NULL, 't' },
+      { "tracked", required_argument, NULL, 'k' },
+      { "loss", required_argument, NULL, 'l' },
+      { "duration", required_argument, NULL, 'd' },
+      { "autostart", no_argument, NULL, 'a' },
+      { "seed", required_argument, NULL, 's' },
+      { "help", no_argument, NULL, '?' },
+      { NULL, 0, NULL, 0 }
+    };
+
+    int c;
+    while( ( c = getopt_long( argc, argv, "", long_options, NULL ) ) != -1 )
+      {
+	switch( c )
+	  {
+	  case 'm':
+	    if( std::string( optarg ) == "k79" )
+	      {
+		opts.model = MODEL_K79;
+	      }
+	    else if( std::string( optarg ) == "k79_3d" )
+	      {
+		opts.model = MODEL_K79_3D;
+	      }
+	    else if( std::string( optarg ) == "o79" )
+	      {
+		opts.model = MODEL_O79;
+	      }
+	    else
+	      {
+		std::cerr << "Unknown radar model: " << optarg << std::endl;
+		return false;
+	      }
+	    break;
+	  case 'r': opts.radar_ip = optarg; break;
+	  case 'p': opts.radar_port = std::stoi( optarg ); break;
+	  case 'h': opts.host_ip = optarg; break;
+	  case 'o': opts.host_port = std::stoi( optarg ); break;
+	  case 'n': opts.num_sensors = std::max( 1, std::stoi( optarg ) ); break;
+	  case 'f': opts.rate = std::stod( optarg ); break;
+	  case 't': opts.num_targets = std::max( 0, std::stoi( optarg ) ); break;
+	  case 'k': opts.num_tracked = std::max( 0, std::stoi( optarg ) ); break;
+	  case 'l': opts.loss = std::min( 1.0, std::max( 0.0, std::stod( optarg ) ) ); break;
+	  case 'd': opts.duration = std::stod( optarg ); break;
+	  case 'a': opts.autostart = true; break;
+	  case 's': opts.seed = std::stoul( optarg ); break;
+	  default:
+	    return false;
+	  }
+      }
+
+    // Cap the target counts at one datagram per message, O79 tracked targets also being
+    // sent as bounding boxes and Cartesian targets:
+    using ainstein_radar_drivers::RadarDriverO79UDP;
+    int max_targets = maxRecords( 0, target_len );
+    int max_tracked = maxRecords( target_len, target_len );
+    if( opts.model == MODEL_O79 )
+      {
+	max_targets = maxRecords( RadarDriverO79UDP::msg_header_len, RadarDriverO79UDP::msg_len_raw_targets );
+	max_tracked = std::min( { maxRecords( RadarDriverO79UDP::msg_header_len, RadarDriverO79UDP::msg_len_tracked_targets ),
+				  maxRecords( RadarDriverO79UDP::msg_header_len, RadarDriverO79UDP::msg_len_bounding_boxes ),
+				  maxRecords( RadarDriverO79UDP::msg_header_len, RadarDriverO79UDP::msg_len_tracked_targets_cart ) } );
+      }
+    if( opts.num_targets > max_targets || opts.num_tracked > max_tracked )
+      {
+	opts.num_targets = std::min( opts.num_targets, max_targets );
+	opts.num_tracked = std::min( opts.num_tracked, max_tracked );
+	std::cerr << "Capping frames at one datagram per message: " << opts.num_targets << " raw and "
+		  << opts.num_tracked << " tracked targets" << std::endl;
+      }
+
+    return ( opts.rate > 0.0 );
+  }
+
+  class UdpRadarEmulator
+  {
+  public:
+    explicit UdpRadarEmulator( const EmulatorOptions& opts ) :
+      opts_( opts ),
+      buffer_( max_msg_len ),
+      rng_( opts.seed ),
+      byte_dist_( 0, 255 ),
+      loss_dist_( 0.0, 1.0 ),
+      frames_sent_( 0 ),
+      datagrams_sent_( 0 ),
+      datagrams_dropped_( 0 ),
+      send_errors_( 0 )
+    {
+    }
+
+    ~UdpRadarEmulator( void )
+    {
+      for( auto& radar : radars_ )
+	{
+	  close( radar.sockfd );
+	}
+    }
+
+    bool open( void )
+    {
+      for( int i = 0; i < opts_.num_sensors; ++i )
+	{
+	  EmulatedRadar radar;
+	  radar.sockfd = socket( AF_INET, SOCK_DGRAM, 0 );
+	  if( radar.sockfd < 0 )
+	    {
+	      std::cerr << "Failed to create socket: " << strerror( errno ) << std::endl;
+	      return false;
+	    }
+
+	  // Allow a large send buffer so bursts of 1000-target frames are not dropped locally:
+	  int sndbuf = 4 * 1024 * 1024;
+	  setsockopt( radar.sockfd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof( sndbuf ) );
+
+	  struct sockaddr_in addr;
+	  memset( &addr, 0, sizeof( addr ) );
+	  addr.sin_family = AF_INET;
+	  addr.sin_port = htons( opts_.radar_port + i );
+	  addr.sin_addr.s_addr = inet_addr( opts_.radar_ip.c_str() );
+	  if( bind( radar.sockfd, ( struct sockaddr* )( &addr ), sizeof( addr ) ) < 0 )
+	    {
+	      std::cerr << "Failed to bind radar " << i << " to port " << opts_.radar_port + i << ": " << strerror( errno ) << std::endl;
+	      close( radar.sockfd );
+	      return false;
+	    }
+
+	  // With autostart the radar streams straight away, as if it were already running:
+	  memset( &radar.dest, 0, sizeof( radar.dest ) );
+	  radar.dest.sin_family = AF_INET;
+	  radar.dest.sin_port = htons( opts_.host_port + i );
+	  radar.dest.sin_addr.s_addr = inet_addr( opts_.host_ip.c_str() );
+	  radar.running = opts_.autostart;
+
+	  radars_.push_back( radar );
+	}
+
+      return true;
+    }
+
+    void run( void )
+    {
+      typedef std::chrono::steady_clock Clock;
+      const Clock::duration frame_period = std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( 1.0 / opts_.rate ) );
+      const Clock::time_point start = Clock::now();
+      Clock::time_point next_frame = start;
+      Clock::time_point next_report = start + std::chrono::seconds( 1 );
+
+      std::vector<struct pollfd> fds( radars_.size() );
+      for( std::size_t i = 0; i < radars_.size(); ++i )
+	{
+	  fds.at( i ).fd = radars_.at( i ).sockfd;
+	  fds.at( i ).events = POLLIN;
+	}
+
+      while( !shutdown_requested )
+	{
+	  Clock::time_point now = Clock::now();
+	  if( opts_.duration > 0.0 && now - start >= std::chrono::duration<double>( opts_.duration ) )
+	    {
+	      break;
+	    }
+
+	  // Send a frame from every running radar once it is due:
+	  if( now >= next_frame )
+	    {
+	      for( auto& radar : radars_ )
+		{
+		  if( radar.running )
+		    {
+		      sendFrame( radar );
+		      ++frames_sent_;
+		    }
+		}
+
+	      // Skip missed frames rather than bursting to catch up:
+	      next_frame += frame_period;
+	      if( next_frame < now )
+		{
+		  next_frame = now + frame_period;
+		}
+	    }
+
+	  if( now >= next_report )
+	    {
+	      report();
+	      next_report += std::chrono::seconds( 1 );
+	    }
+
+	  // Wait for handshake commands until the next frame is due:
+	  int timeout_ms = std::chrono::duration_cast<std::chrono::milliseconds>( next_frame - Clock::now() ).count();
+	  int res = poll( fds.data(), fds.size(), std::max( timeout_ms, 0 ) );
+	  if( res < 0 && errno != EINTR )
+	    {
+	      std::cerr << "Failed to poll radar sockets: " << strerror( errno ) << std::endl;
+	      break;
+	    }
+
+	  for( std::size_t i = 0; res > 0 && i < fds.size(); ++i )
+	    {
+	      if( fds.at( i ).revents & POLLIN )
+		{
+		  handleCommand( radars_.at( i ) );
+		}
+	    }
+	}
+
+      report();
+    }
+
+  private:
+    void handleCommand( EmulatedRadar& radar )
+    {
+      char cmd[64];
+      struct sockaddr_in src_addr;
+      socklen_t src_addr_len = sizeof( src_addr );
+      int len = recvfrom( radar.sockfd, cmd, sizeof( cmd ), 0, ( struct sockaddr* )( &src_addr ), &src_addr_len );
+      if( len <= 0 )
+	{
+	  return;
+	}
+
+      std::string cmd_str( cmd, len );
+      if( cmd_str == ainstein_radar_drivers::RadarDriverO79UDP::connect_cmd_str )
+	{
+	  // The drivers only check the length of the connect response:
+	  std::vector<char> res( ainstein_radar_drivers::RadarDriverO79UDP::connect_res_len, 0 );
+	  sendto( radar.sockfd, res.data(), res.size(), 0, ( struct sockaddr* )( &src_addr ), src_addr_len );
+	}
+      else if( cmd_str == ainstein_radar_drivers::RadarDriverO79UDP::run_cmd_str )
+	{
+	  // Stream to whoever sent the run command:
+	  radar.dest = src_addr;
+	  radar.running = true;
+	  std::cout << "Radar on port " << ntohs( getPort( radar ) ) << " streaming to "
+		    << inet_ntoa( src_addr.sin_addr ) << ":" << ntohs( src_addr.sin_port ) << std::endl;
+	}
+      else
+	{
+	  std::cerr << "Ignoring unknown command: " << cmd_str << std::endl;
+	}
+    }
+
+    uint16_t getPort( const EmulatedRadar& radar )
+    {
+      struct sockaddr_in addr;
+      socklen_t addr_len = sizeof( addr );
+      getsockname( radar.sockfd, ( struct sockaddr* )( &addr ), &addr_len );
+      return addr.sin_port;
+    }
+
+    void sendFrame( EmulatedRadar& radar )
+    {
+      switch( opts_.model )
+	{
+	case MODEL_K79:
+	  sendTargets( radar, opts_.num_targets, "", 0 );
+	  sendTargets( radar, opts_.num_tracked, "\x01\x02\x03\x04\x00\x00\x00\x00", 8 );
+	  break;
+	case MODEL_K79_3D:
+	  sendTargets( radar, opts_.num_targets, "", 0 );
+	  break;
+	case MODEL_O79:
+	  {
+	    char header[8] = { 0 };
+	    header[0] = ainstein_radar_drivers::RadarDriverO79UDP::msg_id_raw_targets;
+	    sendTargets( radar, opts_.num_targets, header, sizeof( header ) );
+	    header[0] = ainstein_radar_drivers::RadarDriverO79UDP::msg_id_tracked_targets;
+	    sendTargets( radar, opts_.num_tracked, header, sizeof( header ) );
+	    header[0] = ainstein_radar_drivers::RadarDriverO79UDP::msg_id_bounding_boxes;
+	    sendRecords( radar, opts_.num_tracked, header, sizeof( header ),
+			 ainstein_radar_drivers::RadarDriverO79UDP::msg_len_bounding_boxes );
+	    header[0] = ainstein_radar_drivers::RadarDriverO79UDP::msg_id_tracked_targets_cart;
+	    sendRecords( radar, opts_.num_tracked, header, sizeof( header ),
+			 ainstein_radar_drivers::RadarDriverO79UDP::msg_len_tracked_targets_cart );
+	    break;
+	  }
+	}
+    }
+
+    void sendTargets( EmulatedRadar& radar, int num_targets, const char* header, int header_len )
+    {
+      sendRecords( radar, num_targets, header, header_len, target_len );
+    }
+
+    // Send one datagram of num_records records after the header, none if there are no records.
+    // The count was capped in parseOptions() to fit:
+    void sendRecords( EmulatedRadar& radar, int num_records, const char* header, int header_len, int record_len )
+    {
+      if( num_records == 0 )
+	{
+	  return;
+	}
+
+      char* buffer = buffer_.data();
+      memcpy( buffer, header, header_len );
+      for( int i = 0; i < num_records; ++i )
+	{
+	  fillRecord( buffer + header_len + i * record_len, record_len );
+	}
+
+      if( opts_.loss > 0.0 && loss_dist_( rng_ ) < opts_.loss )
+	{
+	  ++datagrams_dropped_;
+	  return;
+	}
+
+      if( sendto( radar.sockfd, buffer, header_len + num_records * record_len, 0,
+		  ( struct sockaddr* )( &radar.dest ), sizeof( radar.dest ) ) < 0 )
+	{
+	  ++send_errors_;
+	}
+      else
+	{
+	  ++datagrams_sent_;
+	}
+    }
+
+    // Plausible values for the 8-byte target records, random bytes for the rest:
+    void fillRecord( char* record, int record_len )
+    {
+      for( int b = 0; b < record_len; ++b )
+	{
+	  record[b] = static_cast<char>( byte_dist_( rng_ ) );
+	}
+
+      if( record_len == static_cast<int>( target_len ) )
+	{
+	  int16_t azimuth = static_cast<int16_t>( byte_dist_( rng_ ) % 81 - 40 );
+	  int16_t elevation = static_cast<int16_t>( byte_dist_( rng_ ) % 9 - 4 );
+	  record[0] = azimuth & 0xff;
+	  record[1] = ( azimuth >> 8 ) & 0xff;
+	  record[3] = static_cast<char>( byte_dist_( rng_ ) % 128 );
+	  record[4] = elevation & 0xff;
+	  record[5] = ( elevation >> 8 ) & 0xff;
+	}
+    }
+
+    void report( void )
+    {
+      std::cout << "frames: " << frames_sent_
+		<< " datagrams sent: " << datagrams_sent_
+		<< " dropped: " << datagrams_dropped_
+		<< " send errors: " << send_errors_ << std::endl;
+    }
+
+    EmulatorOptions opts_;
+    std::vector<EmulatedRadar> radars_;
+    std::vector<char> buffer_;
+
+    std::mt19937 rng_;
+    std::uniform_int_distribution<int> byte_dist_;
+    std::uniform_real_distribution<double> loss_dist_;
+
+    uint64_t frames_sent_;
+    uint64_t datagrams_sent_;
+    uint64_t datagrams_dropped_;
+    uint64_t send_errors_;
+  };
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  EmulatorOptions opts;
+  if( !parseOptions( argc, argv, opts ) )
+    {
+      printUsage();
+      return -1;
+    }
+
+  signal( SIGINT, handleSignal );
+  signal( SIGTERM, handleSignal );
+
+  UdpRadarEmulator emulator( opts );
+  if( !emulator.open() )
+    {
+      return -1;
+    }
+
+  emulator.run();
+
+  return 0;
+}
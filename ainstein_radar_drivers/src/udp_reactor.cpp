@@ -0,0 +1,277 @@
+/*
+  Copyright <2018-2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+
+#include "ainstein_radar_drivers/udp_reactor.h"
+
+namespace ainstein_radar_drivers
+{
+  const int UdpReactor::max_events = 16;
+
+  UdpReactor::UdpReactor( int num_threads )
+  {
+    epoll_fd_ = epoll_create1( EPOLL_CLOEXEC );
+    if( epoll_fd_ < 0 )
+      {
+	std::cout << "Failed to create epoll instance: " << std::strerror( errno ) << std::endl;
+      }
+
+    // The eventfd is only ever written to, once, so that every epoll_wait returns promptly on stop:
+    event_fd_ = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+    if( event_fd_ < 0 )
+      {
+	std::cout << "Failed to create eventfd: " << std::strerror( errno ) << std::endl;
+      }
+
+    struct epoll_event ev;
+    memset( &ev, 0, sizeof( ev ) );
+    ev.events = EPOLLIN;
+    ev.data.fd = event_fd_;
+    if( epoll_ctl( epoll_fd_, EPOLL_CTL_ADD, event_fd_, &ev ) < 0 )
+      {
+	std::cout << "Failed to add eventfd to epoll: " << std::strerror( errno ) << std::endl;
+      }
+
+    for( int i = 0; i < std::max( num_threads, 1 ); ++i )
+      {
+	threads_.emplace_back( &UdpReactor::run, this );
+      }
+  }
+
+  UdpReactor::~UdpReactor( void )
+  {
+    stop();
+
+    close( event_fd_ );
+    close( epoll_fd_ );
+  }
+
+  std::shared_ptr<UdpReactor> UdpReactor::instance( void )
+  {
+    static std::mutex instance_mutex;
+    static std::weak_ptr<UdpReactor> instance_weak;
+
+    // The reactor lives as long as some interface holds it:
+    std::lock_guard<std::mutex> lock( instance_mutex );
+    std::shared_ptr<UdpReactor> reactor = instance_weak.lock();
+    if( !reactor )
+      {
+	reactor.reset( new UdpReactor() );
+	instance_weak = reactor;
+      }
+
+    return reactor;
+  }
+
+  bool UdpReactor::addSource( int fd, Handler handler, double period )
+  {
+    // Handlers drain their socket until EAGAIN, so it must not block:
+    int flags = fcntl( fd, F_GETFL, 0 );
+    if( flags < 0 || fcntl( fd, F_SETFL, flags | O_NONBLOCK ) < 0 )
+      {
+	std::cout << "Failed to make socket non-blocking: " << std::strerror( errno ) << std::endl;
+	return false;
+      }
+
+    std::shared_ptr<Source> source( new Source );
+    source->fd = fd;
+    source->timer_fd = -1;
+    source->handler = handler;
+    source->active = true;
+
+    // A periodic timer wakes the handler through the same source, so the two never overlap:
+    if( period > 0.0 )
+      {
+	source->timer_fd = timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC );
+	if( source->timer_fd < 0 )
+	  {
+	    std::cout << "Failed to create timerfd: " << std::strerror( errno ) << std::endl;
+	    return false;
+	  }
+
+	struct itimerspec spec;
+	spec.it_interval.tv_sec = static_cast<time_t>( period );
+	spec.it_interval.tv_nsec = static_cast<long>( ( period - spec.it_interval.tv_sec ) * 1e9 );
+	spec.it_value = spec.it_interval;
+	timerfd_settime( source->timer_fd, 0, &spec, NULL );
+      }
+
+    {
+      std::lock_guard<std::mutex> lock( sources_mutex_ );
+      sources_[fd] = source;
+      if( source->timer_fd >= 0 )
+	{
+	  sources_[source->timer_fd] = source;
+	}
+    }
+
+    if( !watch( fd ) || ( source->timer_fd >= 0 && !watch( source->timer_fd ) ) )
+      {
+	std::cout << "Failed to add socket to epoll: " << std::strerror( errno ) << std::endl;
+	removeSource( fd );
+	return false;
+      }
+
+    return true;
+  }
+
+  bool UdpReactor::watch( int fd )
+  {
+    // One-shot so that only one thread handles a socket at a time, it is re-armed after the handler:
+    struct epoll_event ev;
+    memset( &ev, 0, sizeof( ev ) );
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.fd = fd;
+    return ( epoll_ctl( epoll_fd_, EPOLL_CTL_ADD, fd, &ev ) == 0 );
+  }
+
+  void UdpReactor::removeSource( int fd )
+  {
+    std::shared_ptr<Source> source;
+    {
+      std::lock_guard<std::mutex> lock( sources_mutex_ );
+      auto it = sources_.find( fd );
+      if( it == sources_.end() )
+	{
+	  return;
+	}
+      source = it->second;
+      sources_.erase( it );
+      if( source->timer_fd >= 0 )
+	{
+	  sources_.erase( source->timer_fd );
+	}
+    }
+
+    epoll_ctl( epoll_fd_, EPOLL_CTL_DEL, fd, NULL );
+    if( source->timer_fd >= 0 )
+      {
+	epoll_ctl( epoll_fd_, EPOLL_CTL_DEL, source->timer_fd, NULL );
+      }
+
+    // Waits for a handler already in progress, later dispatches see the source inactive:
+    std::lock_guard<std::mutex> lock( source->mutex );
+    source->active = false;
+    if( source->timer_fd >= 0 )
+      {
+	close( source->timer_fd );
+	source->timer_fd = -1;
+      }
+  }
+
+  void UdpReactor::stop( void )
+  {
+    uint64_t one = 1;
+    if( write( event_fd_, &one, sizeof( one ) ) < 0 && errno != EAGAIN )
+      {
+	std::cout << "Failed to signal reactor shutdown: " << std::strerror( errno ) << std::endl;
+      }
+
+    for( auto& t : threads_ )
+      {
+	if( t.joinable() && t.get_id() != std::this_thread::get_id() )
+	  {
+	    t.join();
+	  }
+      }
+  }
+
+  void UdpReactor::run( void )
+  {
+    struct epoll_event events[UdpReactor::max_events];
+    while( true )
+      {
+	int num_events = epoll_wait( epoll_fd_, events, UdpReactor::max_events, -1 );
+	if( num_events < 0 )
+	  {
+	    if( errno == EINTR )
+	      {
+		continue;
+	      }
+
+	    std::cout << "Failed to wait for socket events: " << std::strerror( errno ) << std::endl;
+	    return;
+	  }
+
+	for( int i = 0; i < num_events; ++i )
+	  {
+	    int fd = events[i].data.fd;
+
+	    // The eventfd stays readable once written, so every reactor thread sees it:
+	    if( fd == event_fd_ )
+	      {
+		return;
+	      }
+
+	    std::shared_ptr<Source> source;
+	    {
+	      std::lock_guard<std::mutex> lock( sources_mutex_ );
+	      auto it = sources_.find( fd );
+	      if( it == sources_.end() )
+		{
+		  continue;
+		}
+	      source = it->second;
+	    }
+
+	    std::lock_guard<std::mutex> lock( source->mutex );
+	    if( source->active )
+	      {
+		// Acknowledge the timer, the handler is called the same either way:
+		if( fd == source->timer_fd )
+		  {
+		    uint64_t expirations;
+		    if( read( fd, &expirations, sizeof( expirations ) ) < 0 && errno != EAGAIN )
+		      {
+			std::cout << "Failed to read timerfd: " << std::strerror( errno ) << std::endl;
+		      }
+		  }
+
+		source->handler();
+
+		struct epoll_event ev;
+		memset( &ev, 0, sizeof( ev ) );
+		ev.events = EPOLLIN | EPOLLONESHOT;
+		ev.data.fd = fd;
+		epoll_ctl( epoll_fd_, EPOLL_CTL_MOD, fd, &ev );
+	      }
+	  }
+      }
+  }
+
+} // namespace ainstein_radar_drivers
@@ -0,0 +1,48 @@
+#!/usr/bin/env python
+#
+# Checks that a driver publishes whole radar frames: every message on the topic has
+# exactly the expected number of targets, as sent by udp_radar_emulator.
+#
+# Parameters: ~topic, ~targets (per frame), ~num_frames (to check), ~timeout (s)
+
+import sys
+import threading
+import unittest
+
+import rospy
+import rostest
+from ainstein_radar_msgs.msg import RadarTargetArray
+
+PKG = 'ainstein_radar_drivers'
+
+
+class FrameSizeTest(unittest.TestCase):
+
+    def test_frame_size(self):
+        topic = rospy.get_param('~topic')
+        targets = rospy.get_param('~targets')
+        num_frames = rospy.get_param('~num_frames', 20)
+        timeout = rospy.get_param('~timeout', 10.0)
+
+        sizes = []
+        done = threading.Event()
+
+        def callback(msg):
+            if len(sizes) < num_frames:
+                sizes.append(len(msg.targets))
+            if len(sizes) >= num_frames:
+                done.set()
+
+        sub = rospy.Subscriber(topic, RadarTargetArray, callback)
+        done.wait(timeout)
+        sub.unregister()
+
+        self.assertEqual(len(sizes), num_frames,
+                         'only %d of %d frames received on %s' % (len(sizes), num_frames, topic))
+        self.assertEqual(sizes, [targets] * num_frames,
+                         'frames on %s should have %d targets each' % (topic, targets))
+
+
+if __name__ == '__main__':
+    rospy.init_node('frame_size_test')
+    rostest.rosrun(PKG, 'frame_size_test', FrameSizeTest, sys.argv)
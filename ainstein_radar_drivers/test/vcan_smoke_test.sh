@@ -0,0 +1,76 @@
+#!/bin/bash
+#
+# Smoke test of the T79 SocketCAN path on a virtual CAN device, no radar needed:
+# brings up vcan0, starts t79_node on it, plays one start/target/stop frame
+# sequence with cansend and checks that the target comes out on targets/raw.
+# Needs a sourced ROS workspace, can-utils, and root (or sudo) for the vcan setup.
+#
+# usage: vcan_smoke_test.sh [device]
+
+DEVICE=${1:-vcan0}
+NODE=t79_smoke_test
+TMP=$(mktemp -d)
+
+SUDO=""
+if [ "$(id -u)" != "0" ]; then
+    SUDO=sudo
+fi
+
+fail() {
+    echo "FAIL: $1" >&2
+    exit 1
+}
+
+cleanup() {
+    kill $NODE_PID $ECHO_PID $DUMP_PID $CORE_PID 2>/dev/null
+    wait 2>/dev/null
+    rm -rf "$TMP"
+}
+trap cleanup EXIT
+
+# Bring up the virtual CAN device:
+if ! ip link show "$DEVICE" >/dev/null 2>&1; then
+    $SUDO modprobe vcan || fail "cannot load the vcan module"
+    $SUDO ip link add dev "$DEVICE" type vcan || fail "cannot create $DEVICE"
+fi
+$SUDO ip link set up "$DEVICE" || fail "cannot bring up $DEVICE"
+
+# Start a master unless one is already running:
+if ! rostopic list >/dev/null 2>&1; then
+    roscore >"$TMP/roscore.log" 2>&1 &
+    CORE_PID=$!
+    for i in $(seq 50); do
+        rostopic list >/dev/null 2>&1 && break
+        sleep 0.2
+    done
+fi
+
+# Record the commands the driver puts on the bus:
+candump -L "$DEVICE,100:7FF" >"$TMP/commands.log" &
+DUMP_PID=$!
+
+rosrun ainstein_radar_drivers t79_node __name:=$NODE _can_device:=$DEVICE _can_id:=0 \
+       >"$TMP/node.log" 2>&1 &
+NODE_PID=$!
+
+rostopic echo -n 1 /$NODE/targets/raw >"$TMP/raw.log" &
+ECHO_PID=$!
+
+# Play frames until the target is published: start frame, one raw target with SNR 30
+# at 10.00 m, 0 m/s and 0 deg, then the stop frame:
+for i in $(seq 50); do
+    sleep 0.2
+    cansend "$DEVICE" 420#0000000000000000
+    cansend "$DEVICE" 4A0#011E03E800000000
+    cansend "$DEVICE" 480#0000000000000000
+    kill -0 $ECHO_PID 2>/dev/null || break
+done
+
+kill -0 $NODE_PID 2>/dev/null || { cat "$TMP/node.log" >&2; fail "t79_node exited"; }
+grep -q "range: 10.0" "$TMP/raw.log" || { cat "$TMP/node.log" >&2; fail "no target on /$NODE/targets/raw"; }
+
+# Both the start and the initial ZOI command should have gone out on the bus:
+grep -q "100#01" "$TMP/commands.log" || fail "start command not sent on $DEVICE"
+grep -q "100#04" "$TMP/commands.log" || fail "ZOI command not sent on $DEVICE"
+
+echo "PASS: target received on /$NODE/targets/raw"
@@ -1,7 +1,9 @@
 #ifndef RADAR_DATA_CONVERSIONS_H_
 #define RADAR_DATA_CONVERSIONS_H_
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 #include <pcl_ros/point_cloud.h>
 #include <geometry_msgs/Twist.h>
@@ -9,7 +11,9 @@
 #include <tf2_ros/transform_listener.h>
 #include <tf2_eigen/tf2_eigen.h>
 
+#include <ainstein_radar_core/conversions.h>
 #include <ainstein_radar_msgs/RadarTargetArray.h>
+#include <ainstein_radar_msgs/RadarFrame.h>
 #include <ainstein_radar_filters/pcl_point_radar_target.h>
 
 namespace ainstein_radar_filters
@@ -19,23 +23,30 @@ namespace ainstein_radar_filters
     static void sphericalToCartesian( double range, double azimuth, double elevation,
 				      Eigen::Vector3d& p )
     {
-      // Convert spherical coordinates to Cartesian coordinates. Range and point xyz are in
-      // meters, angles are in radians.
-      p.x() = range * cos( azimuth ) * cos( elevation );
-      p.y() = range * sin( azimuth ) * cos( elevation );
-      p.z() = range * sin( elevation );
+      ainstein_radar_core::sphericalToCartesian( range, azimuth, elevation, p );
     }
 
     static void cartesianToSpherical( const Eigen::Vector3d& p,
 				      double& range, double& azimuth, double& elevation )
     {
-      // Convert Cartesian coordinates to spherical coordinates. Range and point xyz are in
-      // meters, angles are in radians.
-      range = std::sqrt( std::pow( p.x(), 2.0 ) +
-			 std::pow( p.y(), 2.0 ) +
-			 std::pow( p.z(), 2.0 ) );
-      azimuth = std::atan2( p.y(), p.x() );
-      elevation = std::asin( p.z() / range );
+      ainstein_radar_core::cartesianToSpherical( p, range, azimuth, elevation );
+    }
+
+    static void radarTargetToRosMsg( const ainstein_radar_core::RadarTarget& target,
+				     ainstein_radar_msgs::RadarTarget& msg )
+    {
+      msg.target_id = target.id;
+      msg.range = target.range;
+      msg.speed = target.speed;
+      msg.azimuth = target.azimuth;
+      msg.elevation = target.elevation;
+      msg.snr = target.snr;
+    }
+
+    static ainstein_radar_core::RadarTarget rosMsgToRadarTarget( const ainstein_radar_msgs::RadarTarget& msg )
+    {
+      return ainstein_radar_core::RadarTarget( msg.target_id, msg.range, msg.speed,
+					       msg.azimuth, msg.elevation, msg.snr );
     }
 
     static void radarTargetToPclPoint( const ainstein_radar_msgs::RadarTarget& target,
@@ -133,6 +144,85 @@ namespace ainstein_radar_filters
       pclCloudToRadarTargetArray( pcl_cloud, target_array );
     }
 
+    static void setDefaultRadarFrameScales( ainstein_radar_msgs::RadarFrame& frame )
+    {
+      // 1 cm and 1 cm/s cover +-327 m of range and +-327 m/s of speed, finer than the
+      // accuracy of any of the radars; SNR is reported in integer steps:
+      frame.range_scale = 0.01;
+      frame.speed_scale = 0.01;
+      frame.azimuth_scale = 0.01;
+      frame.elevation_scale = 0.01;
+      frame.snr_scale = 1.0;
+    }
+
+    template <typename int_type>
+    static int_type quantizeRadarValue( double value, double scale )
+    {
+      // Round to the nearest step, saturating at the integer limits (and mapping NaN,
+      // or anything with an invalid scale, to zero):
+      double steps = std::round( value / scale );
+      if( std::isnan( steps ) || !( scale > 0.0 ) )
+	{
+	  return 0;
+	}
+      steps = std::max( steps, static_cast<double>( std::numeric_limits<int_type>::min() ) );
+      steps = std::min( steps, static_cast<double>( std::numeric_limits<int_type>::max() ) );
+      return static_cast<int_type>( steps );
+    }
+
+    static void radarTargetArrayToRadarFrame( const ainstein_radar_msgs::RadarTargetArray& target_array,
+					      ainstein_radar_msgs::RadarFrame& frame )
+    {
+      // Quantize each target field into its column, using the scales already set in frame:
+      frame.header = target_array.header;
+
+      std::size_t n = target_array.targets.size();
+      frame.target_id.resize( n );
+      frame.range.resize( n );
+      frame.speed.resize( n );
+      frame.azimuth.resize( n );
+      frame.elevation.resize( n );
+      frame.snr.resize( n );
+
+      for( std::size_t i = 0; i < n; ++i )
+	{
+	  const ainstein_radar_msgs::RadarTarget& target = target_array.targets[i];
+	  frame.target_id[i] = target.target_id;
+	  frame.range[i] = quantizeRadarValue<int16_t>( target.range, frame.range_scale );
+	  frame.speed[i] = quantizeRadarValue<int16_t>( target.speed, frame.speed_scale );
+	  frame.azimuth[i] = quantizeRadarValue<int16_t>( target.azimuth, frame.azimuth_scale );
+	  frame.elevation[i] = quantizeRadarValue<int16_t>( target.elevation, frame.elevation_scale );
+	  frame.snr[i] = quantizeRadarValue<uint16_t>( target.snr, frame.snr_scale );
+	}
+    }
+
+    static bool radarFrameToRadarTargetArray( const ainstein_radar_msgs::RadarFrame& frame,
+					      ainstein_radar_msgs::RadarTargetArray& target_array )
+    {
+      // Refuse frames whose columns do not all have the same length:
+      std::size_t n = frame.target_id.size();
+      if( frame.range.size() != n || frame.speed.size() != n || frame.azimuth.size() != n ||
+	  frame.elevation.size() != n || frame.snr.size() != n )
+	{
+	  return false;
+	}
+
+      target_array.header = frame.header;
+      target_array.targets.resize( n );
+      for( std::size_t i = 0; i < n; ++i )
+	{
+	  ainstein_radar_msgs::RadarTarget& target = target_array.targets[i];
+	  target.target_id = frame.target_id[i];
+	  target.range = frame.range[i] * frame.range_scale;
+	  target.speed = frame.speed[i] * frame.speed_scale;
+	  target.azimuth = frame.azimuth[i] * frame.azimuth_scale;
+	  target.elevation = frame.elevation[i] * frame.elevation_scale;
+	  target.snr = frame.snr[i] * frame.snr_scale;
+	}
+
+      return true;
+    }
+
     /* static void transformRadarTargetArray( const std::string& target_frame, */
     /* 					   const ainstein_radar_msgs::RadarTargetArray& radar_in, */
     /* 					   ainstein_radar_msgs::RadarTargetArray& radar_out, */
@@ -0,0 +1,32 @@
+#ifndef RADAR_FRAME_TO_RADAR_TARGET_ARRAY_H_
+#define RADAR_FRAME_TO_RADAR_TARGET_ARRAY_H_
+
+#include <ros/ros.h>
+
+#include <ainstein_radar_msgs/RadarTargetArray.h>
+#include <ainstein_radar_msgs/RadarFrame.h>
+#include <ainstein_radar_filters/data_conversions.h>
+
+namespace ainstein_radar_filters
+{
+  // Unpacks RadarFrame messages back into RadarTargetArray messages, so that
+  // recorded or remotely received frames can feed any of the other filters.
+  class RadarFrameToRadarTargetArray
+  {
+  public:
+    RadarFrameToRadarTargetArray( ros::NodeHandle node_handle,
+				  ros::NodeHandle node_handle_private );
+    ~RadarFrameToRadarTargetArray() {}
+    
+    void radarFrameCallback( const ainstein_radar_msgs::RadarFrame::ConstPtr &msg );
+    
+  private:
+    ros::NodeHandle nh_;
+    ros::NodeHandle nh_private_;
+    ros::Subscriber sub_radar_frame_;
+    ros::Publisher pub_radar_data_;
+  };
+  
+} // namespace ainstein_radar_filters
+
+#endif // RADAR_FRAME_TO_RADAR_TARGET_ARRAY_H_
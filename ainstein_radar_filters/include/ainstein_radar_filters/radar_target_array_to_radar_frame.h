@@ -0,0 +1,36 @@
+#ifndef RADAR_TARGET_ARRAY_TO_RADAR_FRAME_H_
+#define RADAR_TARGET_ARRAY_TO_RADAR_FRAME_H_
+
+#include <ros/ros.h>
+
+#include <ainstein_radar_msgs/RadarTargetArray.h>
+#include <ainstein_radar_msgs/RadarFrame.h>
+#include <ainstein_radar_filters/data_conversions.h>
+
+namespace ainstein_radar_filters
+{
+  // Packs RadarTargetArray messages into the compact RadarFrame message, e.g. for
+  // logging or sending radar data over a slow link. The quantization steps are set
+  // by the range_scale, speed_scale, azimuth_scale, elevation_scale and snr_scale
+  // parameters.
+  class RadarTargetArrayToRadarFrame
+  {
+  public:
+    RadarTargetArrayToRadarFrame( ros::NodeHandle node_handle,
+				  ros::NodeHandle node_handle_private );
+    ~RadarTargetArrayToRadarFrame() {}
+    
+    void radarDataCallback( const ainstein_radar_msgs::RadarTargetArray::ConstPtr &msg );
+    
+  private:
+    ros::NodeHandle nh_;
+    ros::NodeHandle nh_private_;
+    ros::Subscriber sub_radar_data_;
+    ros::Publisher pub_radar_frame_;
+
+    ainstein_radar_msgs::RadarFrame scales_;
+  };
+  
+} // namespace ainstein_radar_filters
+
+#endif // RADAR_TARGET_ARRAY_TO_RADAR_FRAME_H_
@@ -4,8 +4,8 @@
 #include <thread>
 #include <mutex>
 
+#include <ainstein_radar_core/tracking_filter_cartesian.h>
 #include <ainstein_radar_filters/data_conversions.h>
-#include <ainstein_radar_filters/radar_target_cartesian_kf.h>
 #include <ainstein_radar_filters/TrackingFilterCartesianConfig.h>
 #include <ainstein_radar_msgs/RadarTargetArray.h>
 #include <dynamic_reconfigure/server.h>
@@ -17,6 +17,8 @@
 
 namespace ainstein_radar_filters
 {
+  // ROS interface to the Cartesian tracker in ainstein_radar_core. Times passed to the
+  // tracker come from ros::Time, so simulated time is used when it is enabled.
   class TrackingFilterCartesian
   {
   public:
@@ -37,21 +39,23 @@ namespace ainstein_radar_filters
     {
       // Copy the new parameter values:
       filter_update_rate_ = config.filter_update_rate;
-      filter_min_time_ = config.filter_min_time;
-      filter_timeout_ = config.filter_timeout;
-      filter_val_gate_thresh_ = config.filter_val_gate_thresh;
+
+      ainstein_radar_core::TrackingFilterCartesian::FilterParameters params;
+      params.filter_min_time = config.filter_min_time;
+      params.filter_timeout = config.filter_timeout;
+      params.filter_val_gate_thresh = config.filter_val_gate_thresh;
 
       // Set the parameters for the underlying target Kalman Filters:
-      RadarTargetCartesianKF::FilterParameters kf_params;
-      kf_params.init_pos_stdev = config.kf_init_pos_stdev;
-      kf_params.init_vel_stdev = config.kf_init_vel_stdev;
+      params.kf_params.init_pos_stdev = config.kf_init_pos_stdev;
+      params.kf_params.init_vel_stdev = config.kf_init_vel_stdev;
 
-      kf_params.q_vel_stdev = config.kf_q_vel_stdev;
+      params.kf_params.q_vel_stdev = config.kf_q_vel_stdev;
 
-      kf_params.r_speed_stdev = config.kf_r_speed_stdev;
-      kf_params.r_pos_stdev = config.kf_r_pos_stdev;
+      params.kf_params.r_speed_stdev = config.kf_r_speed_stdev;
+      params.kf_params.r_pos_stdev = config.kf_r_pos_stdev;
 
-      RadarTargetCartesianKF::setFilterParameters( kf_params );
+      std::lock_guard<std::mutex> lock( mutex_ );
+      tracker_.setFilterParameters( params );
     }
       
     void initialize( void );
@@ -67,22 +71,6 @@ namespace ainstein_radar_filters
 
     void radarTargetArrayCallback( const ainstein_radar_msgs::RadarTargetArray &msg );
 
-    ainstein_radar_msgs::BoundingBox getBoundingBox( const ainstein_radar_msgs::RadarTarget& tracked_target, const ainstein_radar_msgs::RadarTargetArray& targets );
-
-    Eigen::Vector3d radarTargetToPoint( const ainstein_radar_msgs::RadarTarget& target )
-    {
-      Eigen::Vector3d point;
-      point.x() = cos( ( M_PI / 180.0 ) * target.azimuth ) * cos( ( M_PI / 180.0 ) * target.elevation )
-	* target.range;
-      point.y() = sin( ( M_PI / 180.0 ) * target.azimuth ) * cos( ( M_PI / 180.0 ) * target.elevation )
-	* target.range;
-      point.z() = sin( ( M_PI / 180.0 ) * target.elevation ) * target.range;
-
-      return point;
-    }
-    
-    static const int max_tracked_targets;
-    
   private:
     ros::NodeHandle nh_;
     ros::NodeHandle nh_private_;
@@ -90,9 +78,6 @@ namespace ainstein_radar_filters
     // Parameters:
     dynamic_reconfigure::Server<ainstein_radar_filters::TrackingFilterCartesianConfig> dyn_config_server_;
     double filter_update_rate_;
-    double filter_min_time_;
-    double filter_timeout_;
-    double filter_val_gate_thresh_;
     
     ros::Subscriber sub_radar_data_raw_;
     ros::Subscriber sub_point_cloud_raw_;
@@ -102,15 +87,15 @@ namespace ainstein_radar_filters
     
     ainstein_radar_msgs::RadarTargetArray msg_tracked_targets_;
     geometry_msgs::PoseArray msg_tracked_poses_;
-    std::vector<ainstein_radar_msgs::RadarTargetArray> msg_tracked_clusters_;
     ainstein_radar_msgs::BoundingBoxArray msg_tracked_boxes_;
 
     std::unique_ptr<std::thread> filter_update_thread_;
     std::mutex mutex_;
-    
-    std::vector<ainstein_radar_filters::RadarTargetCartesianKF> filters_;
-    std::vector<ainstein_radar_msgs::RadarTargetArray> filter_targets_;
-    std::vector<int> meas_count_vec_;
+
+    // Tracker and the buffers passed to it, guarded by mutex_:
+    ainstein_radar_core::TrackingFilterCartesian tracker_;
+    std::vector<ainstein_radar_core::RadarTarget> targets_;
+    std::vector<ainstein_radar_core::TrackingFilterCartesian::TrackedObject> tracked_objects_;
   };
 
 } // namespace ainstein_radar_filters
@@ -0,0 +1,56 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "ainstein_radar_filters/radar_frame_to_radar_target_array.h"
+
+namespace ainstein_radar_filters
+{
+
+  RadarFrameToRadarTargetArray::RadarFrameToRadarTargetArray( ros::NodeHandle node_handle,
+							      ros::NodeHandle node_handle_private ) :
+    nh_( node_handle ),
+    nh_private_( node_handle_private )
+  {
+    sub_radar_frame_ = nh_.subscribe( "frame_in", 10,
+				      &RadarFrameToRadarTargetArray::radarFrameCallback,
+				      this );
+
+    pub_radar_data_ = nh_private_.advertise<ainstein_radar_msgs::RadarTargetArray>( "radar_out", 10 );
+  }
+
+  void RadarFrameToRadarTargetArray::radarFrameCallback( const ainstein_radar_msgs::RadarFrame::ConstPtr &msg )
+  {
+    boost::shared_ptr<ainstein_radar_msgs::RadarTargetArray> radar_msg( new ainstein_radar_msgs::RadarTargetArray );
+    if( !data_conversions::radarFrameToRadarTargetArray( *msg, *radar_msg ) )
+      {
+	ROS_WARN_STREAM_THROTTLE( 1.0, "Dropping a radar frame whose columns differ in length" );
+	return;
+      }
+
+    pub_radar_data_.publish( boost::shared_ptr<const ainstein_radar_msgs::RadarTargetArray>( radar_msg ) );
+  } 
+  
+}// namespace ainstein_radar_filters
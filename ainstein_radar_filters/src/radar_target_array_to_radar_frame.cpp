@@ -0,0 +1,77 @@
+/*
+  Copyright <2020> <Ainstein, Inc.>
+
+  Redistribution and use in source and binary forms, with or without modification, are permitted 
+  provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this list of 
+  conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice, this list of 
+  conditions and the following disclaimer in the documentation and/or other materials provided 
+  with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors may be used to 
+  endorse or promote products derived from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR 
+  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND 
+  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL 
+  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY 
+  OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ainstein_radar_filters/radar_target_array_to_radar_frame.h"
+
+namespace ainstein_radar_filters
+{
+
+  RadarTargetArrayToRadarFrame::RadarTargetArrayToRadarFrame( ros::NodeHandle node_handle,
+							      ros::NodeHandle node_handle_private ) :
+    nh_( node_handle ),
+    nh_private_( node_handle_private )
+  {
+    // Get the quantization steps, falling back to the defaults for invalid ones:
+    data_conversions::setDefaultRadarFrameScales( scales_ );
+    std::vector<std::pair<std::string, float*>> scales = { { "range_scale", &scales_.range_scale },
+							    { "speed_scale", &scales_.speed_scale },
+							    { "azimuth_scale", &scales_.azimuth_scale },
+							    { "elevation_scale", &scales_.elevation_scale },
+							    { "snr_scale", &scales_.snr_scale } };
+    for( const auto& s : scales )
+      {
+	double scale;
+	nh_private_.param( s.first, scale, static_cast<double>( *s.second ) );
+	if( scale > 0.0 )
+	  {
+	    *s.second = scale;
+	  }
+	else
+	  {
+	    ROS_WARN_STREAM( "Invalid " << s.first << " " << scale << ", using " << *s.second );
+	  }
+      }
+
+    sub_radar_data_ = nh_.subscribe( "radar_in", 10,
+				     &RadarTargetArrayToRadarFrame::radarDataCallback,
+				     this );
+
+    pub_radar_frame_ = nh_private_.advertise<ainstein_radar_msgs::RadarFrame>( "frame_out", 10 );
+  }
+
+  void RadarTargetArrayToRadarFrame::radarDataCallback( const ainstein_radar_msgs::RadarTargetArray::ConstPtr &msg )
+  {
+    // Publish a fresh message, which nodelet subscribers can share without a copy:
+    boost::shared_ptr<ainstein_radar_msgs::RadarFrame> frame_msg( new ainstein_radar_msgs::RadarFrame( scales_ ) );
+    data_conversions::radarTargetArrayToRadarFrame( *msg, *frame_msg );
+    pub_radar_frame_.publish( boost::shared_ptr<const ainstein_radar_msgs::RadarFrame>( frame_msg ) );
+  } 
+  
+}// namespace ainstein_radar_filters
@@ -28,8 +28,6 @@
 
 namespace ainstein_radar_filters
 {
-  const int TrackingFilterCartesian::max_tracked_targets = 100;
-
   void TrackingFilterCartesian::initialize( void )
   {
     // Set up raw radar data subscriber and tracked radar data publisher:
@@ -48,8 +46,8 @@ namespace ainstein_radar_filters
 
     pub_bounding_boxes_ = nh_private_.advertise<ainstein_radar_msgs::BoundingBoxArray>( "boxes", 1 );
     
-    // Reserve space for the maximum number of target Kalman Filters:
-    filters_.reserve( TrackingFilterCartesian::max_tracked_targets );
+    // Reserve space for the maximum number of tracked objects:
+    tracked_objects_.reserve( ainstein_radar_core::TrackingFilterCartesian::max_tracked_targets );
 
     // Launch the periodic filter update thread:
     filter_update_thread_ = std::unique_ptr<std::thread>( new std::thread( &TrackingFilterCartesian::updateFiltersLoop,
@@ -86,59 +84,37 @@ namespace ainstein_radar_filters
 	// Block callback from modifying the filters
 	mutex_.lock();
 
-	// Remove filters which have not been updated in specified time:
-	//ROS_DEBUG_STREAM( "Number of filters before pruning: " << filters_.size() << std::endl );
-	if( filters_.size() > 0 )
-	  {
-	    filters_.erase( std::remove_if( filters_.begin(),
-	    				    filters_.end(),
-	    				    [&]( const RadarTargetCartesianKF& kf ){ return ( kf.getTimeSinceUpdate() > filter_timeout_ ); } ),
-			    filters_.end() );
-	  }
-	//ROS_DEBUG_STREAM( "Number of filters after pruning: " << filters_.size() << std::endl );
-	
-	// Run process model for each filter:
-	for( auto& kf : filters_ )
-	  {    
-	    kf.process( dt );
-	  }
+	// Remove timed out filters and run the process model for the rest:
+	tracker_.processFilters( dt, time_now.toSec() );
 
-	// Add tracked targets for filters which have been running for specified time:
-	msg_tracked_targets_.targets.clear();
-	msg_tracked_poses_.poses.clear();
+	// Get the objects whose filters have been running for specified time:
+	tracker_.getTrackedObjects( time_now.toSec(), tracked_objects_ );
 
 	// Set timestamp for output messages:
-	msg_tracked_targets_.header.stamp = ros::Time::now();
-	msg_tracked_poses_.header.stamp = ros::Time::now();
-	msg_tracked_boxes_.header.stamp = ros::Time::now();
-
-	// Clear the tracked "clusters" message and publisher:
-	msg_tracked_clusters_.clear();
-	msg_tracked_boxes_.boxes.clear();
-	
-	ainstein_radar_msgs::RadarTarget tracked_target;
-	geometry_msgs::Pose tracked_pose;
-	int target_id = 0;
-	for( int i = 0; i < filters_.size(); ++i )
+	msg_tracked_targets_.header.stamp = time_now;
+	msg_tracked_poses_.header.stamp = time_now;
+	msg_tracked_boxes_.header.stamp = time_now;
+
+	msg_tracked_targets_.targets.resize( tracked_objects_.size() );
+	msg_tracked_poses_.poses.resize( tracked_objects_.size() );
+	msg_tracked_boxes_.boxes.resize( tracked_objects_.size() );
+	for( std::size_t i = 0; i < tracked_objects_.size(); ++i )
 	  {
-	    if( filters_.at( i ).getTimeSinceStart() >= filter_min_time_ )
-	      {
-		// Fill the tracked targets message:
-		tracked_target = filters_.at( i ).getState().asMsg();
-		tracked_target.target_id = target_id;
-		msg_tracked_targets_.targets.push_back( tracked_target );
+	    const auto& object = tracked_objects_.at( i );
 
-		// Fill the tracked poses message:
-		tracked_pose = filters_.at( i ).getState().asPose();
-		msg_tracked_poses_.poses.push_back( tracked_pose );
-		
-		// Fill the tracked target clusters message:
-		msg_tracked_clusters_.push_back( filter_targets_.at( i ) );
+	    // Fill the tracked targets message:
+	    data_conversions::radarTargetToRosMsg( object.target, msg_tracked_targets_.targets.at( i ) );
 
-		msg_tracked_boxes_.boxes.push_back( getBoundingBox( tracked_target, filter_targets_.at( i ) ) );
-		
-		++target_id;
-	      }
+	    // Fill the tracked poses message:
+	    msg_tracked_poses_.poses.at( i ) = tf2::toMsg( object.pose );
+
+	    // Fill the bounding boxes message:
+	    ainstein_radar_msgs::BoundingBox& box = msg_tracked_boxes_.boxes.at( i );
+	    box.header = msg_tracked_boxes_.header;
+	    box.pose = tf2::toMsg( object.box.pose );
+	    box.dimensions.x = object.box.dimensions.x();
+	    box.dimensions.y = object.box.dimensions.y();
+	    box.dimensions.z = object.box.dimensions.z();
 	  }
 
 	// Release lock on filter state
@@ -166,145 +142,21 @@ namespace ainstein_radar_filters
 
   void TrackingFilterCartesian::radarTargetArrayCallback( const ainstein_radar_msgs::RadarTargetArray& msg )
   {
+    // Block update loop from modifying the filters
+    std::lock_guard<std::mutex> lock( mutex_ );
+
     // Store the frame_id for the messages:
     msg_tracked_targets_.header.frame_id = msg.header.frame_id;
     msg_tracked_poses_.header.frame_id = msg.header.frame_id;
     msg_tracked_boxes_.header.frame_id = msg.header.frame_id;
-    
-    // Reset the measurement count vector for keeping track of which measurements get used:
-    meas_count_vec_.resize( msg.targets.size() );
-    std::fill( meas_count_vec_.begin(), meas_count_vec_.end(), 0 );
 
-    // Block update loop from modifying the filters
-    mutex_.lock();
-    
-    // Resize the targets associated with each filter and set headers:
-    filter_targets_.clear();
-    filter_targets_.resize( filters_.size() );
-    for( auto& targets : filter_targets_ )
-      {
-	targets.header.stamp = ros::Time::now();
-	targets.header.frame_id = msg.header.frame_id;
-      }
-    
     // Pass the raw detections to the filters for updating:
-    for( int i = 0; i < filters_.size(); ++i )
-      {
-	// Form the state-dependent measurement Jacobian:
-	filters_.at( i ).updateMeasJacobian( filters_.at( i ).getState() );
-
-	ROS_DEBUG_STREAM( "Filter " << i << " State: " << filters_.at( i ) );
-	ROS_DEBUG_STREAM( "Filter " << i << " Meas Cov Inv: " << filters_.at( i ).computeMeasCov( filters_.at( i ).getState() ).inverse() << std::endl );
-			for( int j = 0; j < msg.targets.size(); ++j )
-	  {
-	    // Only use this target if it hasn't already been used by a filter:
-	    if( meas_count_vec_.at( j ) == 0 )
-	      {
-		// Check whether the target should be used as measurement by this filter:
-		ainstein_radar_msgs::RadarTarget t = msg.targets.at( j );
-		Eigen::Vector4d z = filters_.at( i ).computePredMeas( filters_.at( i ).getState() );
-		Eigen::Vector4d y = filters_.at( i ).computeMeas( t );
-	    
-		// Compute the normalized measurement error (squared):
-		double meas_err = ( y - z ).transpose() * filters_.at( i ).computeMeasCov( filters_.at( i ).getState() ).inverse() * ( y - z );
-
-		ROS_DEBUG_STREAM( "Target " << j << " meas_err: " << meas_err );
-		ROS_DEBUG_STREAM( "Target " << j << ": " << std::endl << t );
-		Eigen::Vector3d target_pos;
-		data_conversions::sphericalToCartesian( t.range,
-							( M_PI / 180.0 ) * t.azimuth,
-							( M_PI / 180.0 ) * t.elevation,
-							target_pos );
-
-		ROS_DEBUG_STREAM( "Target " << j << " pos: " << std::endl << target_pos );
-		
-		// Allow the measurement through the validation gate based on threshold:
-		if( meas_err < filter_val_gate_thresh_ )
-		  {
-		    filters_.at( i ).update( t );
-		    ++meas_count_vec_.at( j );
-
-		    // Store the target associated with the filter:
-		    filter_targets_.at( i ).targets.push_back( t );
-		  }
-	      }
-	  }
-      }
-
-    ROS_DEBUG_STREAM( "meas_count_vec_: " );
-    for( const auto& ind : meas_count_vec_ )
-      {
-	ROS_DEBUG_STREAM( ind << " " );
-      }
-    ROS_DEBUG_STREAM( std::endl );
-
-    // Iterate through targets and push back new KFs for unused measurements:
-    ainstein_radar_msgs::RadarTargetArray arr;
-    arr.header.stamp = ros::Time::now();
-    arr.header.frame_id = msg.header.frame_id;
-    for( int i = 0; i < meas_count_vec_.size(); ++i )
-      {
-    	if( meas_count_vec_.at( i ) == 0 )
-    	  {
-	    ROS_DEBUG_STREAM( "Pushing back: " << msg.targets.at( i ) << std::endl );
-    	    filters_.emplace_back( msg.targets.at( i ), nh_, nh_private_ );
-	    ROS_DEBUG_STREAM( "New filter state: " << filters_.back().getState() );
-	    // Make sure to push back an empty array of targets associated with the new filter
-	    filter_targets_.push_back( arr );
-    	  }
-      }
-
-    // Release lock on filter state
-    mutex_.unlock();
-  }
-
-  ainstein_radar_msgs::BoundingBox TrackingFilterCartesian::getBoundingBox( const ainstein_radar_msgs::RadarTarget& tracked_target, const ainstein_radar_msgs::RadarTargetArray& targets )
-  {
-    // Find the bounding box dimensions:
-    Eigen::Vector3d min_point = Eigen::Vector3d( std::numeric_limits<double>::infinity(),
-						 std::numeric_limits<double>::infinity(),
-						 std::numeric_limits<double>::infinity() );
-    Eigen::Vector3d max_point = Eigen::Vector3d( -std::numeric_limits<double>::infinity(),
-						 -std::numeric_limits<double>::infinity(),
-						 -std::numeric_limits<double>::infinity() );    
-    if( targets.targets.size() == 0 )
+    targets_.clear();
+    for( const auto& t : msg.targets )
       {
-	min_point = max_point = radarTargetToPoint( tracked_target );
+	targets_.push_back( data_conversions::rosMsgToRadarTarget( t ) );
       }
-    else
-      {
-	for( const auto& t : targets.targets )
-	  {
-	    min_point = min_point.cwiseMin( radarTargetToPoint( t ) );
-	    max_point = max_point.cwiseMax( radarTargetToPoint( t ) );
-	  }
-      }
-    
-    // Check for the case in which the box is degenerative:
-    if( ( max_point - min_point ).norm() < 1e-6 )
-      {
-	min_point -= 0.1 * Eigen::Vector3d::Ones();
-	max_point += 0.1 * Eigen::Vector3d::Ones();
-      }
-    
-    // Compute box pose (identity orientation, geometric center is position):
-    Eigen::Affine3d box_pose;
-    box_pose.linear() = Eigen::Matrix3d::Identity();
-    box_pose.translation() = min_point + ( 0.5 * ( max_point - min_point ) );
-
-    // Form the box message:
-    ainstein_radar_msgs::BoundingBox box;
-
-    box.header.stamp = targets.header.stamp;
-    box.header.frame_id = targets.header.frame_id;
-    
-    box.pose = tf2::toMsg( box_pose );
-    
-    box.dimensions.x = max_point.x() - min_point.x();
-    box.dimensions.y = max_point.y() - min_point.y();
-    box.dimensions.z = 0.1;
-
-    return box;
+    tracker_.updateFilters( targets_, ros::Time::now().toSec() );
   }
     
 } // namespace ainstein_radar_filters
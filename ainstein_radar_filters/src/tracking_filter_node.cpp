@@ -24,8 +24,8 @@
   OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <ainstein_radar_core/tracking_filter.h>
 #include <ainstein_radar_filters/data_conversions.h>
-#include <ainstein_radar_filters/tracking_filter.h>
 #include <ainstein_radar_filters/TrackingFilterConfig.h>
 #include <ainstein_radar_filters/utilities.h>
 #include <ainstein_radar_msgs/RadarTarget.h>
@@ -39,8 +39,8 @@ class TrackingFilterROS
 {
 public:
   TrackingFilterROS(const ros::NodeHandle& node_handle, const ros::NodeHandle& node_handle_private,
-                    double publish_frequency)
-    : nh_(node_handle), nh_private_(node_handle_private)
+                    double publish_frequency, bool event_driven)
+    : nh_(node_handle), nh_private_(node_handle_private), event_driven_(event_driven)
   {
     // Set up dynamic reconfigure:
     dynamic_reconfigure::Server<ainstein_radar_filters::TrackingFilterConfig>::CallbackType f;
@@ -57,7 +57,7 @@ public:
   void dynConfigCallback(const ainstein_radar_filters::TrackingFilterConfig& config, uint32_t level)
   {
     // Copy the new parameter values:
-    ainstein_radar_filters::TrackingFilter::FilterParameters params;
+    ainstein_radar_core::TrackingFilter::FilterParameters params;
     params.filter_process_rate = config.filter_update_rate;
     params.filter_min_time = config.filter_min_time;
     params.filter_timeout = config.filter_timeout;
@@ -92,11 +92,16 @@ public:
 
     pub_bounding_boxes_ = nh_private_.advertise<ainstein_radar_msgs::BoundingBoxArray>("boxes", 1);
 
-    tracking_filter_.initialize();
+    // When event-driven, each message propagates and updates the filters, which are
+    // published right away; otherwise the filters are processed and published periodically:
+    if (!event_driven_)
+    {
+      tracking_filter_.initialize();
 
-    // Launch the periodic publishing thread:
-    publish_thread_ =
-        std::unique_ptr<std::thread>(new std::thread(&TrackingFilterROS::publishLoop, this, publish_freq_));
+      // Launch the periodic publishing thread:
+      publish_thread_ =
+          std::unique_ptr<std::thread>(new std::thread(&TrackingFilterROS::publishLoop, this, publish_freq_));
+    }
   }
 
   void publishLoop(double pub_freq)
@@ -110,54 +115,7 @@ public:
     double dt;
     while (ros::ok() && !ros::isShuttingDown())
     {
-      // Add tracked targets for filters which have been running for specified time:
-      msg_tracked_targets_.targets.clear();
-      msg_tracked_targets_.header.stamp = ros::Time::now();
-
-      std::vector<ainstein_radar_filters::RadarTarget> tracked_objects;
-      tracking_filter_.getTrackedObjects(tracked_objects);
-      for (int i = 0; i < tracked_objects.size(); ++i)
-      {
-        ainstein_radar_msgs::RadarTarget t;
-        t.target_id = i;
-        t.range = tracked_objects.at(i).range;
-        t.speed = tracked_objects.at(i).speed;
-        t.azimuth = tracked_objects.at(i).azimuth;
-        t.elevation = tracked_objects.at(i).elevation;
-
-        msg_tracked_targets_.targets.push_back(t);
-      }
-
-      pub_radar_data_tracked_.publish(msg_tracked_targets_);
-
-      // Get targets associated with alive filters and publish bounding boxes:
-      msg_tracked_boxes_.boxes.clear();
-      msg_tracked_boxes_.header.stamp = ros::Time::now();
-
-      std::vector<std::vector<ainstein_radar_filters::RadarTarget>> tracked_object_targets;
-      tracking_filter_.getTrackedObjectTargets(tracked_object_targets);
-
-      for (const auto& targets : tracked_object_targets)
-      {
-        ainstein_radar_msgs::RadarTargetArray msg_targets;
-        msg_targets.header.frame_id = msg_tracked_boxes_.header.frame_id;  // need to pass this through
-        for (const auto& t : targets)
-        {
-          ainstein_radar_msgs::RadarTarget target;
-          target.range = t.range;
-          target.speed = t.speed;
-          target.azimuth = t.azimuth;
-          target.elevation = t.elevation;
-          msg_targets.targets.push_back(target);
-        }
-
-        ainstein_radar_msgs::BoundingBox box;
-        ainstein_radar_filters::utilities::getTargetsBoundingBox(msg_targets, box);
-
-        msg_tracked_boxes_.boxes.push_back(box);
-      }
-
-      pub_bounding_boxes_.publish(msg_tracked_boxes_);
+      publishTrackedObjects(ros::Time::now());
 
       // Store the current time:
       time_prev = time_now;
@@ -170,19 +128,81 @@ public:
     }
   }
 
+  void publishTrackedObjects(const ros::Time& stamp)
+  {
+    // Add tracked targets for filters which have been running for specified time:
+    msg_tracked_targets_.targets.clear();
+    msg_tracked_targets_.header.stamp = stamp;
+
+    std::vector<ainstein_radar_core::RadarTarget> tracked_objects;
+    tracking_filter_.getTrackedObjects(tracked_objects);
+    for (int i = 0; i < tracked_objects.size(); ++i)
+    {
+      ainstein_radar_msgs::RadarTarget t;
+      t.target_id = i;
+      t.range = tracked_objects.at(i).range;
+      t.speed = tracked_objects.at(i).speed;
+      t.azimuth = tracked_objects.at(i).azimuth;
+      t.elevation = tracked_objects.at(i).elevation;
+
+      msg_tracked_targets_.targets.push_back(t);
+    }
+
+    pub_radar_data_tracked_.publish(msg_tracked_targets_);
+
+    // Get targets associated with alive filters and publish bounding boxes:
+    msg_tracked_boxes_.boxes.clear();
+    msg_tracked_boxes_.header.stamp = stamp;
+
+    std::vector<std::vector<ainstein_radar_core::RadarTarget>> tracked_object_targets;
+    tracking_filter_.getTrackedObjectTargets(tracked_object_targets);
+
+    for (const auto& targets : tracked_object_targets)
+    {
+      ainstein_radar_msgs::RadarTargetArray msg_targets;
+      msg_targets.header.frame_id = msg_tracked_boxes_.header.frame_id;  // need to pass this through
+      for (const auto& t : targets)
+      {
+        ainstein_radar_msgs::RadarTarget target;
+        target.range = t.range;
+        target.speed = t.speed;
+        target.azimuth = t.azimuth;
+        target.elevation = t.elevation;
+        msg_targets.targets.push_back(target);
+      }
+
+      ainstein_radar_msgs::BoundingBox box;
+      ainstein_radar_filters::utilities::getTargetsBoundingBox(msg_targets, box);
+
+      msg_tracked_boxes_.boxes.push_back(box);
+    }
+
+    pub_bounding_boxes_.publish(msg_tracked_boxes_);
+  }
+
   void radarTargetArrayCallback(const ainstein_radar_msgs::RadarTargetArray& msg)
   {
     // Store the frame_id for the messages:
     msg_tracked_targets_.header.frame_id = msg.header.frame_id;
     msg_tracked_boxes_.header.frame_id = msg.header.frame_id;
 
-    std::vector<ainstein_radar_filters::RadarTarget> targets;
+    std::vector<ainstein_radar_core::RadarTarget> targets;
     for (const auto& t : msg.targets)
     {
-      targets.emplace_back(t.range, t.speed, t.azimuth, t.elevation);
+      targets.emplace_back(t.target_id, t.range, t.speed, t.azimuth, t.elevation, t.snr);
     }
 
-    tracking_filter_.updateFilters(targets);
+    if (event_driven_)
+    {
+      // Fall back on the receive time for unstamped messages:
+      ros::Time stamp = msg.header.stamp.isZero() ? ros::Time::now() : msg.header.stamp;
+      tracking_filter_.updateFilters(targets, stamp.toSec());
+      publishTrackedObjects(stamp);
+    }
+    else
+    {
+      tracking_filter_.updateFilters(targets);
+    }
   }
 
   void pointCloudCallback(const sensor_msgs::PointCloud2& cloud)
@@ -202,9 +222,10 @@ private:
   ros::Publisher pub_bounding_boxes_;
   dynamic_reconfigure::Server<ainstein_radar_filters::TrackingFilterConfig> dyn_config_server_;
 
-  ainstein_radar_filters::TrackingFilter tracking_filter_;
+  ainstein_radar_core::TrackingFilter tracking_filter_;
   std::unique_ptr<std::thread> publish_thread_;
   double publish_freq_;
+  bool event_driven_;
 
   ainstein_radar_msgs::RadarTargetArray msg_tracked_targets_;
   std::vector<ainstein_radar_msgs::RadarTargetArray> msg_tracked_clusters_;
@@ -227,7 +248,8 @@ int main(int argc, char** argv)
 
   // Create node to publish tracked targets:
   double publish_freq = node_handle_private.param("publish_freq", 20.0);
-  TrackingFilterROS tracking_filter_ros(node_handle, node_handle_private, publish_freq);
+  bool event_driven = node_handle_private.param("event_driven", false);
+  TrackingFilterROS tracking_filter_ros(node_handle, node_handle_private, publish_freq, event_driven);
 
   tracking_filter_ros.initialize();
 